@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Small helpers shared by the true-recall-bench suites
+
+typedef std::chrono::steady_clock BenchClock;
+
+inline double BenchElapsedNs(BenchClock::time_point start, BenchClock::time_point end) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Nearest-rank percentile; sorts the samples in place
+inline double BenchPercentile(std::vector<double>& samples, double percentile) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(percentile / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+    return samples[std::min(rank, samples.size() - 1)];
+}
+
+// Keep the optimizer from discarding benchmarked work
+template <typename T>
+inline void BenchDoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+// Heap allocations (operator new calls) made so far by any thread
+uint64_t BenchGetAllocCount();
+
+// Heap allocations not yet freed, and the process's resident set (0 where unknown)
+uint64_t BenchGetLiveAllocCount();
+uint64_t BenchGetResidentBytes();
+
+// Machine-readable results, written as JSON by `--json <file>`
+void BenchReport(const char* suite, const std::string& name, const char* metric, double value);
+
+// Suites (one per source file)
+void RunQueueBench();
+void RunLogBench();
+void RunGeometryBench();
+void RunEventLoopBench();
+void RunHistogramBench();
+void RunReplayBench();
+void RunStackBench();
+void RunRegistryBench();
+void RunDesktopBench();
+void RunSnapshotBench();
+void RunFocusStateBench();
+void RunCommandBench();
+void RunStrategyBench();
+void RunFlowBench();
+void RunSoakBench();
@@ -0,0 +1,116 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "Bench.h"
+#include "BenchSupport.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+// Counting replacements for the global allocation functions. Every suite
+// runs with them, so allocs/op can be measured around any operation.
+
+static std::atomic<uint64_t> g_allocCount(0);
+static std::atomic<uint64_t> g_freeCount(0);
+
+void* operator new(std::size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    if (p != nullptr) {
+        g_freeCount.fetch_add(1, std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { operator delete(p); }
+
+uint64_t BenchGetAllocCount() {
+    return g_allocCount.load(std::memory_order_relaxed);
+}
+
+uint64_t BenchGetLiveAllocCount() {
+    uint64_t freed = g_freeCount.load(std::memory_order_relaxed);
+    return g_allocCount.load(std::memory_order_relaxed) - freed;
+}
+
+uint64_t BenchGetResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.WorkingSetSize;
+#else
+    // Second field of statm: resident pages
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    int fields = std::fscanf(file, "%llu %llu", &size, &resident);
+    std::fclose(file);
+    return fields == 2 ? resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+#endif
+}
+
+static std::vector<BenchResult> g_results;
+
+void BenchReport(const char* suite, const std::string& name, const char* metric, double value) {
+    BenchResult result;
+    result.suite = suite;
+    result.name = name;
+    result.metric = metric;
+    result.value = value;
+    g_results.push_back(result);
+}
+
+const std::vector<BenchResult>& BenchGetResults() {
+    return g_results;
+}
+
+bool BenchWriteJson(const char* path) {
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    // Names and metrics are plain identifiers chosen by the suites; no escaping needed
+    std::fprintf(file, "{\n  \"results\": [\n");
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const BenchResult& result = g_results[i];
+        std::fprintf(file, "    { \"suite\": \"%s\", \"name\": \"%s\", \"metric\": \"%s\", \"value\": %.4f }%s\n",
+                     result.suite.c_str(), result.name.c_str(), result.metric.c_str(), result.value,
+                     i + 1 < g_results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+
+    return std::fclose(file) == 0;
+}
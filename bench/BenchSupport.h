@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Result collection behind BenchReport(), used by bench/main.cpp
+
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    std::string metric;
+    double value;
+};
+
+const std::vector<BenchResult>& BenchGetResults();
+bool BenchWriteJson(const char* path);
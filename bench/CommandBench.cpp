@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Bench.h"
+#include "CommandServer.h"
+#include "FocusState.h"
+
+// Local command endpoint: round trip of a single command and of a batch,
+// from a client in this process to a CommandServer whose batches run on an
+// EventLoop thread, as in the application. Uses the real LocalChannel
+// backend (a Unix domain socket on Linux) under a name of its own.
+
+static const int ROUND_TRIPS = 2000;
+static const int BATCH_SIZE = 8;
+
+// Sends request and reads up to the reply's terminating empty line
+static bool RoundTrip(LocalChannel* channel, const std::string& request, std::string* reply) {
+    if (!channel->Send(request.data(), request.size())) {
+        return false;
+    }
+
+    reply->clear();
+    char buffer[4096];
+    while (reply->size() < 2 || reply->compare(reply->size() - 2, 2, "\n\n") != 0) {
+        size_t received = 0;
+        if (!channel->Receive(buffer, sizeof(buffer), &received, 1000)) {
+            return false;
+        }
+        reply->append(buffer, received);
+    }
+    return true;
+}
+
+// p50/p99 of one request, in microseconds
+static bool MeasureRoundTrips(LocalChannel* channel, const std::string& request, const std::string& expected,
+                              const char* label) {
+    std::vector<double> samples;
+    samples.reserve(ROUND_TRIPS);
+    std::string reply;
+
+    for (int i = 0; i < ROUND_TRIPS; ++i) {
+        BenchClock::time_point start = BenchClock::now();
+        if (!RoundTrip(channel, request, &reply) || reply != expected) {
+            std::printf("%s: unexpected reply \"%s\"\n", label, reply.c_str());
+            return false;
+        }
+        samples.push_back(BenchElapsedNs(start, BenchClock::now()) / 1000.0);
+    }
+
+    double p50 = BenchPercentile(samples, 50.0);
+    double p99 = BenchPercentile(samples, 99.0);
+    std::printf("%s: p50=%.1f us p99=%.1f us\n", label, p50, p99);
+    BenchReport("command", label, "p50_us", p50);
+    BenchReport("command", label, "p99_us", p99);
+    return true;
+}
+
+void RunCommandBench() {
+    std::string name = GetLocalChannelName(std::string(COMMAND_ENDPOINT_BASE_NAME) + "-bench");
+
+    // Stand-in for the application's handler: cycles over 4 monitors
+    int currentMonitor = 0;
+    FocusState state = {};
+    state.monitorCount = 4;
+    for (uint32_t monitor = 0; monitor < state.monitorCount; ++monitor) {
+        state.monitors[monitor].depth = 10;
+        for (int i = 0; i < 10; ++i) {
+            state.monitors[monitor].windows[i] = 0x10000 + monitor * 0x100 + static_cast<uint64_t>(i);
+        }
+    }
+
+    EventLoop loop;
+    CommandServer server(&loop);
+    bool started = server.Start(name, [&](const Command& command, CommandReply* reply) {
+        switch (command.type) {
+            case CommandType::Cycle:
+                currentMonitor = (currentMonitor + 1) % 4;
+                reply->summary = "monitor " + std::to_string(currentMonitor);
+                break;
+            case CommandType::SelectMonitor:
+                currentMonitor = command.monitorIndex;
+                reply->summary = "monitor " + std::to_string(currentMonitor);
+                break;
+            case CommandType::QueryStacks:
+                state.currentMonitor = currentMonitor;
+                reply->details = FormatFocusState(state);
+                break;
+            default:
+                break;
+        }
+    });
+    if (!started) {
+        std::printf("cannot listen on %s\n", name.c_str());
+        std::printf("checks: FAILED\n");
+        BenchReport("command", "checks", "ok", 0.0);
+        return;
+    }
+    std::thread runner([&loop]() { loop.Run(); });
+
+    LocalChannel channel;
+    bool ok = channel.Connect(name, 1000);
+
+    // One command per round trip, then a batch of BATCH_SIZE in one
+    std::string batch;
+    std::string batchReply;
+    for (int i = 0; i < BATCH_SIZE; ++i) {
+        batch += "monitor " + std::to_string(i % 4) + "\n";
+        batchReply += "ok monitor " + std::to_string(i % 4) + "\n";
+    }
+    ok = ok && MeasureRoundTrips(&channel, "ping\n\n", "ok\n\n", "ping");
+    ok = ok && MeasureRoundTrips(&channel, batch + "\n", batchReply + "\n", "batch8");
+
+    // Connecting per command, as a launcher spawning the CLI would. Clients
+    // are served one at a time, so the persistent one has to go first.
+    channel.Close();
+    std::vector<double> samples;
+    std::string reply;
+    for (int i = 0; ok && i < ROUND_TRIPS / 4; ++i) {
+        BenchClock::time_point start = BenchClock::now();
+        LocalChannel once;
+        ok = once.Connect(name, 1000) && RoundTrip(&once, "ping\n\n", &reply) && reply == "ok\n\n";
+        if (!ok) {
+            std::printf("connect+ping: unexpected reply \"%s\"\n", reply.c_str());
+        }
+        samples.push_back(BenchElapsedNs(start, BenchClock::now()) / 1000.0);
+    }
+    if (ok) {
+        double p50 = BenchPercentile(samples, 50.0);
+        std::printf("connect+ping: p50=%.1f us\n", p50);
+        BenchReport("command", "connect_ping", "p50_us", p50);
+    }
+
+    ok = ok && channel.Connect(name, 1000);
+
+    // Protocol: errors stay in place, stacks come indented, oversize is refused
+    const std::string expected = "ok monitor 0\nerr monitor needs a monitor number\nerr unknown command: bogus\n"
+                                 "ok\n  current monitor: 0\n  Monitor 0: 0x10000 0x10001";
+    ok = ok && RoundTrip(&channel, "cycle\nmonitor\nbogus\nstacks\n\n", &reply) &&
+         reply.compare(0, expected.size(), expected) == 0;
+    ok = ok && RoundTrip(&channel, std::string(COMMAND_MAX_BATCH_BYTES + 100, 'x') + "\n\n", &reply) &&
+         reply == "err request too large\n\n";
+
+    // Stop must not hang on a connected, idle client
+    LocalChannel idle;
+    bool idleConnected = idle.Connect(name, 1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    BenchClock::time_point stopStart = BenchClock::now();
+    server.Stop();
+    double stopMs = BenchElapsedNs(stopStart, BenchClock::now()) / 1e6;
+    loop.RequestStop();
+    runner.join();
+
+    ok = ok && idleConnected && stopMs < 100.0;
+    std::printf("protocol and shutdown (%.1f ms): %s\n", stopMs, ok ? "ok" : "FAILED");
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("command", "checks", "ok", ok ? 1.0 : 0.0);
+}
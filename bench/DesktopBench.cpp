@@ -0,0 +1,263 @@
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "Bench.h"
+#include "DesktopFocusStacks.h"
+#include "MonitorManager.h"
+#include "SimulatedWindowSystem.h"
+
+// Focus stacks per virtual desktop: a MonitorManager over a fake DesktopProvider.
+// New windows are queried on focus, focus on another desktop or a burst of
+// cloak events re-queries everything. Checks that per-monitor lookups only
+// ever see windows of the current desktop, that without virtual desktops the
+// stacks match a plain FocusStackEngine, and how many provider calls and
+// nanoseconds this costs.
+
+static const int MAX_DESKTOPS = 8;  // MonitorManager::MAX_DESKTOPS
+static const int MONITORS = 3;
+static const size_t STACK_SIZE = MonitorManager::GetMaxStackSize();
+static const int DESKTOPS = 4;
+static const uint32_t KEY_POOL = 256;
+static const int CHURN_STEPS = 200000;
+static const int LOOKUPS = 1000000;
+
+static WindowKey MakeKey(uint32_t n) {
+    return 0x10000 + static_cast<WindowKey>(n) * 16;
+}
+
+// The system as the shell would report it
+class FakeDesktopProvider : public DesktopProvider {
+public:
+    DesktopId current = 1;
+    std::unordered_map<WindowKey, DesktopId> windows;  // 0 = pinned to all desktops
+    uint64_t queries = 0;
+
+    DesktopId GetCurrentDesktop() override {
+        ++queries;
+        return current;
+    }
+
+    DesktopId GetWindowDesktop(WindowKey window, DesktopId) override {
+        ++queries;
+        std::unordered_map<WindowKey, DesktopId>::const_iterator it = windows.find(window);
+        return it != windows.end() ? it->second : 0;
+    }
+};
+
+// A MonitorManager over the fake provider; windows are placed by the caller, so
+// the window system only supplies the monitors
+struct DesktopWorld {
+    SimulatedWindowSystem system;
+    FakeDesktopProvider provider;
+    MonitorManager monitors;
+
+    DesktopWorld() : monitors(&system, &system, &provider) {
+        for (int i = 0; i < MONITORS; ++i) {
+            MonitorRect bounds = { i * 1920, 0, (i + 1) * 1920, 1080 };
+            system.AddMonitor(bounds, i == 0);
+        }
+        monitors.EnumerateMonitors();
+    }
+};
+
+// Windows a lookup on the current desktop sees that the user cannot: other desktop or gone
+static uint64_t CountOffDesktop(const MonitorManager& monitors, const FakeDesktopProvider& provider) {
+    uint64_t wrong = 0;
+    std::vector<WindowKey> stack;
+    for (int monitorIndex = 0; monitorIndex < MONITORS; ++monitorIndex) {
+        monitors.CopyFocusStack(monitorIndex, &stack);
+        for (WindowKey window : stack) {
+            std::unordered_map<WindowKey, DesktopId>::const_iterator it = provider.windows.find(window);
+            wrong += it == provider.windows.end() || (it->second != 0 && it->second != provider.current);
+        }
+    }
+    return wrong;
+}
+
+// Random focus, create, destroy, desktop switches and windows moved between desktops
+static uint64_t RunChurn(uint64_t* steadyQueries) {
+    std::mt19937 rng(23);
+    DesktopWorld world;
+    FakeDesktopProvider& provider = world.provider;
+    MonitorManager& monitors = world.monitors;
+    std::vector<int> monitorOf(KEY_POOL);
+    for (uint32_t n = 0; n < KEY_POOL; ++n) {
+        monitorOf[n] = static_cast<int>(rng() % MONITORS);
+    }
+
+    uint64_t wrong = 0;
+    *steadyQueries = 0;
+    for (int step = 0; step < CHURN_STEPS; ++step) {
+        uint32_t n = rng() % KEY_POOL;
+        WindowKey key = MakeKey(n);
+        bool alive = provider.windows.count(key) != 0;
+        uint32_t op = rng() % 100;
+
+        if (op < 60) {
+            // Focus: only windows on the current desktop (or pinned) can get it; new ones open there
+            if (!alive) {
+                provider.windows[key] = (rng() % 50 == 0) ? 0 : provider.current;
+            } else if (provider.windows[key] != 0 && provider.windows[key] != provider.current) {
+                continue;
+            }
+            uint64_t before = provider.queries;
+            bool known = monitors.IsWindowTracked(key);
+            monitors.OnWindowFocused(key, monitorOf[n]);
+            if (known) {
+                *steadyQueries += provider.queries - before;
+            }
+            wrong += monitors.GetLastFocusedWindow(monitorOf[n]) != key;
+        } else if (op < 80) {
+            if (alive) {
+                provider.windows.erase(key);
+                monitors.RemoveWindowFromAllStacks(key);
+            }
+        } else if (op < 90) {
+            // Switch; the cloak burst triggers a refresh, or a focus on the new desktop catches it first
+            provider.current = 1 + rng() % DESKTOPS;
+            if ((rng() & 1) != 0) {
+                monitors.RefreshDesktops();
+            } else {
+                bool focused = false;
+                for (uint32_t i = 0; i < KEY_POOL && !focused; ++i) {
+                    std::unordered_map<WindowKey, DesktopId>::const_iterator it = provider.windows.find(MakeKey(i));
+                    if (it != provider.windows.end() && it->second == provider.current) {
+                        monitors.OnWindowFocused(MakeKey(i), monitorOf[i]);
+                        focused = true;
+                    }
+                }
+                if (!focused) {
+                    monitors.RefreshDesktops();  // Empty desktop: only cloak events say so
+                }
+            }
+        } else if (alive) {
+            // Moved to another desktop in Task View: it (un)cloaks, which triggers a refresh
+            provider.windows[key] = 1 + rng() % DESKTOPS;
+            monitors.RefreshDesktops();
+        }
+
+        wrong += CountOffDesktop(monitors, provider);
+    }
+    return wrong;
+}
+
+// Without virtual desktops every answer is 0; must behave exactly like the plain engine
+static uint64_t RunSingleDesktop() {
+    std::mt19937 rng(5);
+    DesktopWorld world;
+    world.provider.current = 0;
+    MonitorManager& monitors = world.monitors;
+    FocusStackEngine engine(MONITORS, STACK_SIZE);
+
+    uint64_t mismatches = 0;
+    std::vector<WindowKey> expected;
+    std::vector<WindowKey> actual;
+    for (int step = 0; step < CHURN_STEPS; ++step) {
+        WindowKey key = MakeKey(rng() % KEY_POOL);
+        int monitorIndex = static_cast<int>(rng() % MONITORS);
+        uint32_t op = rng() % 10;
+
+        if (op < 6) {
+            monitors.OnWindowFocused(key, monitorIndex);
+            engine.Promote(key, monitorIndex);
+        } else if (op < 8) {
+            bool tracked = monitors.IsWindowTracked(key);
+            monitors.RemoveWindowFromAllStacks(key);
+            mismatches += tracked != (engine.Remove(key) >= 0);
+        } else {
+            bool toFront = (rng() & 1) != 0;
+            mismatches += monitors.MoveWindowToMonitor(key, monitorIndex, toFront) !=
+                          engine.MoveToMonitor(key, monitorIndex, toFront);
+        }
+
+        for (int m = 0; m < MONITORS; ++m) {
+            expected.clear();
+            engine.ForEachInStack(m, [&expected](WindowKey window) { expected.push_back(window); });
+            monitors.CopyFocusStack(m, &actual);
+            mismatches += expected != actual;
+        }
+    }
+    return mismatches;
+}
+
+void RunDesktopBench() {
+    bool ok = true;
+
+    uint64_t steadyQueries = 0;
+    uint64_t offDesktop = RunChurn(&steadyQueries);
+    std::printf("churn: %d steps over %d desktops, %llu off-desktop window(s) seen, %llu provider call(s) for "
+                "known windows without a switch\n", CHURN_STEPS, DESKTOPS, static_cast<unsigned long long>(offDesktop),
+                static_cast<unsigned long long>(steadyQueries));
+    BenchReport("desktops", "churn", "off_desktop", static_cast<double>(offDesktop));
+    ok = ok && offDesktop == 0;
+
+    uint64_t singleMismatches = RunSingleDesktop();
+    std::printf("single desktop vs plain engine: %llu mismatches\n", static_cast<unsigned long long>(singleMismatches));
+    BenchReport("desktops", "single_desktop", "mismatches", static_cast<double>(singleMismatches));
+    ok = ok && singleMismatches == 0;
+
+    // More desktops than rows: the one current longest ago gives way, with its windows
+    DesktopWorld world;
+    FakeDesktopProvider& provider = world.provider;
+    MonitorManager& monitors = world.monitors;
+    const DesktopId lastDesktop = MAX_DESKTOPS + 1;
+    for (DesktopId desktop = 1; desktop <= lastDesktop; ++desktop) {
+        provider.current = desktop;
+        provider.windows[MakeKey(static_cast<uint32_t>(desktop))] = desktop;
+        monitors.OnWindowFocused(MakeKey(static_cast<uint32_t>(desktop)), 0);
+    }
+    bool evictOk = monitors.GetDesktopCount() == static_cast<size_t>(MAX_DESKTOPS) && !monitors.IsWindowTracked(MakeKey(1)) &&
+                   monitors.GetLastFocusedWindow(0) == MakeKey(static_cast<uint32_t>(lastDesktop));
+    provider.current = 2;
+    monitors.RefreshDesktops();
+    evictOk = evictOk && monitors.GetLastFocusedWindow(0) == MakeKey(2) && monitors.GetTrackedCount() == static_cast<size_t>(MAX_DESKTOPS);
+
+    // An empty desktop has empty stacks
+    provider.current = lastDesktop + 1;
+    monitors.RefreshDesktops();
+    std::vector<WindowKey> stack;
+    monitors.CopyFocusStack(0, &stack);
+    evictOk = evictOk && monitors.GetLastFocusedWindow(0) == 0 && stack.empty();
+    std::printf("eviction and empty desktop: %s\n", evictOk ? "ok" : "FAILED");
+    ok = ok && evictOk;
+
+    // Lookup cost with every desktop's stacks full, against the plain engine
+    DesktopFocusStacks full(MAX_DESKTOPS, MONITORS, STACK_SIZE);
+    FocusStackEngine engine(MONITORS, STACK_SIZE);
+    for (int d = 0; d < MAX_DESKTOPS; ++d) {
+        for (int m = 0; m < MONITORS; ++m) {
+            for (size_t i = 0; i < STACK_SIZE; ++i) {
+                uint32_t n = static_cast<uint32_t>((d * MONITORS + m) * STACK_SIZE + i);
+                full.Append(MakeKey(n), m, static_cast<DesktopId>(d + 1));
+                if (d == 0) {
+                    engine.Append(MakeKey(n), m);
+                }
+            }
+        }
+    }
+    full.SetCurrentDesktop(3);
+
+    WindowKey sum = 0;
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < LOOKUPS; ++i) {
+        full.ForEachInStack(i % MONITORS, [&sum](WindowKey window) { sum += window; });
+    }
+    double desktopNs = BenchElapsedNs(start, BenchClock::now()) / LOOKUPS;
+
+    start = BenchClock::now();
+    for (int i = 0; i < LOOKUPS; ++i) {
+        engine.ForEachInStack(i % MONITORS, [&sum](WindowKey window) { sum += window; });
+    }
+    double engineNs = BenchElapsedNs(start, BenchClock::now()) / LOOKUPS;
+    BenchDoNotOptimize(sum);
+
+    std::printf("stack walk (%zu windows): %.1f ns with %d desktops tracked, %.1f ns plain engine\n", STACK_SIZE,
+                desktopNs, MAX_DESKTOPS, engineNs);
+    BenchReport("desktops", "stack_walk", "ns_per_op", desktopNs);
+    BenchReport("desktops", "stack_walk_engine", "ns_per_op", engineNs);
+
+    ok = ok && steadyQueries == 0;
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("desktops", "checks", "ok", ok ? 1.0 : 0.0);
+}
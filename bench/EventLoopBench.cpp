@@ -0,0 +1,85 @@
+#include <atomic>
+#include <thread>
+#include "Bench.h"
+#include "EventLoop.h"
+
+// Idle wakeups, cross-thread wake latency and timer lateness of EventLoop
+
+static void RunIdle(int seconds) {
+    EventLoop loop;
+    std::thread runner([&loop]() { loop.Run(); });
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    uint64_t wakeups = loop.GetWakeupCount();
+
+    loop.RequestStop();
+    runner.join();
+
+    std::printf("idle: %llu wakeups in %d s (%.2f/s)\n",
+                static_cast<unsigned long long>(wakeups), seconds,
+                static_cast<double>(wakeups) / seconds);
+}
+
+static void RunWakeLatency(int samples) {
+    EventLoop loop;
+    std::atomic<int64_t> notifiedAt(0);
+    std::atomic<int> handled(0);
+    std::vector<double> latencies;
+    latencies.reserve(samples);
+
+    EventLoop::SignalId signal = loop.AddSignal([&]() {
+        int64_t now = BenchClock::now().time_since_epoch().count();
+        latencies.push_back(static_cast<double>(now - notifiedAt.load()));
+        handled.fetch_add(1);
+    });
+
+    std::thread runner([&loop]() { loop.Run(); });
+
+    for (int i = 0; i < samples; ++i) {
+        // Let the loop go back to sleep so every sample includes a real wakeup
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        notifiedAt.store(BenchClock::now().time_since_epoch().count());
+        loop.Notify(signal);
+        while (handled.load() <= i) {
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t wakeups = loop.GetWakeupCount();
+    loop.RequestStop();
+    runner.join();
+
+    // steady_clock ticks are nanoseconds on every platform we build for
+    std::printf("signal wake latency: p50=%.1f us p99=%.1f us max=%.1f us (%llu wakeups for %d signals)\n",
+                BenchPercentile(latencies, 50.0) / 1000.0, BenchPercentile(latencies, 99.0) / 1000.0,
+                BenchPercentile(latencies, 100.0) / 1000.0,
+                static_cast<unsigned long long>(wakeups), samples);
+}
+
+static void RunTimerLateness(int samples, int periodMs) {
+    EventLoop loop;
+    std::vector<double> lateness;
+    lateness.reserve(samples);
+
+    BenchClock::time_point expected = BenchClock::now() + std::chrono::milliseconds(periodMs);
+    loop.AddTimer(std::chrono::milliseconds(periodMs), true, [&]() {
+        BenchClock::time_point now = BenchClock::now();
+        lateness.push_back(BenchElapsedNs(expected, now));
+        expected = now + std::chrono::milliseconds(periodMs);
+        if (static_cast<int>(lateness.size()) >= samples) {
+            loop.RequestStop();
+        }
+    });
+
+    loop.Run();
+
+    std::printf("timer (%d ms): lateness p50=%.1f us p99=%.1f us, %llu wakeups for %d ticks\n",
+                periodMs, BenchPercentile(lateness, 50.0) / 1000.0, BenchPercentile(lateness, 99.0) / 1000.0,
+                static_cast<unsigned long long>(loop.GetWakeupCount()), samples);
+}
+
+void RunEventLoopBench() {
+    RunIdle(2);
+    RunWakeLatency(2000);
+    RunTimerLateness(100, 10);
+}
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "Bench.h"
+#include "Hash.h"
+#include "SimulatedFlow.h"
+
+// The hotkey -> activation flow end to end, headless: ActivationSequencer
+// against a SimulatedWindowSystem. Scenarios for each path through the
+// sequencer (escalation, learning, hung, destroyed and minimized targets,
+// the fallback search, superseded presses), then random desktop churn
+// checked against an oracle, run twice for determinism. Latencies are
+// virtual time; only the per-press cost is wall clock.
+
+static const int CHURN_OPERATIONS = 50000;
+static const size_t CHURN_MAX_WINDOWS = 40;
+static const uint32_t CHURN_SEED = 0x7f4a7c15;
+static const double FAST_PRESS_MS = 10.0;  // A working first strategy plus its event
+
+static SimWindowSpec MakeSpec(SimFocusPolicy policy) {
+    SimWindowSpec spec;
+    spec.focusPolicy = policy;
+    return spec;
+}
+
+// Opened on the monitor and clicked
+static WindowKey OpenFocused(SimulatedFlow* flow, int monitorIndex, SimFocusPolicy policy) {
+    WindowKey window = flow->OpenWindow(monitorIndex, MakeSpec(policy));
+    flow->Click(window);
+    return window;
+}
+
+// Still on the monitor's stack, whatever its state
+static bool IsStacked(const SimulatedFlow& flow, int monitorIndex, WindowKey window) {
+    std::vector<WindowKey> stack;
+    flow.GetMonitors().CopyFocusStack(monitorIndex, &stack);
+    return std::find(stack.begin(), stack.end(), window) != stack.end();
+}
+
+static bool CheckPress(const char* name, const FlowPress& press, WindowKey expected, bool fast) {
+    bool ok = press.foreground == expected && (press.latencyMs < FAST_PRESS_MS) == fast;
+    std::printf("%-22s %7.1f ms  %s\n", name, press.latencyMs, ok ? "ok" : "FAILED");
+    BenchReport("flow", name, "ms", press.latencyMs);
+    return ok;
+}
+
+static bool RunScenarios() {
+    bool ok = true;
+
+    {
+        SimulatedFlow flow(2);
+        WindowKey target = OpenFocused(&flow, 0, SimFocusPolicy::Accept);
+        OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        ok = CheckPress("direct", flow.Press(0), target, true) && ok;
+    }
+
+    {
+        // Direct and AttachThreadInput each wait out a deadline, once
+        SimulatedFlow flow(2);
+        WindowKey target = OpenFocused(&flow, 0, SimFocusPolicy::NeedsBringToTop);
+        WindowKey away = OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        ok = CheckPress("bring-to-top/first", flow.Press(0), target, false) && ok;
+        FlowPress learned = {};
+        for (int press = 0; press < 5; ++press) {
+            flow.Click(away);
+            learned = flow.Press(0);
+        }
+        ok = CheckPress("bring-to-top/learned", learned, target, true) && ok;
+        ok = ok && flow.GetEventCount(ActivationEvent::LearnedOrder) > 0;
+    }
+
+    {
+        SimulatedFlow flow(2);
+        WindowKey target = OpenFocused(&flow, 0, SimFocusPolicy::NeedsAttach);
+        OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        ok = CheckPress("needs-attach", flow.Press(0), target, true) && ok;
+    }
+
+    {
+        // The hung ready target keeps its place; the cache skips it until it recovers
+        SimulatedFlow flow(2);
+        WindowKey next = OpenFocused(&flow, 0, SimFocusPolicy::Accept);
+        WindowKey hung = OpenFocused(&flow, 0, SimFocusPolicy::Accept);
+        WindowKey away = OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        flow.SetHung(hung, true);
+        ok = CheckPress("hung/first", flow.Press(0), next, false) && ok;
+        ok = ok && flow.GetEventCount(ActivationEvent::StoppedResponding) == 1 &&
+             IsStacked(flow, 0, hung);
+
+        flow.SetHung(hung, false);
+        flow.Click(hung);
+        flow.Click(away);
+        ok = CheckPress("hung/recovered", flow.Press(0), hung, true) && ok;
+    }
+
+    {
+        // Gone without a destroy event: found out by the failed activation
+        SimulatedFlow flow(2);
+        WindowKey next = OpenFocused(&flow, 0, SimFocusPolicy::Accept);
+        WindowKey gone = OpenFocused(&flow, 0, SimFocusPolicy::Accept);
+        OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        flow.GetSystem().DestroyWindow(gone);
+        ok = CheckPress("destroyed", flow.Press(0), next, true) && ok;
+        ok = ok && flow.GetEventCount(ActivationEvent::TargetGone) == 1 && !flow.GetMonitors().IsWindowTracked(gone);
+    }
+
+    {
+        SimulatedFlow flow(2);
+        WindowKey next = OpenFocused(&flow, 0, SimFocusPolicy::Accept);
+        WindowKey minimized = OpenFocused(&flow, 0, SimFocusPolicy::Accept);
+        OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        flow.SetWindowState(minimized, WINDOW_STATE_VISIBLE | WINDOW_STATE_MINIMIZED);
+        ok = CheckPress("minimized", flow.Press(0), next, true) && ok;
+        ok = ok && IsStacked(flow, 0, minimized);
+    }
+
+    {
+        // Nothing tracked on the monitor: any visible window there
+        SimulatedFlow flow(2);
+        WindowKey untracked = flow.OpenWindow(0, SimWindowSpec());
+        OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        ok = CheckPress("fallback", flow.Press(0), untracked, true) && ok;
+        ok = ok && flow.GetFallbackSearches() == 1;
+    }
+
+    {
+        // A second press while the first waits out a deadline
+        SimulatedFlow flow(3);
+        OpenFocused(&flow, 0, SimFocusPolicy::NeedsBringToTop);
+        WindowKey target = OpenFocused(&flow, 1, SimFocusPolicy::Accept);
+        OpenFocused(&flow, 2, SimFocusPolicy::Accept);
+        flow.StartPress(0);
+        flow.GetSystem().Advance(std::chrono::milliseconds(50));
+        ok = CheckPress("superseded", flow.Press(1), target, true) && ok;
+        ok = ok && flow.GetEventCount(ActivationEvent::Superseded) == 1;
+    }
+
+    return ok;
+}
+
+// The window a press on `monitorIndex` must end on, per the sequencer's rules:
+// the ready target (first window cached as activatable), else the first
+// usable one among the next MAX_CANDIDATES. 0: the fallback search runs.
+static WindowKey ExpectTarget(SimulatedFlow* flow, int monitorIndex) {
+    SimulatedWindowSystem& system = flow->GetSystem();
+    const MonitorManager& monitors = flow->GetMonitors();
+
+    std::vector<WindowKey> stack;
+    std::vector<WindowHandle> handles;
+    monitors.CopyFocusStack(monitorIndex, &stack, &handles);
+
+    WindowKey ready = 0;
+    for (size_t i = 0; i < stack.size(); ++i) {
+        if (IsWindowStateActivatable(monitors.GetWindowState(handles[i]))) {
+            ready = stack[i];
+            break;
+        }
+    }
+    const SimWindowSpec* readySpec = system.GetSpec(ready);
+    if (readySpec != nullptr && !readySpec->hung) {
+        return ready;
+    }
+
+    size_t tried = 0;
+    for (size_t i = 0; i < stack.size(); ++i) {
+        if (stack[i] == ready) {
+            continue;
+        }
+        if (tried++ >= ActivationSequencer::MAX_CANDIDATES) {
+            break;
+        }
+        const SimWindowSpec* spec = system.GetSpec(stack[i]);
+        if (IsWindowStateActivatable(monitors.GetWindowState(handles[i])) && spec != nullptr && !spec->hung) {
+            return stack[i];
+        }
+    }
+    return 0;
+}
+
+struct ChurnResult {
+    uint64_t digest;
+    int presses;
+    int wrongTargets;
+    int fallbacks;
+    uint64_t calls;
+    double wallNs;
+    double p50Ms;
+    double p99Ms;
+};
+
+static ChurnResult RunChurn(uint32_t seed) {
+    SimulatedFlow flow(2);
+    SimulatedWindowSystem& system = flow.GetSystem();
+    std::mt19937 rng(seed);
+    std::vector<WindowKey> windows;
+
+    ChurnResult result = {};
+    result.digest = HashFnv64(nullptr, 0);
+    double pressNs = 0.0;
+
+    for (int op = 0; op < CHURN_OPERATIONS; ++op) {
+        uint32_t roll = rng() % 100;
+        WindowKey window = windows.empty() ? 0 : windows[rng() % windows.size()];
+        const SimWindowSpec* spec = window != 0 ? system.GetSpec(window) : nullptr;
+        WindowKey foreground = system.GetForeground();
+
+        if (roll < 15 || windows.empty()) {
+            if (windows.size() < CHURN_MAX_WINDOWS) {
+                uint32_t kind = rng() % 10;
+                SimFocusPolicy policy = kind < 7 ? SimFocusPolicy::Accept
+                                      : kind < 9 ? SimFocusPolicy::NeedsAttach
+                                                 : SimFocusPolicy::NeedsBringToTop;
+                WindowKey opened = flow.OpenWindow(static_cast<int>(rng() % 2), MakeSpec(policy));
+                windows.push_back(opened);
+                if (rng() % 2 == 0) {
+                    flow.Click(opened);
+                }
+            }
+        } else if (roll < 25) {
+            flow.CloseWindow(window);
+            windows.erase(std::find(windows.begin(), windows.end(), window));
+        } else if (roll < 27) {
+            // Gone without an event: still in the stacks until a press finds out
+            system.DestroyWindow(window);
+            windows.erase(std::find(windows.begin(), windows.end(), window));
+        } else if (roll < 45) {
+            if (spec != nullptr && !spec->hung && IsWindowStateActivatable(spec->state)) {
+                flow.Click(window);
+            }
+        } else if (roll < 55) {
+            bool minimized = (spec->state & WINDOW_STATE_MINIMIZED) != 0;
+            flow.SetWindowState(window, minimized ? WINDOW_STATE_VISIBLE : WINDOW_STATE_VISIBLE | WINDOW_STATE_MINIMIZED);
+        } else if (roll < 60) {
+            if (spec->hung || window != foreground) {
+                flow.SetHung(window, !spec->hung);
+            }
+        } else if (roll < 65) {
+            flow.MoveWindow(window, static_cast<int>(rng() % 2));
+        } else {
+            int monitorIndex = static_cast<int>(rng() % 2);
+            WindowKey expected = ExpectTarget(&flow, monitorIndex);
+            uint64_t searches = flow.GetFallbackSearches();
+
+            BenchClock::time_point start = BenchClock::now();
+            FlowPress press = flow.Press(monitorIndex);
+            pressNs += BenchElapsedNs(start, BenchClock::now());
+
+            ++result.presses;
+            if (expected == 0) {
+                ++result.fallbacks;
+                result.wrongTargets += flow.GetFallbackSearches() == searches + 1 ? 0 : 1;
+            } else if (press.foreground != expected) {
+                ++result.wrongTargets;
+            }
+            result.digest = HashFnv64(&press.foreground, sizeof(press.foreground), result.digest);
+            result.digest = HashFnv64(&press.latencyMs, sizeof(press.latencyMs), result.digest);
+        }
+    }
+
+    result.calls = system.GetCallCount();
+    result.wallNs = result.presses > 0 ? pressNs / result.presses : 0.0;
+    const LatencyHistogram& endToEnd = flow.GetStats().GetStage(ActivationStage::EndToEnd);
+    result.p50Ms = endToEnd.GetValueAtPercentile(50.0) / 1e6;
+    result.p99Ms = endToEnd.GetValueAtPercentile(99.0) / 1e6;
+    return result;
+}
+
+void RunFlowBench() {
+    bool ok = RunScenarios();
+
+    ChurnResult first = RunChurn(CHURN_SEED);
+    ChurnResult second = RunChurn(CHURN_SEED);
+    bool deterministic = first.digest == second.digest && first.calls == second.calls;
+
+    std::printf("churn: %d presses (%d fallback), %d wrong targets, end-to-end p50 %.1f ms p99 %.1f ms\n",
+                first.presses, first.fallbacks, first.wrongTargets, first.p50Ms, first.p99Ms);
+    std::printf("churn: %.1f us/press wall, %llu window-system calls\n", first.wallNs / 1000.0,
+                static_cast<unsigned long long>(first.calls));
+    std::printf("deterministic: %s (digest %016llx)\n", deterministic ? "yes" : "NO",
+                static_cast<unsigned long long>(first.digest));
+    BenchReport("flow", "churn", "wrong_targets", first.wrongTargets);
+    BenchReport("flow", "churn/end_to_end", "p50_ms", first.p50Ms);
+    BenchReport("flow", "churn/end_to_end", "p99_ms", first.p99Ms);
+    BenchReport("flow", "churn", "ns_per_press", first.wallNs);
+
+    ok = ok && deterministic && first.wrongTargets == 0;
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("flow", "checks", "ok", ok ? 1.0 : 0.0);
+}
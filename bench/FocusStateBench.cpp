@@ -0,0 +1,124 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "Bench.h"
+#include "FocusState.h"
+
+// Shared focus state: cost of one publish and one read, and a writer
+// hammering the region while a reader in another thread checks that every
+// copy it accepts is consistent. Uses the real shared memory backend (POSIX
+// shm on Linux), under a name of its own.
+
+static const int OPERATIONS = 200000;
+static const int CONTENDED_MS = 500;
+
+// Every window of every stack carries the same value, so a torn copy shows
+static void FillState(FocusState* state, uint64_t value, int monitorCount) {
+    state->currentMonitor = static_cast<int32_t>(value % static_cast<uint64_t>(monitorCount));
+    state->monitorCount = static_cast<uint32_t>(monitorCount);
+    for (int monitor = 0; monitor < monitorCount; ++monitor) {
+        FocusStateMonitor& entry = state->monitors[monitor];
+        entry.depth = 10;
+        for (int i = 0; i < FOCUS_STATE_MAX_STACK; ++i) {
+            entry.windows[i] = value;
+        }
+    }
+}
+
+static bool IsConsistent(const FocusState& state) {
+    uint64_t value = state.monitors[0].windows[0];
+    if (state.currentMonitor != static_cast<int32_t>(value % state.monitorCount)) {
+        return false;
+    }
+    for (uint32_t monitor = 0; monitor < state.monitorCount; ++monitor) {
+        for (int i = 0; i < FOCUS_STATE_MAX_STACK; ++i) {
+            if (state.monitors[monitor].windows[i] != value) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void RunFocusStateBench() {
+    std::string name = std::string(FOCUS_STATE_REGION_NAME) + "-bench";
+    const int monitorCount = 4;
+
+    FocusStatePublisher publisher;
+    if (!publisher.Create(name)) {
+        std::printf("cannot create shared memory %s\n", name.c_str());
+        return;
+    }
+
+    FocusStateReader reader;
+    FocusState copy;
+    bool opened = reader.Open(name);
+    bool emptyOk = opened && reader.Read(&copy) == FocusStateReadResult::NotPublished;
+
+    // Uncontended costs
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < OPERATIONS; ++i) {
+        FillState(publisher.BeginWrite(), static_cast<uint64_t>(i), monitorCount);
+        publisher.EndWrite();
+    }
+    double publishNs = BenchElapsedNs(start, BenchClock::now()) / OPERATIONS;
+
+    int readsOk = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < OPERATIONS; ++i) {
+        readsOk += reader.Read(&copy) == FocusStateReadResult::Ok;
+    }
+    double readNs = BenchElapsedNs(start, BenchClock::now()) / OPERATIONS;
+
+    std::printf("publish: %.0f ns, read: %.0f ns (%zu byte region, %d monitors)\n", publishNs, readNs,
+                sizeof(FocusStateRegion), monitorCount);
+    BenchReport("focusstate", "publish", "ns_per_op", publishNs);
+    BenchReport("focusstate", "read", "ns_per_op", readNs);
+
+    // Contended: the writer never waits; the reader retries around writes
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        uint64_t value = OPERATIONS;
+        while (!stop.load(std::memory_order_relaxed)) {
+            FillState(publisher.BeginWrite(), ++value, monitorCount);
+            publisher.EndWrite();
+        }
+    });
+
+    uint64_t accepted = 0;
+    uint64_t busy = 0;
+    uint64_t torn = 0;
+    BenchClock::time_point deadline = BenchClock::now() + std::chrono::milliseconds(CONTENDED_MS);
+    while (BenchClock::now() < deadline) {
+        FocusStateReadResult result = reader.Read(&copy);
+        if (result == FocusStateReadResult::Ok) {
+            ++accepted;
+            torn += IsConsistent(copy) ? 0 : 1;
+        } else {
+            ++busy;
+        }
+    }
+    stop.store(true);
+    writer.join();
+
+    uint64_t publishes = publisher.GetPublishCount();
+    std::printf("contended %d ms: %llu publishes, %llu reads accepted, %llu busy, %llu torn\n", CONTENDED_MS,
+                static_cast<unsigned long long>(publishes), static_cast<unsigned long long>(accepted),
+                static_cast<unsigned long long>(busy), static_cast<unsigned long long>(torn));
+    BenchReport("focusstate", "contended", "torn_reads", static_cast<double>(torn));
+    BenchReport("focusstate", "contended", "reads_accepted", static_cast<double>(accepted));
+
+    // A clean shutdown must tell readers to look for a new writer
+    publisher.Close();
+    bool goneOk = reader.Read(&copy) == FocusStateReadResult::WriterGone;
+    reader.Close();
+
+    bool lifecycleOk = emptyOk && goneOk && readsOk == OPERATIONS;
+    std::printf("lifecycle: %s\n", lifecycleOk ? "ok" : "FAILED");
+    BenchReport("focusstate", "lifecycle", "ok", lifecycleOk ? 1.0 : 0.0);
+
+    bool ok = torn == 0 && lifecycleOk;
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("focusstate", "checks", "ok", ok ? 1.0 : 0.0);
+}
@@ -0,0 +1,157 @@
+#include <random>
+#include "Bench.h"
+#include "MonitorLayout.h"
+
+// Point and rect -> monitor lookups: expected answers on a fixed mixed
+// layout (shared edges, straddling rects, off-screen fallback, no monitors),
+// then timing on grid layouts of 1 to 16 monitors
+
+static const int LOOKUPS = 1000000;
+
+struct PointCase {
+    const char* name;
+    int32_t x;
+    int32_t y;
+    int expected;
+};
+
+struct RectCase {
+    const char* name;
+    MonitorRect rect;
+    int expectedOverlap;  // FindLargestOverlap
+    int expected;         // FromRect
+};
+
+// Two landscape monitors side by side, a portrait one left of the primary
+static void BuildMixed(MonitorLayout& layout) {
+    const MonitorRect bounds[] = {
+        { 0, 0, 1920, 1080 },
+        { 1920, 0, 3840, 1080 },
+        { -1080, -400, 0, 1520 },
+    };
+    layout.Clear();
+    for (int i = 0; i < 3; ++i) {
+        layout.Add(bounds[i], bounds[i], i == 0);
+    }
+}
+
+static bool CheckLookups() {
+    MonitorLayout layout;
+    BuildMixed(layout);
+    bool ok = true;
+
+    const PointCase points[] = {
+        { "origin", 0, 0, 0 },
+        { "left of shared edge", 1919, 500, 0 },
+        { "on shared edge", 1920, 500, 1 },  // Right/bottom are exclusive
+        { "last pixel", 3839, 1079, 1 },
+        { "left of primary", -1, 0, 2 },
+        { "portrait corner", -1080, -400, 2 },
+        { "off right", 5000, 500, 1 },
+        { "off below primary", 1000, 2000, 0 },
+        { "off far left", -3000, 0, 2 },
+        { "just above right", 2000, -50, 1 },
+    };
+    for (const PointCase& test : points) {
+        int actual = layout.FromPoint(test.x, test.y);
+        if (actual != test.expected) {
+            std::printf("FromPoint %s (%d,%d): %d, expected %d\n", test.name, test.x, test.y, actual, test.expected);
+            ok = false;
+        }
+    }
+
+    const RectCase rects[] = {
+        { "mostly right", { 1500, 100, 2500, 900 }, 1, 1 },
+        { "mostly left", { 1000, 100, 2000, 900 }, 0, 0 },
+        { "across portrait", { -300, 0, 500, 600 }, 0, 0 },
+        { "inside portrait", { -1000, 1200, -100, 1500 }, 2, 2 },
+        { "touching edge only", { 3840, 0, 4000, 100 }, -1, 1 },
+        { "minimized", { -32000, -32000, -31840, -31972 }, -1, 2 },
+    };
+    for (const RectCase& test : rects) {
+        int overlap = layout.FindLargestOverlap(test.rect);
+        int actual = layout.FromRect(test.rect);
+        if (overlap != test.expectedOverlap || actual != test.expected) {
+            std::printf("rect %s: overlap %d, FromRect %d, expected %d, %d\n", test.name, overlap, actual,
+                        test.expectedOverlap, test.expected);
+            ok = false;
+        }
+    }
+
+    MonitorLayout empty;
+    MonitorRect anywhere = { 0, 0, 100, 100 };
+    if (empty.FromPoint(0, 0) != -1 || empty.FindLargestOverlap(anywhere) != -1 || empty.FromRect(anywhere) != -1) {
+        std::printf("empty layout: expected -1 everywhere\n");
+        ok = false;
+    }
+
+    std::printf("lookups: %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static void BuildGrid(MonitorLayout& layout, int monitorCount) {
+    int columns = 1;
+    while (columns * columns < monitorCount) {
+        ++columns;
+    }
+
+    layout.Clear();
+    for (int i = 0; i < monitorCount; ++i) {
+        int32_t left = (i % columns) * 1920;
+        int32_t top = (i / columns) * 1080;
+        MonitorRect bounds = { left, top, left + 1920, top + 1080 };
+        MonitorRect workArea = { left, top, left + 1920, top + 1040 };
+        layout.Add(bounds, workArea, i == 0);
+    }
+}
+
+void RunGeometryBench() {
+    bool ok = CheckLookups();
+
+    const int counts[] = { 1, 2, 4, 8, 16 };
+
+    for (int monitorCount : counts) {
+        MonitorLayout layout;
+        BuildGrid(layout, monitorCount);
+
+        // Spread queries over the whole desktop plus a margin of off-screen space
+        int32_t maxX = 0;
+        int32_t maxY = 0;
+        for (int i = 0; i < layout.GetCount(); ++i) {
+            maxX = std::max(maxX, layout.Get(i).bounds.right);
+            maxY = std::max(maxY, layout.Get(i).bounds.bottom);
+        }
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int32_t> xs(-200, maxX + 200);
+        std::uniform_int_distribution<int32_t> ys(-200, maxY + 200);
+
+        std::vector<int32_t> px(LOOKUPS);
+        std::vector<int32_t> py(LOOKUPS);
+        for (int i = 0; i < LOOKUPS; ++i) {
+            px[i] = xs(rng);
+            py[i] = ys(rng);
+        }
+
+        int sink = 0;
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < LOOKUPS; ++i) {
+            sink += layout.FromPoint(px[i], py[i]);
+        }
+        double pointNs = BenchElapsedNs(start, BenchClock::now()) / LOOKUPS;
+
+        // Window-sized rects, many straddling monitor edges
+        start = BenchClock::now();
+        for (int i = 0; i < LOOKUPS; ++i) {
+            MonitorRect rect = { px[i], py[i], px[i] + 1200, py[i] + 800 };
+            sink += layout.FromRect(rect);
+        }
+        double rectNs = BenchElapsedNs(start, BenchClock::now()) / LOOKUPS;
+
+        BenchDoNotOptimize(sink);
+        std::printf("%2d monitor(s): FromPoint %6.2f ns  FromRect %6.2f ns\n", monitorCount, pointNs, rectNs);
+    }
+
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("geometry", "checks", "ok", ok ? 1.0 : 0.0);
+}
@@ -0,0 +1,106 @@
+#include <cmath>
+#include <random>
+#include <thread>
+#include "Bench.h"
+#include "LatencyHistogram.h"
+
+// LatencyHistogram percentile accuracy against exact sorted samples, and
+// the cost of Record() from one and from several threads
+
+static const int SAMPLES = 1000000;
+
+// What LatencyHistogram promises for any reported value
+static const double MAX_RELATIVE_ERROR = 2.0 / LatencyHistogram::SUB_BUCKETS;
+
+static bool CheckBucketMapping() {
+    // Every value must land in a bucket whose upper bound is >= the value
+    // and within 2/SUB_BUCKETS of it
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 1000000; ++i) {
+        uint64_t value = rng() >> (rng() % 64);
+        uint64_t bound = LatencyHistogram::GetBucketUpperBound(LatencyHistogram::GetBucketIndex(value));
+        if (bound < value || static_cast<double>(bound - value) > MAX_RELATIVE_ERROR * static_cast<double>(value)) {
+            std::printf("bucket mapping: FAIL at %llu (bound %llu)\n",
+                        static_cast<unsigned long long>(value), static_cast<unsigned long long>(bound));
+            return false;
+        }
+    }
+
+    if (LatencyHistogram::GetBucketIndex(UINT64_MAX) != LatencyHistogram::BUCKET_COUNT - 1) {
+        std::printf("bucket mapping: FAIL, max value not in the last bucket\n");
+        return false;
+    }
+
+    std::printf("bucket mapping: ok (%d buckets)\n", LatencyHistogram::BUCKET_COUNT);
+    return true;
+}
+
+template <typename Distribution>
+static bool CheckAccuracy(const char* name, Distribution distribution) {
+    std::mt19937 rng(42);
+    LatencyHistogram histogram;
+    std::vector<double> exact;
+    exact.reserve(SAMPLES);
+
+    for (int i = 0; i < SAMPLES; ++i) {
+        uint64_t value = static_cast<uint64_t>(distribution(rng));
+        histogram.Record(value);
+        exact.push_back(static_cast<double>(value));
+    }
+
+    const double percentiles[] = { 50.0, 90.0, 99.0, 99.9, 100.0 };
+    double worstError = 0.0;
+    std::printf("%-12s", name);
+    for (double percentile : percentiles) {
+        double expected = BenchPercentile(exact, percentile);
+        double reported = static_cast<double>(histogram.GetValueAtPercentile(percentile));
+        double error = expected > 0.0 ? std::fabs(reported - expected) / expected : 0.0;
+        worstError = std::max(worstError, error);
+        std::printf("  p%-5g %10.0f/%-10.0f", percentile, reported, expected);
+    }
+    bool ok = worstError <= MAX_RELATIVE_ERROR;
+    std::printf("  worst error %.2f%%%s\n", worstError * 100.0, ok ? "" : " FAIL");
+    BenchReport("histogram", name, "worst_error", worstError);
+    return ok;
+}
+
+static void MeasureRecord(int threadCount) {
+    LatencyHistogram histogram;
+    const int perThread = 10000000 / threadCount;
+
+    BenchClock::time_point start = BenchClock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.push_back(std::thread([&histogram, perThread, t]() {
+            uint64_t value = 1000 + t;
+            for (int i = 0; i < perThread; ++i) {
+                histogram.Record(value);
+                value = (value * 2862933555777941757ull + 3037000493ull) >> 40;  // 0..16M ns
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double elapsedNs = BenchElapsedNs(start, BenchClock::now());
+
+    std::printf("Record, %d thread(s): %.1f ns/op (count %llu)\n", threadCount,
+                elapsedNs / (static_cast<double>(perThread) * threadCount),
+                static_cast<unsigned long long>(histogram.GetCount()));
+}
+
+void RunHistogramBench() {
+    bool ok = CheckBucketMapping();
+
+    // Shapes resembling hotkey stages: tight syscall times, a long-tailed
+    // cross-process activation, and a wide uniform spread
+    ok = CheckAccuracy("lognormal", std::lognormal_distribution<double>(10.0, 1.0)) && ok;
+    ok = CheckAccuracy("exponential", std::exponential_distribution<double>(1.0 / 250000.0)) && ok;
+    ok = CheckAccuracy("uniform", std::uniform_int_distribution<uint64_t>(0, 50000000)) && ok;
+
+    MeasureRecord(1);
+    MeasureRecord(4);
+
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("histogram", "checks", "ok", ok ? 1.0 : 0.0);
+}
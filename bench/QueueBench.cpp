@@ -0,0 +1,185 @@
+#include <atomic>
+#include <thread>
+#include "Bench.h"
+#include "HookEvent.h"
+
+// Drives HookEventQueue with a synthetic hook thread (producer) and a
+// worker (consumer) that drains in batches, the same shape FocusTracker uses.
+
+static const size_t CONSUMER_BATCH = 64;
+
+static HookEvent MakeEvent(uint64_t i) {
+    HookEvent e;
+    e.event = (i % 8 == 0) ? 0x0003u : 0x8001u;  // Mostly destroys, some foreground
+    e.idObject = 0;
+    e.hwnd = static_cast<WindowKey>(0x10000 + (i % 4096) * 16);
+    e.eventTime = static_cast<uint32_t>(i);
+    return e;
+}
+
+// Consumer that drains until told to stop, optionally spending time per event
+static void DrainLoop(HookEventQueue& queue, std::atomic<bool>& done, uint64_t& consumed, int workNsPerEvent) {
+    HookEvent batch[CONSUMER_BATCH];
+
+    while (true) {
+        size_t n = queue.PopBatch(batch, CONSUMER_BATCH);
+        if (n == 0) {
+            if (done.load(std::memory_order_acquire) && queue.IsEmpty()) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            BenchDoNotOptimize(batch[i]);
+            if (workNsPerEvent > 0) {
+                BenchClock::time_point until = BenchClock::now() + std::chrono::nanoseconds(workNsPerEvent);
+                while (BenchClock::now() < until) {
+                }
+            }
+        }
+        consumed += n;
+    }
+}
+
+// Producer pushes as fast as possible, retrying on a full ring
+static void RunSustained(uint64_t totalEvents) {
+    HookEventQueue* queue = new HookEventQueue();
+    std::atomic<bool> done(false);
+    uint64_t consumed = 0;
+
+    std::thread consumer(DrainLoop, std::ref(*queue), std::ref(done), std::ref(consumed), 0);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (uint64_t i = 0; i < totalEvents; ++i) {
+        HookEvent e = MakeEvent(i);
+        while (!queue->TryPush(e)) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    BenchClock::time_point end = BenchClock::now();
+
+    double seconds = BenchElapsedNs(start, end) / 1e9;
+    std::printf("sustained: %llu events in %.3f s = %.2f M events/s (full-ring retries: %llu)\n",
+                static_cast<unsigned long long>(consumed), seconds,
+                static_cast<double>(consumed) / seconds / 1e6,
+                static_cast<unsigned long long>(queue->GetDroppedCount()));
+    delete queue;
+}
+
+// Bursty producer (drag/animation-like) timing each individual push
+static void RunEnqueueLatency(int bursts, int burstSize, int gapUs) {
+    HookEventQueue* queue = new HookEventQueue();
+    std::atomic<bool> done(false);
+    uint64_t consumed = 0;
+
+    std::thread consumer(DrainLoop, std::ref(*queue), std::ref(done), std::ref(consumed), 0);
+
+    // Calibrate the cost of the timer itself
+    std::vector<double> overhead;
+    overhead.reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        BenchClock::time_point a = BenchClock::now();
+        BenchClock::time_point b = BenchClock::now();
+        overhead.push_back(BenchElapsedNs(a, b));
+    }
+    double timerNs = BenchPercentile(overhead, 50.0);
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(bursts) * burstSize);
+    uint64_t i = 0;
+
+    for (int b = 0; b < bursts; ++b) {
+        for (int k = 0; k < burstSize; ++k, ++i) {
+            HookEvent e = MakeEvent(i);
+            BenchClock::time_point t0 = BenchClock::now();
+            queue->TryPush(e);
+            BenchClock::time_point t1 = BenchClock::now();
+            samples.push_back(BenchElapsedNs(t0, t1) - timerNs);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(gapUs));
+    }
+
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    std::printf("enqueue (bursts of %d): p50=%.1f ns p99=%.1f ns p99.9=%.1f ns max=%.1f ns (timer %.1f ns subtracted, dropped %llu)\n",
+                burstSize,
+                BenchPercentile(samples, 50.0), BenchPercentile(samples, 99.0),
+                BenchPercentile(samples, 99.9), BenchPercentile(samples, 100.0),
+                timerNs, static_cast<unsigned long long>(queue->GetDroppedCount()));
+    delete queue;
+}
+
+// Slow consumer: shows that overflow is counted rather than blocking the hook
+static void RunOverflow(uint64_t totalEvents, int workNsPerEvent) {
+    HookEventQueue* queue = new HookEventQueue();
+    std::atomic<bool> done(false);
+    uint64_t consumed = 0;
+
+    std::thread consumer(DrainLoop, std::ref(*queue), std::ref(done), std::ref(consumed), workNsPerEvent);
+
+    for (uint64_t i = 0; i < totalEvents; ++i) {
+        queue->TryPush(MakeEvent(i));
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    std::printf("overflow (consumer %d ns/event): pushed %llu, consumed %llu, dropped %llu\n",
+                workNsPerEvent, static_cast<unsigned long long>(totalEvents),
+                static_cast<unsigned long long>(consumed),
+                static_cast<unsigned long long>(queue->GetDroppedCount()));
+    delete queue;
+}
+
+// A drag burst while the worker is stalled: location changes go through
+// MoveEventQueue as FocusTracker's hook does, and must neither fill it nor
+// push foreground records out of the event queue
+static bool RunMoveBurst(uint64_t totalMoves, int windows) {
+    HookEventQueue* queue = new HookEventQueue();
+    MoveEventQueue* moves = new MoveEventQueue();
+
+    uint64_t foregrounds = 0;
+    for (uint64_t i = 0; i < totalMoves; ++i) {
+        moves->Push(static_cast<WindowKey>(0x10000 + (i % windows) * 16));
+        if (i % 1000 == 0) {
+            HookEvent e = MakeEvent(0);  // Foreground
+            queue->TryPush(e);
+            ++foregrounds;
+        }
+    }
+
+    WindowKey batch[CONSUMER_BATCH];
+    size_t queued = 0;
+    size_t n;
+    while ((n = moves->PopBatch(batch, CONSUMER_BATCH)) > 0) {
+        queued += n;
+    }
+
+    // Popped windows are queued again on their next change
+    bool requeued = moves->Push(static_cast<WindowKey>(0x10000));
+
+    bool ok = queue->GetDroppedCount() == 0 && moves->GetDroppedCount() == 0 &&
+              queued <= static_cast<size_t>(windows) && requeued;
+    std::printf("move burst: %llu changes over %d windows -> %zu queued, %llu foreground(s) kept, dropped %llu\n",
+                static_cast<unsigned long long>(totalMoves), windows, queued,
+                static_cast<unsigned long long>(foregrounds),
+                static_cast<unsigned long long>(queue->GetDroppedCount() + moves->GetDroppedCount()));
+    BenchReport("queue", "move_burst", "queued", static_cast<double>(queued));
+    delete moves;
+    delete queue;
+    return ok;
+}
+
+void RunQueueBench() {
+    RunSustained(20000000);
+    RunEnqueueLatency(2000, 256, 200);
+    RunOverflow(1000000, 500);
+
+    bool ok = RunMoveBurst(1000000, 24);
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("queue", "checks", "ok", ok ? 1.0 : 0.0);
+}
@@ -0,0 +1,209 @@
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Bench.h"
+#include "WindowRegistry.h"
+
+// Generation-tagged window handles: cost of the liveness check the press
+// path makes per candidate and of register/unregister, plus checks with
+// simulated HWND reuse. Window values come from a small pool, so a value
+// comes back for a new window again and again, as it does on Windows. A
+// handle must die with its window and never resolve to whichever window got
+// its value next, also for a reader on another thread. The same goes for
+// the cached window state read through a handle.
+
+static const size_t CAPACITY = 320;  // MonitorManager: 32 monitors x 10 windows
+static const int OPERATIONS = 1000000;
+static const int CHURN_STEPS = 500000;
+static const int CONTENDED_MS = 300;
+static const uint32_t KEY_POOL = 512;  // More windows than slots, fewer values than windows
+static const size_t PUBLISHED = 64;
+
+static WindowKey MakeKey(uint32_t n) {
+    return 0x10000 + static_cast<WindowKey>(n) * 16;  // Aligned and clustered like HWNDs
+}
+
+// Random register/unregister against a model of which window holds which handle
+static uint64_t RunChurn(WindowRegistry* registry) {
+    std::mt19937 rng(42);
+    std::vector<WindowHandle> live(KEY_POOL, 0);
+    std::vector<std::pair<WindowHandle, WindowKey>> retired;
+    uint64_t mismatches = 0;
+
+    for (int step = 0; step < CHURN_STEPS; ++step) {
+        uint32_t n = rng() % KEY_POOL;
+        WindowKey key = MakeKey(n);
+
+        if (live[n] != 0 && (rng() & 1) != 0) {
+            WindowHandle handle = registry->Unregister(key);
+            mismatches += handle != live[n];
+            mismatches += registry->IsAlive(handle);
+            retired.push_back(std::make_pair(handle, key));
+            live[n] = 0;
+        } else {
+            bool full = live[n] == 0 && registry->GetCount() == registry->GetCapacity();
+            WindowHandle handle = registry->Register(key);
+            if (live[n] != 0) {
+                mismatches += handle != live[n];  // Registering twice is idempotent
+            } else if (full) {
+                mismatches += handle != 0;
+            } else {
+                mismatches += handle == 0 || registry->Resolve(handle) != key;
+                live[n] = handle;
+            }
+        }
+
+        // A handle from earlier, maybe of this very value: must stay dead
+        if (!retired.empty()) {
+            const std::pair<WindowHandle, WindowKey>& old = retired[rng() % retired.size()];
+            mismatches += registry->IsAlive(old.first);
+            mismatches += registry->Resolve(old.first) != 0;
+        }
+
+        uint32_t probe = rng() % KEY_POOL;
+        mismatches += registry->Find(MakeKey(probe)) != live[probe];
+    }
+
+    return mismatches;
+}
+
+void RunRegistryBench() {
+    bool ok = true;
+
+    // The same HWND value for a new window gets a new handle
+    WindowRegistry registry(CAPACITY);
+    WindowHandle first = registry.Register(MakeKey(1));
+    registry.Unregister(MakeKey(1));
+    WindowHandle second = registry.Register(MakeKey(1));
+    bool reuseOk = first != 0 && second != 0 && first != second && !registry.IsAlive(first) &&
+                   registry.Resolve(first) == 0 && registry.Resolve(second) == MakeKey(1);
+
+    // So does a new window in the old one's slot, and Clear kills everything
+    registry.Unregister(MakeKey(1));
+    WindowHandle other = registry.Register(MakeKey(2));
+    reuseOk = reuseOk && WindowRegistry::GetSlot(other) == WindowRegistry::GetSlot(second) &&
+              !registry.IsAlive(second) && registry.Resolve(second) == 0;
+    registry.Clear();
+    reuseOk = reuseOk && !registry.IsAlive(other) && registry.Register(MakeKey(2)) != other;
+    registry.Clear();
+
+    // State belongs to the window: it dies with the handle and a new occupant starts clear
+    WindowHandle shown = registry.Register(MakeKey(3));
+    bool stateOk = registry.SetState(MakeKey(3), WINDOW_STATE_VISIBLE) &&
+                   !registry.SetState(MakeKey(3), WINDOW_STATE_VISIBLE) &&
+                   !registry.SetState(MakeKey(4), WINDOW_STATE_VISIBLE) &&
+                   IsWindowStateActivatable(registry.GetState(shown));
+    registry.Unregister(MakeKey(3));
+    WindowHandle reused = registry.Register(MakeKey(3));
+    stateOk = stateOk && registry.GetState(shown) == 0 && registry.GetState(reused) == 0 &&
+              registry.GetStateOf(MakeKey(3)) == 0;
+    registry.Clear();
+
+    uint64_t churnMismatches = RunChurn(&registry);
+    std::printf("state: %s\n", stateOk ? "ok" : "FAILED");
+    std::printf("reuse: %s, churn: %d steps over %u window values, %llu mismatches\n", reuseOk ? "ok" : "FAILED",
+                CHURN_STEPS, KEY_POOL, static_cast<unsigned long long>(churnMismatches));
+    BenchReport("registry", "churn", "mismatches", static_cast<double>(churnMismatches));
+    ok = ok && reuseOk && stateOk && churnMismatches == 0;
+
+    // Costs, with the registry as full as the focus stacks get
+    registry.Clear();
+    std::vector<WindowHandle> handles;
+    for (uint32_t n = 0; n < CAPACITY; ++n) {
+        handles.push_back(registry.Register(MakeKey(n)));
+        registry.SetState(MakeKey(n), (n % 4 == 0) ? WINDOW_STATE_MINIMIZED : WINDOW_STATE_VISIBLE);
+    }
+
+    uint64_t alive = 0;
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < OPERATIONS; ++i) {
+        alive += registry.IsAlive(handles[static_cast<size_t>(i) % CAPACITY]);
+    }
+    double aliveNs = BenchElapsedNs(start, BenchClock::now()) / OPERATIONS;
+    BenchDoNotOptimize(alive);
+
+    WindowKey resolved = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < OPERATIONS; ++i) {
+        resolved += registry.Resolve(handles[static_cast<size_t>(i) % CAPACITY]);
+    }
+    double resolveNs = BenchElapsedNs(start, BenchClock::now()) / OPERATIONS;
+    BenchDoNotOptimize(resolved);
+
+    // The candidate filter: one of these per stacked window instead of two syscalls
+    uint64_t activatable = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < OPERATIONS; ++i) {
+        activatable += IsWindowStateActivatable(registry.GetState(handles[static_cast<size_t>(i) % CAPACITY]));
+    }
+    double stateNs = BenchElapsedNs(start, BenchClock::now()) / OPERATIONS;
+    BenchDoNotOptimize(activatable);
+
+    start = BenchClock::now();
+    for (int i = 0; i < OPERATIONS; ++i) {
+        WindowKey key = MakeKey(static_cast<uint32_t>(i) % CAPACITY);
+        registry.Unregister(key);
+        registry.Register(key);
+    }
+    double churnNs = BenchElapsedNs(start, BenchClock::now()) / OPERATIONS;
+
+    std::printf("is-alive: %.1f ns, resolve: %.1f ns, state: %.1f ns, unregister+register: %.1f ns (%zu windows)\n",
+                aliveNs, resolveNs, stateNs, churnNs, CAPACITY);
+    BenchReport("registry", "is_alive", "ns_per_op", aliveNs);
+    BenchReport("registry", "resolve", "ns_per_op", resolveNs);
+    BenchReport("registry", "get_state", "ns_per_op", stateNs);
+    BenchReport("registry", "unregister_register", "ns_per_op", churnNs);
+
+    // A reader resolving handles while the writer recycles windows, like the
+    // activation worker reading the ready target the focus worker just replaced
+    registry.Clear();
+    std::atomic<uint64_t> published[PUBLISHED];  // Handle << 32 | window number
+    for (std::atomic<uint64_t>& entry : published) {
+        entry.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> stop(false);
+    std::thread writer([&]() {
+        std::mt19937 rng(7);
+        size_t next = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            uint32_t n = rng() % KEY_POOL;
+            if (registry.Unregister(MakeKey(n)) != 0) {
+                continue;
+            }
+            WindowHandle handle = registry.Register(MakeKey(n));
+            if (handle != 0) {
+                published[next++ % PUBLISHED].store(static_cast<uint64_t>(handle) << 32 | n, std::memory_order_release);
+            }
+        }
+    });
+
+    uint64_t reads = 0;
+    uint64_t resolvedLive = 0;
+    uint64_t wrongWindow = 0;
+    BenchClock::time_point deadline = BenchClock::now() + std::chrono::milliseconds(CONTENDED_MS);
+    while (BenchClock::now() < deadline) {
+        for (size_t i = 0; i < PUBLISHED; ++i) {
+            uint64_t entry = published[i].load(std::memory_order_acquire);
+            WindowKey key = registry.Resolve(static_cast<WindowHandle>(entry >> 32));
+            ++reads;
+            if (key != 0) {
+                ++resolvedLive;
+                wrongWindow += key != MakeKey(static_cast<uint32_t>(entry & 0xFFFFFFFFu));
+            }
+        }
+    }
+    stop.store(true);
+    writer.join();
+
+    std::printf("contended %d ms: %llu resolves, %llu alive, %llu resolved to another window\n", CONTENDED_MS,
+                static_cast<unsigned long long>(reads), static_cast<unsigned long long>(resolvedLive),
+                static_cast<unsigned long long>(wrongWindow));
+    BenchReport("registry", "contended", "wrong_window", static_cast<double>(wrongWindow));
+    ok = ok && wrongWindow == 0;
+
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("registry", "checks", "ok", ok ? 1.0 : 0.0);
+}
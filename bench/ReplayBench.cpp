@@ -0,0 +1,87 @@
+#include <random>
+#include <string>
+#include "Bench.h"
+#include "TraceReader.h"
+#include "TraceReplayer.h"
+#include "TraceWriter.h"
+
+// Trace append cost and replay throughput on a synthetic desktop trace:
+// a working set of windows on 3 monitors, destroy events for many more,
+// occasional moves of a tracked window to another monitor
+
+static const int EVENTS = 2000000;
+
+void RunReplayBench() {
+    std::string path = "true-recall-bench.trace";
+
+    MonitorLayout layout;
+    for (int i = 0; i < 3; ++i) {
+        MonitorRect bounds = { i * 1920, 0, (i + 1) * 1920, 1080 };
+        layout.Add(bounds, bounds, i == 0);
+    }
+
+    TraceWriter writer;
+    if (!writer.Open(path, layout, 32, 10)) {
+        std::printf("cannot create %s\n", path.c_str());
+        return;
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> windows(1, 200);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < EVENTS; ++i) {
+        TraceRecord record = {};
+        int kind = percent(rng);
+        if (kind < 30) {
+            // Mostly short-lived helper windows we never tracked
+            record.type = static_cast<uint16_t>(TraceEventType::Destroy);
+            record.window = 0x100000 + static_cast<uint64_t>(rng() % 50000);
+            record.monitor = -1;
+        } else if (kind < 33) {
+            // Window dragged over; foreground half the time
+            int window = windows(rng);
+            int monitor = static_cast<int>(rng() % 3);
+            record.type = static_cast<uint16_t>(TraceEventType::Move);
+            record.window = 0x10000 + static_cast<uint64_t>(window);
+            record.monitor = static_cast<int16_t>(monitor);
+            record.flags = TRACE_FLAG_TRACKED | (percent(rng) < 50 ? TRACE_FLAG_FOREGROUND : 0);
+        } else {
+            int window = windows(rng);
+            int monitor = window % 3;
+            record.type = static_cast<uint16_t>(TraceEventType::Focus);
+            record.window = 0x10000 + static_cast<uint64_t>(window);
+            record.monitor = static_cast<int16_t>(monitor);
+            record.rect.left = monitor * 1920 + 100;
+            record.rect.top = 100;
+            record.rect.right = monitor * 1920 + 1300;
+            record.rect.bottom = 900;
+        }
+        writer.Append(record);
+    }
+    double appendNs = BenchElapsedNs(start, BenchClock::now()) / EVENTS;
+    writer.Close();
+
+    TraceReader reader;
+    if (!reader.Open(path)) {
+        std::printf("cannot read %s: %s\n", path.c_str(), reader.GetError());
+        return;
+    }
+
+    TraceReplayer replayer(reader);
+    ReplayResult first = replayer.Run(false);
+    ReplayResult second = replayer.Run(false);
+
+    std::printf("append: %.1f ns/event (%llu events, %.1f MB)\n", appendNs,
+                static_cast<unsigned long long>(reader.GetRecordCount()),
+                (sizeof(TraceHeader) + reader.GetRecordCount() * sizeof(TraceRecord)) / (1024.0 * 1024.0));
+    std::printf("replay: %.1f ns/event, %.1fM events/s, mismatches %llu\n",
+                static_cast<double>(second.elapsedNs) / EVENTS, EVENTS / (second.elapsedNs / 1e3),
+                static_cast<unsigned long long>(second.monitorMismatches));
+    std::printf("deterministic: %s (digest %016llx)\n", first.stackDigest == second.stackDigest ? "yes" : "NO",
+                static_cast<unsigned long long>(second.stackDigest));
+
+    reader.Close();
+    std::remove(path.c_str());
+}
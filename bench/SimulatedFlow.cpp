@@ -0,0 +1,282 @@
+#include "SimulatedFlow.h"
+#include <algorithm>
+#include <cstring>
+
+// FocusTracker's settle delay after the cloak events of a desktop change
+static const int DESKTOP_SETTLE_MS = 50;
+
+// Wall clock of the simulated run's start, for learned-strategy ageing
+static const uint64_t UNIX_SECONDS_BASE = 1700000000;
+
+SimulatedFlow::SimulatedFlow(int monitorCount)
+    : m_monitors(&m_system, &m_system, &m_system)
+    , m_sequencer(&m_system, this, &m_stats, &m_strategyTable, &m_responsiveness)
+    , m_deadlineTimer(0)
+    , m_desktopTimer(0)
+    , m_fallbackSearches(0)
+{
+    std::memset(m_events, 0, sizeof(m_events));
+    SetMonitorCount(monitorCount);
+    m_system.SetForegroundListener([this](WindowKey window) { OnForeground(window); });
+}
+
+WindowKey SimulatedFlow::OpenWindow(int monitorIndex, const SimWindowSpec& spec) {
+    SimWindowSpec placed = spec;
+    int32_t width = placed.rect.right - placed.rect.left;
+    int32_t height = placed.rect.bottom - placed.rect.top;
+    placed.rect.left = monitorIndex * MONITOR_WIDTH + 100;
+    placed.rect.top = 100;
+    placed.rect.right = placed.rect.left + width;
+    placed.rect.bottom = placed.rect.top + height;
+    return m_system.AddWindow(placed);
+}
+
+void SimulatedFlow::CloseWindow(WindowKey window) {
+    // EVENT_OBJECT_DESTROY
+    m_system.DestroyWindow(window);
+    m_monitors.ForgetWindowTitle(window);
+    if (m_monitors.IsWindowTracked(window)) {
+        m_monitors.RemoveWindowFromAllStacks(window);
+        m_monitors.RefreshReadyTargets();
+    }
+}
+
+void SimulatedFlow::SetWindowState(WindowKey window, uint32_t state) {
+    const SimWindowSpec* spec = m_system.GetSpec(window);
+    if (spec == nullptr) {
+        return;
+    }
+    uint32_t changed = spec->state ^ state;
+    m_system.SetWindowState(window, state);
+
+    // EVENT_SYSTEM_MINIMIZESTART / END and EVENT_OBJECT_SHOW / HIDE
+    bool stacksChanged = false;
+    bool readyChanged = false;
+    if ((changed & WINDOW_STATE_MINIMIZED) != 0) {
+        stacksChanged |= OnMove(window);
+        readyChanged |= m_monitors.SetWindowStateFlag(window, WINDOW_STATE_MINIMIZED,
+                                                      (state & WINDOW_STATE_MINIMIZED) != 0);
+    }
+    if ((changed & WINDOW_STATE_VISIBLE) != 0) {
+        readyChanged |= m_monitors.SetWindowStateFlag(window, WINDOW_STATE_VISIBLE, (state & WINDOW_STATE_VISIBLE) != 0);
+    }
+    if (stacksChanged || readyChanged) {
+        m_monitors.RefreshReadyTargets();
+    }
+}
+
+void SimulatedFlow::SetHung(WindowKey window, bool hung) {
+    m_system.SetHung(window, hung);
+    if (!hung) {
+        m_responsiveness.Update(window, false, m_system.Now());  // What the prober's recheck would find
+    }
+}
+
+void SimulatedFlow::MoveWindow(WindowKey window, int monitorIndex) {
+    // EVENT_SYSTEM_MOVESIZEEND: the window follows to the new monitor's stack
+    MonitorRect rect = { monitorIndex * MONITOR_WIDTH + 100, 100, monitorIndex * MONITOR_WIDTH + 900, 700 };
+    m_system.MoveWindow(window, rect);
+    if (OnMove(window)) {
+        m_monitors.RefreshReadyTargets();
+    }
+}
+
+void SimulatedFlow::MoveWindowToDesktop(WindowKey window, DesktopId desktop) {
+    std::vector<WindowKey> wasCloaked;
+    CopyCloakedWindows(&wasCloaked);
+    if (m_system.MoveWindowToDesktop(window, desktop)) {
+        SendCloakEvents(wasCloaked);
+    }
+}
+
+void SimulatedFlow::SwitchDesktop(DesktopId desktop) {
+    std::vector<WindowKey> wasCloaked;
+    CopyCloakedWindows(&wasCloaked);
+    m_system.SwitchDesktop(desktop);
+    SendCloakEvents(wasCloaked);
+}
+
+void SimulatedFlow::SetMonitorCount(int monitorCount) {
+    // WM_DISPLAYCHANGE
+    m_system.ClearMonitors();
+    for (int i = 0; i < monitorCount; ++i) {
+        MonitorRect bounds = { i * MONITOR_WIDTH, 0, (i + 1) * MONITOR_WIDTH, MONITOR_HEIGHT };
+        m_system.AddMonitor(bounds, i == 0);
+    }
+    m_monitors.EnumerateMonitors();
+
+    // Windows pulls windows off removed monitors, each move a location change event
+    MonitorLayout layout = m_monitors.GetLayout();
+    std::vector<WindowKey> windows;
+    m_system.EnumerateWindows(&windows);
+    for (WindowKey window : windows) {
+        if (layout.FindLargestOverlap(m_system.GetSpec(window)->rect) < 0) {
+            MoveWindow(window, 0);
+        }
+    }
+}
+
+void SimulatedFlow::Click(WindowKey window) {
+    if (m_system.Focus(window)) {
+        Settle();
+    }
+}
+
+void SimulatedFlow::Settle() {
+    while (m_system.RunNext()) {
+    }
+}
+
+void SimulatedFlow::StartPress(int monitorIndex) {
+    m_pressTime = m_system.Now();
+    m_stats.OnHotkey();
+    m_sequencer.Start(monitorIndex, m_pressTime);
+}
+
+FlowPress SimulatedFlow::FinishPress() {
+    Settle();
+
+    FlowPress press;
+    press.foreground = m_system.GetForeground();
+    press.latencyMs = std::chrono::duration<double, std::milli>(m_finishTime - m_pressTime).count();
+    return press;
+}
+
+FlowPress SimulatedFlow::Press(int monitorIndex) {
+    StartPress(monitorIndex);
+    return FinishPress();
+}
+
+void SimulatedFlow::OnForeground(WindowKey window) {
+    m_stats.OnForeground(window, m_system.Now());
+
+    // The pipeline's worker picks it up after the focus worker moved on
+    if (m_sequencer.NotifyForeground(window)) {
+        m_system.AddTimer(WindowSystem::Clock::duration::zero(), [this]() { m_sequencer.HandleForeground(); });
+    }
+
+    int monitorIndex = m_monitors.GetMonitorIndexForWindow(window);
+    if (monitorIndex < 0) {
+        return;
+    }
+    m_monitors.OnWindowFocused(window, monitorIndex);
+    m_monitors.RefreshReadyTargets();
+}
+
+bool SimulatedFlow::OnMove(WindowKey window) {
+    if (!m_monitors.IsWindowTracked(window)) {
+        return false;
+    }
+
+    int monitorIndex = m_monitors.GetMonitorIndexForWindow(window);
+    return monitorIndex >= 0 && m_monitors.MoveWindowToMonitor(window, monitorIndex, m_system.GetForeground() == window);
+}
+
+void SimulatedFlow::CopyCloakedWindows(std::vector<WindowKey>* windows) {
+    std::vector<WindowKey> all;
+    m_system.EnumerateWindows(&all);
+    windows->clear();
+    for (WindowKey window : all) {
+        if (m_system.GetWindowState(window, WINDOW_STATE_CLOAKED) != 0) {
+            windows->push_back(window);
+        }
+    }
+}
+
+void SimulatedFlow::SendCloakEvents(const std::vector<WindowKey>& wasCloaked) {
+    // EVENT_OBJECT_CLOAKED / UNCLOAKED; a stacked window among them triggers the refresh
+    std::vector<WindowKey> windows;
+    m_system.EnumerateWindows(&windows);
+    bool stackedChanged = false;
+    for (WindowKey window : windows) {
+        bool cloaked = m_system.GetWindowState(window, WINDOW_STATE_CLOAKED) != 0;
+        if (cloaked != (std::find(wasCloaked.begin(), wasCloaked.end(), window) != wasCloaked.end())) {
+            stackedChanged |= m_monitors.SetWindowStateFlag(window, WINDOW_STATE_CLOAKED, cloaked);
+        }
+    }
+
+    if (stackedChanged) {
+        m_monitors.RefreshReadyTargets();
+        ScheduleDesktopRefresh();
+    }
+}
+
+void SimulatedFlow::ScheduleDesktopRefresh() {
+    if (m_desktopTimer != 0) {
+        m_system.CancelTimer(m_desktopTimer);
+    }
+
+    m_desktopTimer = m_system.AddTimer(std::chrono::milliseconds(DESKTOP_SETTLE_MS), [this]() {
+        m_desktopTimer = 0;
+        if (m_monitors.RefreshDesktops()) {
+            m_monitors.RefreshReadyTargets();
+        }
+    });
+}
+
+WindowKey SimulatedFlow::GetReadyTarget(int monitorIndex, WindowHandle* handle) {
+    return m_monitors.GetReadyTarget(monitorIndex, handle);
+}
+
+void SimulatedFlow::CopyFocusStack(int monitorIndex, std::vector<WindowKey>* stack, std::vector<WindowHandle>* handles) {
+    m_monitors.CopyFocusStack(monitorIndex, stack, handles);
+}
+
+bool SimulatedFlow::IsWindowAlive(WindowHandle handle) {
+    return m_monitors.IsWindowAlive(handle);
+}
+
+uint32_t SimulatedFlow::GetWindowState(WindowHandle handle) {
+    return m_monitors.GetWindowState(handle);
+}
+
+void SimulatedFlow::RemoveWindowFromStack(int monitorIndex, WindowKey window) {
+    m_monitors.RemoveWindowFromStack(monitorIndex, window);
+}
+
+void SimulatedFlow::TryFindWindowOnMonitor(int monitorIndex) {
+    ++m_fallbackSearches;
+    m_monitors.TryFindWindowOnMonitor(monitorIndex);
+}
+
+uint64_t SimulatedFlow::GetAppKey(WindowKey window) {
+    // As the pipeline; the simulated process id stands in for its image hash
+    uint32_t processId = 0;
+    m_system.GetWindowThread(window, &processId);
+
+    uint64_t appKey;
+    if (m_appKeys.Lookup(window, processId, &appKey)) {
+        return appKey;
+    }
+
+    appKey = StrategyTable::MakeAppKey(processId, 0);
+    m_appKeys.Store(window, processId, appKey);
+    return appKey;
+}
+
+uint64_t SimulatedFlow::GetUnixSeconds() {
+    return UNIX_SECONDS_BASE + static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(m_system.Now().time_since_epoch()).count());
+}
+
+void SimulatedFlow::ArmDeadline(int delayMs) {
+    m_deadlineTimer = m_system.AddTimer(std::chrono::milliseconds(delayMs), [this]() {
+        m_deadlineTimer = 0;
+        m_sequencer.HandleDeadline();
+    });
+}
+
+void SimulatedFlow::CancelDeadline() {
+    if (m_deadlineTimer != 0) {
+        m_system.CancelTimer(m_deadlineTimer);
+        m_deadlineTimer = 0;
+    }
+}
+
+void SimulatedFlow::OnFinished() {
+    m_finishTime = m_system.Now();
+}
+
+void SimulatedFlow::OnActivationEvent(ActivationEvent event, WindowKey, ActivationStrategy) {
+    ++m_events[static_cast<int>(event)];
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ActivationSequencer.h"
+#include "ActivationStats.h"
+#include "AppKeyCache.h"
+#include "MonitorManager.h"
+#include "ResponsivenessCache.h"
+#include "SimulatedWindowSystem.h"
+#include "StrategyTable.h"
+
+// What one simulated press did
+struct FlowPress {
+    WindowKey foreground;  // Once everything settled; 0 if none
+    double latencyMs;  // Virtual time from the press until the activation finished
+};
+
+// The application's hotkey -> activation flow, headless. A SimulatedWindowSystem
+// stands in for the desktop, behind a real MonitorManager; its window events are
+// applied the way FocusTracker applies them, and an ActivationSequencer is hosted
+// the way ActivationPipeline hosts it, deadlines on the virtual clock.
+//
+// Monitors side by side. Virtual desktops only once SwitchDesktop() is
+// called. There is no prober: a window marked responsive again through
+// SetHung() is reported to the cache directly, as its recheck would.
+class SimulatedFlow : public ActivationHost {
+public:
+    static const int32_t MONITOR_WIDTH = 1920;
+    static const int32_t MONITOR_HEIGHT = 1080;
+
+    explicit SimulatedFlow(int monitorCount);
+
+    SimulatedWindowSystem& GetSystem() { return m_system; }
+    const MonitorManager& GetMonitors() const { return m_monitors; }
+    const ActivationStats& GetStats() const { return m_stats; }
+    const StrategyTable& GetStrategies() const { return m_strategyTable; }
+    const ResponsivenessCache& GetResponsiveness() const { return m_responsiveness; }
+    const AppKeyCache& GetAppKeys() const { return m_appKeys; }
+    int GetMonitorCount() const { return m_monitors.GetMonitorCount(); }
+
+    // World changes and the window events they cause
+    WindowKey OpenWindow(int monitorIndex, const SimWindowSpec& spec);  // Placed on the monitor; not focused
+    void CloseWindow(WindowKey window);
+    void SetWindowState(WindowKey window, uint32_t state);
+    void SetHung(WindowKey window, bool hung);
+    void MoveWindow(WindowKey window, int monitorIndex);
+    void MoveWindowToDesktop(WindowKey window, DesktopId desktop);
+    void SwitchDesktop(DesktopId desktop);  // Nothing is focused on the new desktop until something is clicked
+    void SetMonitorCount(int monitorCount);  // Display change; windows left off-screen move to the primary
+    void Click(WindowKey window);  // The user focuses it; its event is delivered before this returns
+    void Settle();  // Runs until nothing is scheduled
+
+    // Hotkey press for a monitor, run until the activation and its events are over
+    FlowPress Press(int monitorIndex);
+    void StartPress(int monitorIndex);  // Without running anything; a later press supersedes it
+    FlowPress FinishPress();
+
+    uint64_t GetEventCount(ActivationEvent event) const { return m_events[static_cast<int>(event)]; }
+    uint64_t GetFallbackSearches() const { return m_fallbackSearches; }
+
+    // ActivationHost
+    WindowKey GetReadyTarget(int monitorIndex, WindowHandle* handle) override;
+    void CopyFocusStack(int monitorIndex, std::vector<WindowKey>* stack, std::vector<WindowHandle>* handles) override;
+    bool IsWindowAlive(WindowHandle handle) override;
+    uint32_t GetWindowState(WindowHandle handle) override;
+    void RemoveWindowFromStack(int monitorIndex, WindowKey window) override;
+    void TryFindWindowOnMonitor(int monitorIndex) override;
+    uint64_t GetAppKey(WindowKey window) override;
+    uint64_t GetUnixSeconds() override;
+    void ArmDeadline(int delayMs) override;
+    void CancelDeadline() override;
+    void ProbeSoon(WindowKey) override {}
+    void OnStrategyLearned() override {}
+    void OnFinished() override;
+    void OnActivationEvent(ActivationEvent event, WindowKey window, ActivationStrategy strategy) override;
+
+private:
+    SimulatedWindowSystem m_system;
+    MonitorManager m_monitors;
+    ActivationStats m_stats;
+    StrategyTable m_strategyTable;
+    ResponsivenessCache m_responsiveness;
+    ActivationSequencer m_sequencer;
+    AppKeyCache m_appKeys;
+
+    SimulatedWindowSystem::TimerId m_deadlineTimer;  // 0 if none
+    SimulatedWindowSystem::TimerId m_desktopTimer;  // 0 if none
+    WindowSystem::Clock::time_point m_pressTime;
+    WindowSystem::Clock::time_point m_finishTime;
+    uint64_t m_events[static_cast<int>(ActivationEvent::Activated) + 1];
+    uint64_t m_fallbackSearches;
+
+    // FocusTracker's handlers
+    void OnForeground(WindowKey window);  // EVENT_SYSTEM_FOREGROUND
+    bool OnMove(WindowKey window);  // Location change or minimize; true if the window changed stacks
+    void CopyCloakedWindows(std::vector<WindowKey>* windows);  // Before a desktop change
+    void SendCloakEvents(const std::vector<WindowKey>& wasCloaked);  // After it, for every window that (un)cloaked
+    void ScheduleDesktopRefresh();
+};
@@ -0,0 +1,184 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "Bench.h"
+#include "FocusSnapshot.h"
+
+// Warm-restart snapshot costs: saving and loading a full snapshot file,
+// matching it against 100-50,000 live windows and how many of them needed a
+// full identity fetch, and falling back to the previous slot when the newest
+// one is torn
+
+static const int WRITES = 20000;
+
+static std::vector<SnapshotEntry> MakeEntries(int count, uint64_t seed) {
+    std::vector<SnapshotEntry> entries(count);
+    for (int i = 0; i < count; ++i) {
+        SnapshotEntry& entry = entries[i];
+        entry.identity.processHash = seed + static_cast<uint64_t>(i % 40);  // A few dozen processes
+        entry.identity.classHash = static_cast<uint32_t>(i % 7);
+        entry.identity.titleHash = static_cast<uint32_t>(i * 2654435761u);
+        entry.identity.windowHint = 0x10000 + static_cast<uint64_t>(i) * 0x18;
+        entry.monitor = static_cast<int16_t>(i % 32);
+        entry.rank = static_cast<uint16_t>(i / 32);
+        entry.processId = 4000 + static_cast<uint32_t>(i % 40);
+    }
+    return entries;
+}
+
+// Flip a byte in the payload of the slot with the highest sequence number
+static bool CorruptNewestSlot(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    if (file == nullptr) {
+        return false;
+    }
+
+    // Header is 16 bytes, then two equally sized slots starting with the sequence
+    std::fseek(file, 0, SEEK_END);
+    long slotSize = (std::ftell(file) - 16) / 2;
+    uint64_t sequences[2] = {};
+    for (int i = 0; i < 2; ++i) {
+        std::fseek(file, 16 + i * slotSize, SEEK_SET);
+        if (std::fread(&sequences[i], sizeof(uint64_t), 1, file) != 1) {
+            std::fclose(file);
+            return false;
+        }
+    }
+
+    long offset = 16 + (sequences[0] > sequences[1] ? 0 : slotSize) + 64;
+    std::fseek(file, offset, SEEK_SET);
+    int byte = std::fgetc(file);
+    std::fseek(file, offset, SEEK_SET);
+    std::fputc(byte ^ 0xff, file);
+    std::fclose(file);
+    return true;
+}
+
+void RunSnapshotBench() {
+    std::string path = "true-recall-bench.focus";
+    std::remove(path.c_str());
+
+    FocusSnapshotFile file;
+    if (!file.Open(path)) {
+        std::printf("cannot create %s\n", path.c_str());
+        std::printf("checks: FAILED\n");
+        BenchReport("snapshot", "checks", "ok", 0.0);
+        return;
+    }
+
+    std::vector<SnapshotEntry> entries = MakeEntries(FocusSnapshotFile::MAX_ENTRIES, 1000);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < WRITES; ++i) {
+        file.Write(entries);
+    }
+    double writeUs = BenchElapsedNs(start, BenchClock::now()) / WRITES / 1e3;
+
+    std::vector<SnapshotEntry> loaded;
+    start = BenchClock::now();
+    for (int i = 0; i < WRITES; ++i) {
+        file.Read(&loaded);
+    }
+    double readUs = BenchElapsedNs(start, BenchClock::now()) / WRITES / 1e3;
+
+    std::printf("write: %.2f us, read: %.2f us (%d entries)\n", writeUs, readUs, FocusSnapshotFile::MAX_ENTRIES);
+    BenchReport("snapshot", "write", "us_per_op", writeUs);
+    BenchReport("snapshot", "read", "us_per_op", readUs);
+
+    // A crash between filling a slot and publishing it must leave the older snapshot readable
+    std::vector<SnapshotEntry> older = MakeEntries(100, 2000);
+    std::vector<SnapshotEntry> newer = MakeEntries(200, 3000);
+    file.Write(older);
+    file.Write(newer);
+    file.Close();
+
+    bool torn = CorruptNewestSlot(path);
+    file.Open(path);
+    bool recovered = torn && file.Read(&loaded) && loaded.size() == older.size() &&
+                     loaded[0].identity.processHash == older[0].identity.processHash;
+    std::printf("torn newest slot: %s\n", recovered ? "previous snapshot recovered" : "NOT RECOVERED");
+    BenchReport("snapshot", "torn_slot", "recovered", recovered ? 1.0 : 0.0);
+    bool ok = recovered;
+    file.Close();
+    std::remove(path.c_str());
+
+    // Match a full snapshot against an enumeration: a quarter of the saved
+    // windows survived (handle match), a quarter reopened (identity match).
+    // Only windows left over by the handle pass may cost an identity fetch.
+    const int windowCounts[] = { 100, 1000, 10000, 50000 };
+    for (int windowCount : windowCounts) {
+        std::mt19937 rng(7);
+        std::vector<LiveWindow> windows(windowCount);
+        std::vector<WindowIdentity> identities(windowCount);  // What a fetch would find
+        for (int i = 0; i < windowCount; ++i) {
+            windows[i].window = static_cast<WindowKey>(0x900000 + static_cast<uint64_t>(i) * 0x18);
+            windows[i].processId = 9000 + rng() % 200;
+            identities[i].processHash = 5000 + rng() % 200;
+            identities[i].classHash = static_cast<uint32_t>(rng());
+            identities[i].titleHash = static_cast<uint32_t>(rng());
+            identities[i].windowHint = windows[i].window;
+        }
+
+        int survivors = std::min(windowCount / 4, FocusSnapshotFile::MAX_ENTRIES / 4);
+        for (int i = 0; i < survivors; ++i) {
+            windows[i * 2].window = static_cast<WindowKey>(entries[i].identity.windowHint);
+            windows[i * 2].processId = entries[i].processId;
+            identities[i * 2] = entries[i].identity;
+
+            identities[i * 2 + 1] = entries[FocusSnapshotFile::MAX_ENTRIES / 2 + i].identity;
+            identities[i * 2 + 1].windowHint = windows[i * 2 + 1].window;
+        }
+        for (int i = 0; i < windowCount; ++i) {
+            windows[i].classHash = identities[i].classHash;
+        }
+
+        // Shuffled together, so the fetcher finds a window's identity by handle
+        std::vector<size_t> order(windowCount);
+        for (int i = 0; i < windowCount; ++i) {
+            order[i] = static_cast<size_t>(i);
+        }
+        std::shuffle(order.begin(), order.end(), rng);
+        std::vector<LiveWindow> shuffled(windowCount);
+        std::unordered_map<WindowKey, WindowIdentity> byWindow;
+        for (int i = 0; i < windowCount; ++i) {
+            shuffled[i] = windows[order[i]];
+            byWindow[shuffled[i].window] = identities[order[i]];
+        }
+
+        int fetches = 0;
+        IdentityFetcher fetch = [&byWindow, &fetches](const LiveWindow& window, WindowIdentity* identity) {
+            ++fetches;
+            *identity = byWindow[window.window];
+            return true;
+        };
+
+        int rounds = std::max(20, 2000000 / windowCount);
+        int matched = 0;
+        start = BenchClock::now();
+        for (int round = 0; round < rounds; ++round) {
+            fetches = 0;
+            SnapshotMatcher matcher(entries);
+            std::vector<int> result = matcher.Match(shuffled, fetch);
+            matched = 0;
+            for (int index : result) {
+                matched += index >= 0;
+            }
+        }
+        double matchUs = BenchElapsedNs(start, BenchClock::now()) / rounds / 1e3;
+
+        std::printf("match %6d windows: %8.1f us, %d matched (expected %d), %d identity fetch(es)\n", windowCount,
+                    matchUs, matched, survivors * 2, fetches);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "match_w%d", windowCount);
+        BenchReport("snapshot", name, "us_per_op", matchUs);
+        BenchReport("snapshot", name, "identity_fetches", static_cast<double>(fetches));
+
+        // Survivors cost nothing beyond the enumeration; each reopened window one fetch
+        ok = ok && matched == survivors * 2 && fetches == survivors;
+    }
+
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("snapshot", "checks", "ok", ok ? 1.0 : 0.0);
+}
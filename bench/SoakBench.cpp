@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "Bench.h"
+#include "SimulatedFlow.h"
+
+// Months of uptime in seconds: focus, close, minimize, hang, move and desktop
+// traffic, daily display changes, and hotkey presses, against the simulated flow
+// (the real MonitorManager, sequencer and caches) on a virtual clock. Every few simulated days it samples resident memory,
+// the peak of live heap allocations and of every cache and stack, and the
+// cost of an operation. After a warm-up everything must stay flat: the check fails
+// if the later samples peak above the earlier ones or operations got slower.
+
+static const int SOAK_DAYS = 90;
+static const int OPERATIONS_PER_DAY = 20000;  // A press, click or window event every ~4 s, around the clock
+static const int SAMPLE_DAYS = 3;
+static const int MAX_MONITORS = 3;
+static const size_t MAX_OPEN_WINDOWS = 60;
+static const size_t MAX_HUNG_WINDOWS = 2;
+static const size_t LIVE_DESKTOPS = 4;
+static const int OPERATION_SPACING_MS = 8640;  // Twice the mean gap between operations
+static const uint32_t SOAK_SEED = 0x5eed2025;
+
+// Growth allowed between the warmed-up halves of the run
+static const double SIZE_TOLERANCE = 0.10;
+static const double RESIDENT_SLACK_BYTES = 1024.0 * 1024.0;
+static const double SLOWDOWN_TOLERANCE = 0.50;  // Wall clock, so noisy
+static const double PRESS_SLACK_MS = 5.0;
+
+enum SoakMetric {
+    METRIC_RESIDENT_KB,
+    METRIC_LIVE_ALLOCS,
+    METRIC_TRACKED,
+    METRIC_DESKTOP_ROWS,
+    METRIC_RESPONSIVENESS,
+    METRIC_STRATEGIES,
+    METRIC_APP_KEYS,
+    METRIC_TITLES,
+    METRIC_TIMERS,
+    METRIC_NS_PER_OP,
+    METRIC_PRESS_MS,
+    METRIC_COUNT
+};
+
+struct SoakMetricInfo {
+    const char* name;
+    bool latency;  // Compared by median; sizes by peak
+};
+
+static const SoakMetricInfo g_metrics[METRIC_COUNT] = {
+    { "resident_kb", false },
+    { "live_allocs", false },
+    { "tracked_windows", false },
+    { "desktop_rows", false },
+    { "responsiveness_entries", false },
+    { "strategy_apps", false },
+    { "app_keys", false },
+    { "cached_titles", false },
+    { "pending_timers", false },
+    { "ns_per_op", true },
+    { "press_ms", true },
+};
+
+// The world the soak drives: open windows and live desktops
+struct SoakWorld {
+    SimulatedFlow* flow;
+    std::mt19937 rng;
+    std::vector<WindowKey> windows;
+    std::vector<DesktopId> desktops;
+    DesktopId nextDesktop;
+    double pressMs;
+    int presses;
+};
+
+static WindowKey PickWindow(SoakWorld* world) {
+    return world->windows.empty() ? 0 : world->windows[world->rng() % world->windows.size()];
+}
+
+static void Forget(SoakWorld* world, WindowKey window) {
+    world->windows.erase(std::find(world->windows.begin(), world->windows.end(), window));
+}
+
+static size_t CountHung(SoakWorld* world) {
+    size_t hung = 0;
+    for (WindowKey window : world->windows) {
+        hung += world->flow->GetSystem().GetSpec(window)->hung ? 1 : 0;
+    }
+    return hung;
+}
+
+// The user switches desktops, and something there gets focus
+static void SwitchDesktop(SoakWorld* world, DesktopId desktop) {
+    world->flow->SwitchDesktop(desktop);
+    for (WindowKey window : world->windows) {
+        const SimWindowSpec* spec = world->flow->GetSystem().GetSpec(window);
+        if (spec->desktop == desktop && !spec->hung && IsWindowStateActivatable(spec->state)) {
+            world->flow->Click(window);
+            break;
+        }
+    }
+}
+
+// A desktop is closed (its windows move next door) and a new one created
+static void ReplaceDesktop(SoakWorld* world) {
+    size_t closed = world->rng() % world->desktops.size();
+    DesktopId from = world->desktops[closed];
+    DesktopId to = world->desktops[(closed + 1) % world->desktops.size()];
+
+    if (world->flow->GetSystem().GetCurrentDesktop() == from) {
+        SwitchDesktop(world, to);
+    }
+    for (WindowKey window : world->windows) {
+        if (world->flow->GetSystem().GetSpec(window)->desktop == from) {
+            world->flow->MoveWindowToDesktop(window, to);
+        }
+    }
+    world->desktops[closed] = world->nextDesktop++;
+}
+
+static void RunOperation(SoakWorld* world) {
+    SimulatedFlow* flow = world->flow;
+    SimulatedWindowSystem& system = flow->GetSystem();
+    uint32_t roll = world->rng() % 1000;
+    WindowKey window = PickWindow(world);
+    const SimWindowSpec* spec = window != 0 ? system.GetSpec(window) : nullptr;
+    int monitorIndex = static_cast<int>(world->rng() % static_cast<uint32_t>(flow->GetMonitorCount()));
+
+    if (roll < 120 || spec == nullptr) {
+        if (world->windows.size() < MAX_OPEN_WINDOWS) {
+            SimWindowSpec opened;
+            uint32_t kind = world->rng() % 20;
+            opened.focusPolicy = kind < 16 ? SimFocusPolicy::Accept
+                               : kind < 19 ? SimFocusPolicy::NeedsAttach
+                                           : SimFocusPolicy::NeedsBringToTop;
+            WindowKey created = flow->OpenWindow(monitorIndex, opened);
+            world->windows.push_back(created);
+            flow->Click(created);  // New windows usually take the foreground
+        }
+    } else if (roll < 220) {
+        flow->CloseWindow(window);
+        Forget(world, window);
+    } else if (roll < 230) {
+        // Gone without a destroy event: left for a press to find out
+        system.DestroyWindow(window);
+        Forget(world, window);
+    } else if (roll < 530) {
+        if (!spec->hung && IsWindowStateActivatable(spec->state & ~WINDOW_STATE_CLOAKED)) {
+            flow->Click(window);
+        }
+    } else if (roll < 610) {
+        bool minimized = (spec->state & WINDOW_STATE_MINIMIZED) != 0;
+        flow->SetWindowState(window, minimized ? WINDOW_STATE_VISIBLE : WINDOW_STATE_VISIBLE | WINDOW_STATE_MINIMIZED);
+    } else if (roll < 630) {
+        if (spec->hung) {
+            flow->SetHung(window, false);
+        } else if (window != system.GetForeground() && CountHung(world) < MAX_HUNG_WINDOWS) {
+            flow->SetHung(window, true);
+        }
+    } else if (roll < 670) {
+        flow->MoveWindow(window, monitorIndex);
+    } else if (roll < 700) {
+        SwitchDesktop(world, world->desktops[world->rng() % world->desktops.size()]);
+    } else if (roll < 703) {
+        flow->MoveWindowToDesktop(window, world->desktops[world->rng() % world->desktops.size()]);
+    } else {
+        FlowPress press = flow->Press(monitorIndex);
+        world->pressMs += press.latencyMs;
+        ++world->presses;
+    }
+}
+
+// A laptop's day: docked to every monitor in the morning, on its own screen
+// for the evening; a desktop is closed and a new one made every other day
+static void RunDailyEvents(SoakWorld* world, int day, int operation) {
+    if (operation == 0) {
+        world->flow->SetMonitorCount(MAX_MONITORS);
+        if (day % 2 == 1) {
+            ReplaceDesktop(world);
+        }
+    } else if (operation == OPERATIONS_PER_DAY * 2 / 3) {
+        world->flow->SetMonitorCount(1);
+    }
+}
+
+// Sizes peak between samples (caches that clear themselves would alias
+// otherwise), so they are tracked after every operation
+static void TrackPeaks(SoakWorld* world, double* values) {
+    const SimulatedFlow& flow = *world->flow;
+    double sizes[METRIC_COUNT] = {};
+    sizes[METRIC_LIVE_ALLOCS] = static_cast<double>(BenchGetLiveAllocCount());
+    sizes[METRIC_TRACKED] = static_cast<double>(flow.GetMonitors().GetTrackedCount());
+    sizes[METRIC_DESKTOP_ROWS] = static_cast<double>(flow.GetMonitors().GetDesktopCount());
+    sizes[METRIC_RESPONSIVENESS] = static_cast<double>(flow.GetResponsiveness().GetSize());
+    sizes[METRIC_STRATEGIES] = static_cast<double>(flow.GetStrategies().GetSize());
+    sizes[METRIC_APP_KEYS] = static_cast<double>(flow.GetAppKeys().GetSize());
+    sizes[METRIC_TITLES] = static_cast<double>(flow.GetMonitors().GetCachedTitleCount());
+    sizes[METRIC_TIMERS] = static_cast<double>(world->flow->GetSystem().GetPendingCount());
+    for (int metric = METRIC_LIVE_ALLOCS; metric <= METRIC_TIMERS; ++metric) {
+        values[metric] = std::max(values[metric], sizes[metric]);
+    }
+}
+
+static double Peak(const std::vector<double>& samples, size_t begin, size_t end) {
+    return *std::max_element(samples.begin() + begin, samples.begin() + end);
+}
+
+static double Median(const std::vector<double>& samples, size_t begin, size_t end) {
+    std::vector<double> range(samples.begin() + begin, samples.begin() + end);
+    return BenchPercentile(range, 50.0);
+}
+
+void RunSoakBench() {
+    SimulatedFlow flow(MAX_MONITORS);
+    SoakWorld world = { &flow, std::mt19937(SOAK_SEED), {}, {}, 1, 0.0, 0 };
+    for (size_t i = 0; i < LIVE_DESKTOPS; ++i) {
+        world.desktops.push_back(world.nextDesktop++);
+    }
+    flow.SwitchDesktop(world.desktops[0]);
+
+    const int sampleCount = SOAK_DAYS / SAMPLE_DAYS;
+    const int operationsPerSample = OPERATIONS_PER_DAY * SAMPLE_DAYS;
+    std::vector<double> samples[METRIC_COUNT];
+
+    std::printf("%5s %10s %10s %8s %5s %6s %6s %6s %6s %7s %9s\n", "day", "rss_kb", "live_alloc", "tracked", "rows",
+                "resp", "strat", "apps", "titles", "ns/op", "press_ms");
+    BenchClock::time_point soakStart = BenchClock::now();
+    for (int sample = 0; sample < sampleCount; ++sample) {
+        world.pressMs = 0.0;
+        world.presses = 0;
+
+        double values[METRIC_COUNT] = {};
+        BenchClock::time_point start = BenchClock::now();
+        for (int op = 0; op < operationsPerSample; ++op) {
+            RunDailyEvents(&world, sample * SAMPLE_DAYS + op / OPERATIONS_PER_DAY, op % OPERATIONS_PER_DAY);
+            RunOperation(&world);
+            flow.GetSystem().Advance(std::chrono::milliseconds(world.rng() % OPERATION_SPACING_MS));
+            TrackPeaks(&world, values);
+        }
+        values[METRIC_NS_PER_OP] = BenchElapsedNs(start, BenchClock::now()) / operationsPerSample;
+        values[METRIC_PRESS_MS] = world.presses > 0 ? world.pressMs / world.presses : 0.0;
+        values[METRIC_RESIDENT_KB] = static_cast<double>(BenchGetResidentBytes()) / 1024.0;
+        for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+            samples[metric].push_back(values[metric]);
+        }
+        if ((sample + 1) % 3 == 0) {
+            std::printf("%5d %10.0f %10.0f %8.0f %5.0f %6.0f %6.0f %6.0f %6.0f %7.0f %9.1f\n",
+                        (sample + 1) * SAMPLE_DAYS, values[METRIC_RESIDENT_KB], values[METRIC_LIVE_ALLOCS],
+                        values[METRIC_TRACKED], values[METRIC_DESKTOP_ROWS], values[METRIC_RESPONSIVENESS],
+                        values[METRIC_STRATEGIES], values[METRIC_APP_KEYS], values[METRIC_TITLES],
+                        values[METRIC_NS_PER_OP], values[METRIC_PRESS_MS]);
+        }
+    }
+    double soakSeconds = BenchElapsedNs(soakStart, BenchClock::now()) / 1e9;
+    std::printf("%d simulated days in %.1f s\n", SOAK_DAYS, soakSeconds);
+
+    // First quarter is warm-up; the rest is split in halves and compared
+    size_t warm = samples[0].size() / 4;
+    size_t middle = warm + (samples[0].size() - warm) / 2;
+    size_t end = samples[0].size();
+    bool ok = true;
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        const std::vector<double>& series = samples[metric];
+        double early;
+        double late;
+        double limit;
+        if (g_metrics[metric].latency) {
+            early = Median(series, warm, middle);
+            late = Median(series, middle, end);
+            limit = early * (1.0 + SLOWDOWN_TOLERANCE) + (metric == METRIC_PRESS_MS ? PRESS_SLACK_MS : 0.0);
+        } else {
+            early = Peak(series, warm, middle);
+            late = Peak(series, middle, end);
+            limit = early * (1.0 + SIZE_TOLERANCE) + (metric == METRIC_RESIDENT_KB ? RESIDENT_SLACK_BYTES / 1024.0 : 1.0);
+        }
+
+        bool flat = late <= limit;
+        if (!flat) {
+            std::printf("%s grew: %.1f -> %.1f (limit %.1f)\n", g_metrics[metric].name, early, late, limit);
+        }
+        BenchReport("soak", g_metrics[metric].name, "early", early);
+        BenchReport("soak", g_metrics[metric].name, "late", late);
+        ok = ok && flat;
+    }
+
+    BenchReport("soak", "run", "seconds", soakSeconds);
+    std::printf("checks: %s\n", ok ? "ok" : "FAILED");
+    BenchReport("soak", "checks", "ok", ok ? 1.0 : 0.0);
+}
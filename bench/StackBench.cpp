@@ -0,0 +1,257 @@
+#include <mutex>
+#include <random>
+#include "Bench.h"
+#include "FocusStackEngine.h"
+#include "WindowCandidate.h"
+
+// Focus stack hot paths as MonitorManager runs them (same engine shape, one
+// uncontended mutex per call) on synthetic desktops of 2-32 monitors and
+// 100-50,000 live windows:
+//
+//   focus     OnWindowFocused: promote, 80% of focus from a small working set
+//   top       GetLastFocusedWindow
+//   remove    RemoveWindowFromStack on tracked windows
+//   destroy   RemoveWindowFromAllStacks for destroy events of any live window
+//   mixed     75% destroy / 20% focus / 5% top, the rough hook event mix
+//   fallback  TryFindWindowOnMonitor candidate scan (first hit / no hit)
+//   seed      startup z-order inventory bucketing (one pass over the z-order)
+
+static const int ENGINE_MONITORS = 32;  // MonitorManager::MAX_MONITORS
+static const size_t ENGINE_STACK = 10;  // MonitorManager::MAX_STACK_SIZE
+static const int OPS = 500000;
+
+struct Desktop {
+    int monitorCount;
+    MonitorLayout layout;
+    std::vector<WindowKey> windows;
+    std::vector<int> homeMonitor;
+    std::vector<WindowCandidate> zOrder;  // Same windows, topmost first
+};
+
+static void BuildDesktop(Desktop& desktop, int monitorCount, int windowCount, std::mt19937& rng) {
+    desktop.monitorCount = monitorCount;
+    desktop.layout.Clear();
+    for (int i = 0; i < monitorCount; ++i) {
+        MonitorRect bounds = { i * 1920, 0, (i + 1) * 1920, 1080 };
+        desktop.layout.Add(bounds, bounds, i == 0);
+    }
+
+    std::uniform_int_distribution<int> percent(0, 99);
+    desktop.windows.resize(windowCount);
+    desktop.homeMonitor.resize(windowCount);
+    desktop.zOrder.resize(windowCount);
+
+    for (int i = 0; i < windowCount; ++i) {
+        // HWND-like values: sparse and aligned
+        WindowKey key = static_cast<WindowKey>(0x10000 + static_cast<uint64_t>(i) * 0x18);
+        int monitor = i % monitorCount;
+        desktop.windows[i] = key;
+        desktop.homeMonitor[i] = monitor;
+
+        // Most top-level windows are hidden or untitled helpers
+        WindowCandidate& candidate = desktop.zOrder[i];
+        candidate.window = key;
+        candidate.rect.left = monitor * 1920 + 100;
+        candidate.rect.top = 100;
+        candidate.rect.right = monitor * 1920 + 1300;
+        candidate.rect.bottom = 900;
+        candidate.visible = percent(rng) < 30;
+        candidate.minimized = candidate.visible && percent(rng) < 20;
+        candidate.hasTitle = percent(rng) < 60;
+        candidate.toolWindow = percent(rng) < 15;
+    }
+
+    std::shuffle(desktop.zOrder.begin(), desktop.zOrder.end(), rng);
+}
+
+// Window indices for focus events: 80% from a working set, 20% anywhere
+static std::vector<int> MakeFocusSequence(const Desktop& desktop, int count, std::mt19937& rng) {
+    int windowCount = static_cast<int>(desktop.windows.size());
+    int workingSet = std::min(windowCount, desktop.monitorCount * 20);
+    std::uniform_int_distribution<int> hot(0, workingSet - 1);
+    std::uniform_int_distribution<int> any(0, windowCount - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<int> sequence(count);
+    for (int i = 0; i < count; ++i) {
+        sequence[i] = percent(rng) < 80 ? hot(rng) : any(rng);
+    }
+    return sequence;
+}
+
+struct OpResult {
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+template <typename Fn>
+static OpResult Measure(int ops, Fn&& fn) {
+    uint64_t allocsBefore = BenchGetAllocCount();
+    BenchClock::time_point start = BenchClock::now();
+    fn();
+    double elapsed = BenchElapsedNs(start, BenchClock::now());
+    uint64_t allocs = BenchGetAllocCount() - allocsBefore;
+
+    OpResult result;
+    result.nsPerOp = elapsed / ops;
+    result.allocsPerOp = static_cast<double>(allocs) / ops;
+    return result;
+}
+
+static void Fill(FocusStackEngine& engine, const Desktop& desktop, const std::vector<int>& focus) {
+    for (int index : focus) {
+        engine.Promote(desktop.windows[index], desktop.homeMonitor[index]);
+    }
+}
+
+static void RunWorkload(int monitorCount, int windowCount) {
+    std::mt19937 rng(1234);
+    Desktop desktop;
+    BuildDesktop(desktop, monitorCount, windowCount, rng);
+
+    FocusStackEngine engine(ENGINE_MONITORS, ENGINE_STACK);
+    std::mutex mutex;
+    std::vector<int> focus = MakeFocusSequence(desktop, OPS, rng);
+    Fill(engine, desktop, focus);
+
+    std::uniform_int_distribution<int> anyWindow(0, windowCount - 1);
+    std::uniform_int_distribution<int> anyMonitor(0, monitorCount - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<int> windowSequence(OPS);
+    std::vector<int> monitorSequence(OPS);
+    std::vector<int> mixSequence(OPS);
+    for (int i = 0; i < OPS; ++i) {
+        windowSequence[i] = anyWindow(rng);
+        monitorSequence[i] = anyMonitor(rng);
+        mixSequence[i] = percent(rng);
+    }
+
+    WindowKey sink = 0;
+    OpResult results[8];
+
+    results[0] = Measure(OPS, [&]() {
+        for (int index : focus) {
+            std::lock_guard<std::mutex> lock(mutex);
+            engine.Promote(desktop.windows[index], desktop.homeMonitor[index]);
+        }
+    });
+
+    results[1] = Measure(OPS, [&]() {
+        for (int monitor : monitorSequence) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sink += engine.GetTop(monitor);
+        }
+    });
+
+    // Remove every tracked window, restore untimed, repeat
+    {
+        int removed = 0;
+        double elapsed = 0.0;
+        uint64_t allocs = 0;
+        std::vector<std::pair<int, WindowKey>> tracked;
+        while (removed < OPS) {
+            tracked.clear();
+            for (int monitor = 0; monitor < monitorCount; ++monitor) {
+                engine.ForEachInStack(monitor, [&](WindowKey window) { tracked.push_back(std::make_pair(monitor, window)); });
+            }
+
+            uint64_t allocsBefore = BenchGetAllocCount();
+            BenchClock::time_point start = BenchClock::now();
+            for (const std::pair<int, WindowKey>& entry : tracked) {
+                std::lock_guard<std::mutex> lock(mutex);
+                engine.RemoveFromMonitor(entry.first, entry.second);
+            }
+            elapsed += BenchElapsedNs(start, BenchClock::now());
+            allocs += BenchGetAllocCount() - allocsBefore;
+
+            // Put them back, oldest first, so the stacks look the same again
+            removed += static_cast<int>(tracked.size());
+            for (size_t i = tracked.size(); i-- > 0;) {
+                engine.Promote(tracked[i].second, tracked[i].first);
+            }
+        }
+        results[2].nsPerOp = elapsed / removed;
+        results[2].allocsPerOp = static_cast<double>(allocs) / removed;
+    }
+
+    results[3] = Measure(OPS, [&]() {
+        for (int index : windowSequence) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (engine.Contains(desktop.windows[index])) {
+                engine.Remove(desktop.windows[index]);
+            }
+        }
+    });
+    Fill(engine, desktop, focus);
+
+    results[4] = Measure(OPS, [&]() {
+        for (int i = 0; i < OPS; ++i) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (mixSequence[i] < 75) {
+                WindowKey window = desktop.windows[windowSequence[i]];
+                if (engine.Contains(window)) {
+                    engine.Remove(window);
+                }
+            } else if (mixSequence[i] < 95) {
+                engine.Promote(desktop.windows[focus[i]], desktop.homeMonitor[focus[i]]);
+            } else {
+                sink += engine.GetTop(monitorSequence[i]);
+            }
+        }
+    });
+
+    // Fallback scans walk the z-order; fewer of them on big desktops
+    int scans = std::max(200, 20000000 / windowCount / 10);
+    results[5] = Measure(scans, [&]() {
+        for (int i = 0; i < scans; ++i) {
+            sink += FindFallbackWindow(desktop.zOrder.data(), desktop.zOrder.size(), desktop.layout,
+                                       monitorSequence[i % OPS]);
+        }
+    });
+    results[6] = Measure(scans, [&]() {
+        for (int i = 0; i < scans; ++i) {
+            // Index with no monitor: nothing matches, the whole z-order is scanned
+            sink += FindFallbackWindow(desktop.zOrder.data(), desktop.zOrder.size(), desktop.layout, monitorCount);
+        }
+    });
+
+    // Warm-up pass sizes the buckets; later passes reuse them
+    std::vector<std::vector<WindowKey>> buckets;
+    BucketByZOrder(desktop.zOrder.data(), desktop.zOrder.size(), desktop.layout, ENGINE_STACK, &buckets);
+    results[7] = Measure(scans, [&]() {
+        for (int i = 0; i < scans; ++i) {
+            sink += BucketByZOrder(desktop.zOrder.data(), desktop.zOrder.size(), desktop.layout, ENGINE_STACK, &buckets);
+        }
+    });
+
+    BenchDoNotOptimize(sink);
+
+    static const char* names[8] = { "focus", "top", "remove", "destroy", "mixed", "fallback_hit", "fallback_scan", "seed" };
+    double maxAllocs = 0.0;
+    std::printf("%2d mon %6d win:", monitorCount, windowCount);
+    for (int i = 0; i < 8; ++i) {
+        std::printf(" %8.1f", results[i].nsPerOp);
+        maxAllocs = std::max(maxAllocs, results[i].allocsPerOp);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "m%d_w%d_%s", monitorCount, windowCount, names[i]);
+        BenchReport("stacks", name, "ns_per_op", results[i].nsPerOp);
+        BenchReport("stacks", name, "allocs_per_op", results[i].allocsPerOp);
+    }
+    std::printf("  %6.3f\n", maxAllocs);
+}
+
+void RunStackBench() {
+    std::printf("ns/op                 %8s %8s %8s %8s %8s %8s %8s %8s  allocs/op(max)\n",
+                "focus", "top", "remove", "destroy", "mixed", "fb-hit", "fb-scan", "seed");
+
+    const int monitorCounts[] = { 2, 4, 8, 16, 32 };
+    const int windowCounts[] = { 100, 1000, 10000, 50000 };
+
+    for (int monitorCount : monitorCounts) {
+        for (int windowCount : windowCounts) {
+            RunWorkload(monitorCount, windowCount);
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#include <cstdio>
+#include <string>
+#include "AppKeyCache.h"
+#include "Bench.h"
+#include "StrategyTable.h"
+
+// Learned activation strategies: presses against simulated apps whose
+// strategies succeed or time out, comparing the default escalation order
+// with the learned one. Cost of a press = deadlines of the strategies that
+// failed + latency of the one that worked. Also checks persistence, decay
+// and relearning after an app changes behaviour, and that the per-window app
+// key cache keeps windows in use while short-lived ones churn through it.
+
+static const int PRESSES = 200;
+static const double ATTEMPT_TIMEOUT_US = 150000.0;  // ActivationSequencer::ATTEMPT_TIMEOUT_MS
+static const uint64_t START_TIME = 1700000000;
+
+struct SimulatedApp {
+    const char* name;
+    double latencyUs[STRATEGY_COUNT];  // < 0: never works for this app
+};
+
+static const SimulatedApp g_apps[] = {
+    { "direct-works", { 2000.0, 3000.0, 8000.0 } },
+    { "needs-attach", { -1.0, 5000.0, 9000.0 } },
+    { "needs-bring-to-top", { -1.0, -1.0, 8000.0 } },
+};
+
+// One press: walks the order like ActivationPipeline::TryStrategy and feeds the table
+static double Press(StrategyTable* table, uint64_t appKey, const SimulatedApp& app, uint64_t now, bool learn) {
+    ActivationStrategy order[STRATEGY_COUNT];
+    if (learn) {
+        table->GetOrder(appKey, now, order);
+    } else {
+        for (int i = 0; i < STRATEGY_COUNT; ++i) {
+            order[i] = static_cast<ActivationStrategy>(i);
+        }
+    }
+
+    double cost = 0.0;
+    for (int i = 0; i < STRATEGY_COUNT; ++i) {
+        double latency = app.latencyUs[static_cast<int>(order[i])];
+        bool success = latency >= 0.0;
+        if (learn) {
+            table->Record(appKey, order[i], success, success ? latency : ATTEMPT_TIMEOUT_US, now);
+        }
+        if (success) {
+            return cost + latency;
+        }
+        cost += ATTEMPT_TIMEOUT_US;
+    }
+    return cost;
+}
+
+void RunStrategyBench() {
+    StrategyTable table;
+    bool ok = true;
+
+    for (size_t a = 0; a < sizeof(g_apps) / sizeof(g_apps[0]); ++a) {
+        const SimulatedApp& app = g_apps[a];
+        uint64_t appKey = StrategyTable::MakeAppKey(0x1000 + a, static_cast<uint32_t>(a));
+
+        double fixedUs = 0.0;
+        double learnedUs = 0.0;
+        for (int press = 0; press < PRESSES; ++press) {
+            uint64_t now = START_TIME + static_cast<uint64_t>(press) * 60;  // A press a minute
+            fixedUs += Press(&table, appKey, app, now, false);
+            learnedUs += Press(&table, appKey, app, now, true);
+        }
+
+        std::printf("%-20s fixed order: %7.1f ms/press, learned: %6.1f ms/press (starts with %s)\n", app.name,
+                    fixedUs / PRESSES / 1000.0, learnedUs / PRESSES / 1000.0,
+                    GetActivationStrategyName(table.GetPreferred(appKey, START_TIME + PRESSES * 60)));
+        BenchReport("strategy", std::string(app.name) + "/fixed", "ms_per_press", fixedUs / PRESSES / 1000.0);
+        BenchReport("strategy", std::string(app.name) + "/learned", "ms_per_press", learnedUs / PRESSES / 1000.0);
+        ok = ok && learnedUs <= fixedUs;
+    }
+
+    // An app whose update broke the learned strategy: presses until the table moves on
+    uint64_t changingKey = StrategyTable::MakeAppKey(0x2000, 7);
+    SimulatedApp before = { "changing", { -1.0, 4000.0, 9000.0 } };
+    SimulatedApp after = { "changing", { 3000.0, -1.0, 9000.0 } };
+    uint64_t now = START_TIME;
+    for (int press = 0; press < PRESSES; ++press, now += 60) {
+        Press(&table, changingKey, before, now, true);
+    }
+    int relearnPresses = 0;
+    while (table.GetPreferred(changingKey, now) != ActivationStrategy::Direct && relearnPresses < PRESSES) {
+        Press(&table, changingKey, after, now, true);
+        ++relearnPresses;
+        now += 60;
+    }
+    std::printf("relearned after a behaviour change in %d press(es)\n", relearnPresses);
+    BenchReport("strategy", "relearn", "presses", relearnPresses);
+    ok = ok && relearnPresses < 10;
+
+    // Order lookup cost on the press path
+    ActivationStrategy order[STRATEGY_COUNT];
+    uint64_t lookupKey = StrategyTable::MakeAppKey(0x1001, 1);
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < 1000000; ++i) {
+        table.GetOrder(lookupKey, now, order);
+        BenchDoNotOptimize(order);
+    }
+    double orderNs = BenchElapsedNs(start, BenchClock::now()) / 1000000;
+    std::printf("GetOrder: %.1f ns\n", orderNs);
+    BenchReport("strategy", "get_order", "ns_per_op", orderNs);
+
+    // Survives a restart; forgotten once it is old enough
+    std::string path = "true-recall-bench.strategies";
+    std::remove(path.c_str());
+    StrategyTable saved;
+    saved.Open(path);
+    for (int press = 0; press < 20; ++press) {
+        Press(&saved, lookupKey, g_apps[1], START_TIME + press, true);
+    }
+    bool savedOk = saved.Save();
+    saved.Close();
+
+    StrategyTable loaded;
+    bool loadedOk = loaded.Open(path) && loaded.GetSize() == 1 &&
+                    loaded.GetPreferred(lookupKey, START_TIME + 60) == ActivationStrategy::AttachThreadInput;
+    bool decayedOk = loaded.GetPreferred(lookupKey, START_TIME + 30 * 24 * 3600) == ActivationStrategy::Direct;
+    loaded.Close();
+    std::remove(path.c_str());
+
+    ok = ok && savedOk && loadedOk && decayedOk;
+    std::printf("persistence and decay: %s\n", ok ? "ok" : "FAILED");
+
+    // A window pressed now and then survives thousands of one-off windows;
+    // a recycled handle (new process id) misses
+    AppKeyCache appKeys;
+    uint64_t appKey = 0;
+    appKeys.Store(0x10, 7, lookupKey);
+    bool hotKept = true;
+    for (WindowKey window = 0x100; window < 0x100 + 8 * AppKeyCache::MAX_ENTRIES; ++window) {
+        appKeys.Store(window, 1, 1);
+        if (window % 256 == 0) {
+            hotKept = hotKept && appKeys.Lookup(0x10, 7, &appKey) && appKey == lookupKey;
+        }
+    }
+    bool cacheOk = hotKept && appKeys.GetSize() == AppKeyCache::MAX_ENTRIES && !appKeys.Lookup(0x10, 8, &appKey);
+    std::printf("app key cache: %s (%zu entries)\n", cacheOk ? "ok" : "FAILED", appKeys.GetSize());
+    ok = ok && cacheOk;
+    BenchReport("strategy", "checks", "ok", ok ? 1.0 : 0.0);
+}
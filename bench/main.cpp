@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <cstring>
+#include "Bench.h"
+#include "BenchSupport.h"
+
+struct BenchSuite {
+    const char* name;
+    void (*run)();
+};
+
+static const BenchSuite g_suites[] = {
+    { "queue", RunQueueBench },
+    { "log", RunLogBench },
+    { "geometry", RunGeometryBench },
+    { "eventloop", RunEventLoopBench },
+    { "histogram", RunHistogramBench },
+    { "replay", RunReplayBench },
+    { "stacks", RunStackBench },
+    { "registry", RunRegistryBench },
+    { "desktops", RunDesktopBench },
+    { "snapshot", RunSnapshotBench },
+    { "focusstate", RunFocusStateBench },
+    { "command", RunCommandBench },
+    { "strategy", RunStrategyBench },
+    { "flow", RunFlowBench },
+    { "soak", RunSoakBench },
+};
+
+int main(int argc, char** argv) {
+    // Usage: true-recall-bench [--json <file>] [suite...]
+    const char* jsonPath = nullptr;
+    std::vector<const char*> selectedNames;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            selectedNames.push_back(argv[i]);
+        }
+    }
+
+    // No suite names: run every suite. Otherwise run only the named ones.
+    bool ranAny = false;
+
+    for (const BenchSuite& suite : g_suites) {
+        bool selected = selectedNames.empty();
+        for (const char* name : selectedNames) {
+            if (std::strcmp(name, suite.name) == 0) {
+                selected = true;
+            }
+        }
+
+        if (selected) {
+            std::printf("== %s ==\n", suite.name);
+            suite.run();
+            std::printf("\n");
+            ranAny = true;
+        }
+    }
+
+    if (!ranAny) {
+        std::fprintf(stderr, "Unknown suite. Available:");
+        for (const BenchSuite& suite : g_suites) {
+            std::fprintf(stderr, " %s", suite.name);
+        }
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+
+    if (jsonPath != nullptr) {
+        if (!BenchWriteJson(jsonPath)) {
+            std::fprintf(stderr, "Failed to write %s\n", jsonPath);
+            return 1;
+        }
+        std::printf("Wrote %zu result(s) to %s\n", BenchGetResults().size(), jsonPath);
+    }
+
+    // Suites that verify behaviour report it as "checks"; any failure fails the run
+    int failed = 0;
+    for (const BenchResult& result : BenchGetResults()) {
+        if (result.name == "checks" && result.value == 0.0) {
+            std::fprintf(stderr, "Checks failed: %s\n", result.suite.c_str());
+            ++failed;
+        }
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+#include "ActivationPipeline.h"
+#include <algorithm>
+#include "FocusSnapshotter.h"
+#include "Logger.h"
+#include "MonitorManager.h"
+
+static HWND ToHwnd(WindowKey window) {
+    return reinterpret_cast<HWND>(window);
+}
+
+ActivationPipeline::ActivationPipeline(MonitorManager* monitorManager, WindowSystem* windowSystem,
+                                       ActivationStats* stats)
+    : m_monitorManager(monitorManager)
+    , m_windowSystem(windowSystem)
+    , m_sequencer(windowSystem, this, stats, &m_strategyTable, &m_prober.GetCache())
+    , m_deadlineTimer(-1)
+    , m_saveTimer(-1)
+    , m_requestSignal(-1)
+    , m_foregroundSignal(-1)
+    , m_hasRequest(false)
+{
+}
+
+ActivationPipeline::~ActivationPipeline() {
+    Stop();
+}
+
+bool ActivationPipeline::EnableStrategyPersistence(const std::string& path) {
+    if (m_worker.joinable()) {
+        TR_LOG_ERROR("Strategy persistence must be enabled before the activation pipeline starts");
+        return false;
+    }
+
+    if (!m_strategyTable.Open(path)) {
+        TR_LOG_WARN("Could not open learned strategies {}", path);
+        return false;
+    }
+    TR_LOG_DEBUG("Loaded learned activation strategies for {} app(s)", m_strategyTable.GetSize());
+    return true;
+}
+
+bool ActivationPipeline::Start() {
+    if (m_worker.joinable()) {
+        TR_LOG_ERROR("ActivationPipeline already started");
+        return false;
+    }
+
+    m_loop.reset(new EventLoop());
+    if (!m_loop->IsValid()) {
+        TR_LOG_ERROR("Failed to create activation worker event loop");
+        m_loop.reset();
+        return false;
+    }
+
+    if (!m_prober.Start()) {
+        TR_LOG_WARN("Warning: Failed to start responsiveness prober");
+        // Continue anyway; hung windows are still caught by IsHungAppWindow
+    }
+
+    m_requestSignal = m_loop->AddSignal([this]() { HandleRequest(); });
+    m_foregroundSignal = m_loop->AddSignal([this]() { m_sequencer.HandleForeground(); });
+    m_worker = std::thread([this]() { m_loop->Run(); });
+    return true;
+}
+
+void ActivationPipeline::Stop() {
+    if (m_worker.joinable()) {
+        m_loop->RequestStop();
+        m_worker.join();
+    }
+    m_loop.reset();
+    m_prober.Stop();
+
+    m_sequencer.Reset();
+    m_deadlineTimer = -1;
+    m_saveTimer = -1;
+
+    // The worker is gone: whatever it learned since the last save is written now
+    m_strategyTable.Save();
+}
+
+void ActivationPipeline::Request(int monitorIndex, ActivationStats::Clock::time_point hotkeyTime) {
+    if (!m_loop) {
+        return;
+    }
+
+    {
+        // Overwrites a request the worker has not picked up yet: latest press wins
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_request.monitorIndex = monitorIndex;
+        m_request.hotkeyTime = hotkeyTime;
+        m_hasRequest = true;
+    }
+
+    m_loop->Notify(m_requestSignal);
+}
+
+void ActivationPipeline::OnForeground(WindowKey window) {
+    if (m_sequencer.NotifyForeground(window)) {
+        m_loop->Notify(m_foregroundSignal);
+    }
+}
+
+void ActivationPipeline::HandleRequest() {
+    PendingRequest request;
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        if (!m_hasRequest) {
+            return;
+        }
+        request = m_request;
+        m_hasRequest = false;
+    }
+
+    m_sequencer.Start(request.monitorIndex, request.hotkeyTime);
+}
+
+WindowKey ActivationPipeline::GetReadyTarget(int monitorIndex, WindowHandle* handle) {
+    return m_monitorManager->GetReadyTarget(monitorIndex, handle);
+}
+
+void ActivationPipeline::CopyFocusStack(int monitorIndex, std::vector<WindowKey>* stack,
+                                        std::vector<WindowHandle>* handles) {
+    m_monitorManager->CopyFocusStack(monitorIndex, stack, handles);
+}
+
+bool ActivationPipeline::IsWindowAlive(WindowHandle handle) {
+    return m_monitorManager->IsWindowAlive(handle);
+}
+
+uint32_t ActivationPipeline::GetWindowState(WindowHandle handle) {
+    return m_monitorManager->GetWindowState(handle);
+}
+
+void ActivationPipeline::RemoveWindowFromStack(int monitorIndex, WindowKey window) {
+    m_monitorManager->RemoveWindowFromStack(monitorIndex, window);
+}
+
+void ActivationPipeline::TryFindWindowOnMonitor(int monitorIndex) {
+    TR_LOG_DEBUG("  No valid windows found on Monitor {}", monitorIndex);
+    m_monitorManager->TryFindWindowOnMonitor(monitorIndex);
+}
+
+uint64_t ActivationPipeline::GetAppKey(WindowKey window) {
+    // The process id is cheap to read and catches a recycled handle
+    uint32_t processId = 0;
+    m_windowSystem->GetWindowThread(window, &processId);
+
+    uint64_t appKey;
+    if (m_appKeys.Lookup(window, processId, &appKey)) {
+        return appKey;
+    }
+
+    HWND hwnd = ToHwnd(window);
+    appKey = StrategyTable::MakeAppKey(HashProcessImage(hwnd), HashWindowClass(hwnd));
+    m_appKeys.Store(window, processId, appKey);
+    return appKey;
+}
+
+uint64_t ActivationPipeline::GetUnixSeconds() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void ActivationPipeline::ArmDeadline(int delayMs) {
+    m_deadlineTimer = m_loop->AddTimer(std::chrono::milliseconds(delayMs), false, [this]() {
+        m_deadlineTimer = -1;
+        m_sequencer.HandleDeadline();
+    });
+}
+
+void ActivationPipeline::CancelDeadline() {
+    if (m_deadlineTimer >= 0) {
+        m_loop->CancelTimer(m_deadlineTimer);
+        m_deadlineTimer = -1;
+    }
+}
+
+void ActivationPipeline::ProbeSoon(WindowKey window) {
+    m_prober.ProbeSoon(std::vector<HWND>(1, ToHwnd(window)));
+}
+
+void ActivationPipeline::OnStrategyLearned() {
+    // Batched: a burst of presses costs one write
+    if (m_saveTimer < 0) {
+        m_saveTimer = m_loop->AddTimer(std::chrono::milliseconds(STRATEGY_SAVE_DELAY_MS), false, [this]() {
+            m_saveTimer = -1;
+            m_strategyTable.Save();
+        });
+    }
+}
+
+void ActivationPipeline::OnFinished() {
+    ProbeLikelyTargets();
+}
+
+void ActivationPipeline::ProbeLikelyTargets() {
+    // The next press will try the tops of the stacks; have answers ready
+    std::vector<HWND> targets;
+    for (int monitorIndex = 0; monitorIndex < m_monitorManager->GetMonitorCount(); ++monitorIndex) {
+        m_monitorManager->CopyFocusStack(monitorIndex, &m_stackCopy);
+        size_t count = std::min(m_stackCopy.size(), ActivationSequencer::MAX_CANDIDATES);
+        for (size_t i = 0; i < count; ++i) {
+            targets.push_back(ToHwnd(m_stackCopy[i]));
+        }
+    }
+    m_prober.ProbeSoon(targets);
+}
+
+void ActivationPipeline::OnActivationEvent(ActivationEvent event, WindowKey window, ActivationStrategy strategy) {
+    HWND hwnd = ToHwnd(window);
+    switch (event) {
+        case ActivationEvent::Superseded:
+            TR_LOG_DEBUG("  Activation of {} superseded by a newer press", hwnd);
+            break;
+        case ActivationEvent::SkippedGone:
+            TR_LOG_DEBUG("  Skipping window {}, no longer tracked", hwnd);
+            break;
+        case ActivationEvent::SkippedHidden:
+            TR_LOG_DEBUG("  Skipping window {}, hidden, minimized or on another desktop", hwnd);
+            break;
+        case ActivationEvent::SkippedHung:
+            TR_LOG_DEBUG("  Skipping window {}, not responding", hwnd);
+            break;
+        case ActivationEvent::SkippedReadyHung:
+            TR_LOG_DEBUG("  Skipping ready window {}, not responding", hwnd);
+            break;
+        case ActivationEvent::LearnedOrder:
+            TR_LOG_DEBUG("  Starting with {} (learned for this app)", GetActivationStrategyName(strategy));
+            break;
+        case ActivationEvent::TargetGone:
+            TR_LOG_DEBUG("  Window {} is gone", hwnd);
+            break;
+        case ActivationEvent::StoppedResponding:
+            TR_LOG_DEBUG("  Window {} stopped responding during activation", hwnd);
+            break;
+        case ActivationEvent::CouldNotActivate:
+            TR_LOG_WARN("  Warning: Could not activate window {}", hwnd);
+            break;
+        case ActivationEvent::Activated:
+            TR_LOG_DEBUG("  Activated successfully ({})", GetActivationStrategyName(strategy));
+            break;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <windows.h>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ActivationSequencer.h"
+#include "ActivationStats.h"
+#include "AppKeyCache.h"
+#include "EventLoop.h"
+#include "ResponsivenessProber.h"
+#include "StrategyTable.h"
+#include "WindowSystem.h"
+
+class MonitorManager;
+
+// Runs an ActivationSequencer on a dedicated worker so a slow or hung target
+// never stalls the message loop, and hosts it: focus stacks from the
+// MonitorManager, deadlines on the worker's event loop, hung windows watched
+// by a ResponsivenessProber, learned strategies persisted, every step logged.
+//
+// Foreground events come from the focus worker through OnForeground(). Only
+// the latest press is pursued.
+class ActivationPipeline : public ActivationHost {
+public:
+    static const int STRATEGY_SAVE_DELAY_MS = 10000;  // Learned strategies are written this long after a change
+
+    ActivationPipeline(MonitorManager* monitorManager, WindowSystem* windowSystem, ActivationStats* stats);
+    ~ActivationPipeline();
+
+    bool EnableStrategyPersistence(const std::string& path);  // Before Start(); optional
+    bool Start();
+    void Stop();
+
+    // Hotkey thread: activate the most recent usable window on a monitor
+    void Request(int monitorIndex, ActivationStats::Clock::time_point hotkeyTime);
+
+    // Focus worker, once per foreground change; one atomic load when idle
+    void OnForeground(WindowKey window);
+
+    // ActivationHost, worker only
+    WindowKey GetReadyTarget(int monitorIndex, WindowHandle* handle) override;
+    void CopyFocusStack(int monitorIndex, std::vector<WindowKey>* stack, std::vector<WindowHandle>* handles) override;
+    bool IsWindowAlive(WindowHandle handle) override;
+    uint32_t GetWindowState(WindowHandle handle) override;
+    void RemoveWindowFromStack(int monitorIndex, WindowKey window) override;
+    void TryFindWindowOnMonitor(int monitorIndex) override;
+    uint64_t GetAppKey(WindowKey window) override;
+    uint64_t GetUnixSeconds() override;
+    void ArmDeadline(int delayMs) override;
+    void CancelDeadline() override;
+    void ProbeSoon(WindowKey window) override;
+    void OnStrategyLearned() override;
+    void OnFinished() override;
+    void OnActivationEvent(ActivationEvent event, WindowKey window, ActivationStrategy strategy) override;
+
+private:
+    struct PendingRequest {
+        int monitorIndex;
+        ActivationStats::Clock::time_point hotkeyTime;
+    };
+
+    MonitorManager* m_monitorManager;
+    WindowSystem* m_windowSystem;
+    ResponsivenessProber m_prober;  // Checks likely targets between presses
+
+    // Worker-only
+    StrategyTable m_strategyTable;
+    ActivationSequencer m_sequencer;
+    AppKeyCache m_appKeys;
+    std::vector<WindowKey> m_stackCopy;
+    EventLoop::TimerId m_deadlineTimer;  // -1 if none
+    EventLoop::TimerId m_saveTimer;  // -1 if none
+
+    std::unique_ptr<EventLoop> m_loop;
+    std::thread m_worker;
+    EventLoop::SignalId m_requestSignal;
+    EventLoop::SignalId m_foregroundSignal;
+
+    // Hotkey thread -> worker; only the latest request is kept
+    PendingRequest m_request;
+    bool m_hasRequest;
+    std::mutex m_requestMutex;
+
+    void HandleRequest();
+    void ProbeLikelyTargets();
+};
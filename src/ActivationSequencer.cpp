@@ -0,0 +1,349 @@
+#include "ActivationSequencer.h"
+
+const int ActivationSequencer::ATTEMPT_TIMEOUT_MS;
+const size_t ActivationSequencer::MAX_CANDIDATES;
+const int ActivationSequencer::RESPONSIVENESS_MAX_AGE_MS;
+
+ActivationSequencer::ActivationSequencer(WindowSystem* windowSystem, ActivationHost* host, ActivationStats* stats,
+                                         StrategyTable* strategyTable, ResponsivenessCache* responsiveness)
+    : m_windowSystem(windowSystem)
+    , m_host(host)
+    , m_stats(stats)
+    , m_strategyTable(strategyTable)
+    , m_responsiveness(responsiveness)
+    , m_awaitedWindow(0)
+    , m_foregroundWindow(0)
+    , m_active(false)
+    , m_monitorIndex(-1)
+    , m_nextCandidate(0)
+    , m_readyTarget(0)
+    , m_stackCopied(false)
+    , m_targetSelected(false)
+    , m_target(0)
+    , m_targetHandle(0)
+    , m_appKey(0)
+    , m_attempt(0)
+    , m_deadlineArmed(false)
+{
+}
+
+void ActivationSequencer::Start(int monitorIndex, ActivationStats::Clock::time_point hotkeyTime) {
+    if (m_active) {
+        m_host->OnActivationEvent(ActivationEvent::Superseded, m_target, ActivationStrategy::Direct);
+        Finish();
+    }
+
+    m_active = true;
+    m_monitorIndex = monitorIndex;
+    m_hotkeyTime = hotkeyTime;
+    m_targetSelected = false;
+    m_nextCandidate = 0;
+
+    // Fast path: the focus worker already validated this monitor's target.
+    // The stack is only copied if that window turns out not to work.
+    m_candidates.clear();
+    m_candidateHandles.clear();
+    WindowHandle readyHandle = 0;
+    m_readyTarget = m_host->GetReadyTarget(m_monitorIndex, &readyHandle);
+    if (m_readyTarget != 0) {
+        m_candidates.push_back(m_readyTarget);
+        m_candidateHandles.push_back(readyHandle);
+        m_stackCopied = false;
+    } else {
+        CopyStackCandidates();
+    }
+    SelectNextCandidate();
+}
+
+void ActivationSequencer::Reset() {
+    m_awaitedWindow.store(0, std::memory_order_release);
+    m_foregroundWindow.store(0, std::memory_order_relaxed);
+    m_active = false;
+    m_deadlineArmed = false;
+    m_target = 0;
+    m_targetHandle = 0;
+}
+
+bool ActivationSequencer::NotifyForeground(WindowKey window) {
+    if (window == 0 || window != m_awaitedWindow.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    m_foregroundWindow.store(window, std::memory_order_release);
+    return true;
+}
+
+void ActivationSequencer::CopyStackCandidates() {
+    // One locked copy instead of a lock per candidate
+    m_host->CopyFocusStack(m_monitorIndex, &m_candidates, &m_candidateHandles);
+    m_nextCandidate = 0;
+    m_stackCopied = true;
+
+    // Already tried as the ready target
+    if (m_readyTarget != 0) {
+        size_t kept = 0;
+        for (size_t i = 0; i < m_candidates.size(); ++i) {
+            if (m_candidates[i] != m_readyTarget) {
+                m_candidates[kept] = m_candidates[i];
+                m_candidateHandles[kept] = m_candidateHandles[i];
+                ++kept;
+            }
+        }
+        m_candidates.resize(kept);
+        m_candidateHandles.resize(kept);
+    }
+}
+
+void ActivationSequencer::SelectNextCandidate() {
+    for (;;) {
+        if (m_nextCandidate >= m_candidates.size() || m_nextCandidate >= MAX_CANDIDATES) {
+            if (m_stackCopied) {
+                break;
+            }
+            CopyStackCandidates();  // The ready target did not work out
+            continue;
+        }
+
+        WindowKey window = m_candidates[m_nextCandidate];
+        WindowHandle handle = m_candidateHandles[m_nextCandidate];
+        ++m_nextCandidate;
+
+        // Left the stacks since the copy (e.g. destroyed): one compare, and a reused key is never activated
+        if (!m_host->IsWindowAlive(handle)) {
+            m_host->OnActivationEvent(ActivationEvent::SkippedGone, window, ActivationStrategy::Direct);
+            m_stats->OnCandidateSkipped();
+            continue;
+        }
+
+        // Cached state, no calls; hidden, minimized and cloaked windows keep their place
+        if (!IsWindowStateActivatable(m_host->GetWindowState(handle))) {
+            m_host->OnActivationEvent(ActivationEvent::SkippedHidden, window, ActivationStrategy::Direct);
+            m_stats->OnCandidateSkipped();
+            continue;
+        }
+
+        if (m_stackCopied) {
+            // Would only burn every deadline; keeps its place for when it recovers
+            if (IsHung(window)) {
+                m_host->OnActivationEvent(ActivationEvent::SkippedHung, window, ActivationStrategy::Direct);
+                m_stats->OnCandidateSkipped();
+                continue;
+            }
+        } else if (IsKnownHung(window)) {
+            // Ready target: validated by the focus worker, so only the prober's verdict is checked
+            m_host->OnActivationEvent(ActivationEvent::SkippedReadyHung, window, ActivationStrategy::Direct);
+            m_stats->OnCandidateSkipped();
+            continue;
+        }
+
+        ActivationStats::Clock::time_point now = m_windowSystem->Now();
+        if (!m_targetSelected) {
+            m_stats->RecordStage(ActivationStage::Select, m_hotkeyTime, now);
+            m_targetSelected = true;
+        }
+
+        m_target = window;
+        m_targetHandle = handle;
+        m_selectedTime = now;
+
+        // Armed before activating: the foreground event can beat the call's return
+        m_stats->ExpectForeground(window, m_hotkeyTime);
+        m_foregroundWindow.store(0, std::memory_order_relaxed);
+        m_awaitedWindow.store(window, std::memory_order_release);
+
+        if (m_windowSystem->GetForeground() == window) {
+            // No foreground event will come
+            m_stats->OnForeground(window, now);
+            m_stats->RecordStage(ActivationStage::Activate, now, now);
+            Finish();
+            return;
+        }
+
+        // Learned order for this app; Direct, AttachThreadInput, BringToTop if unknown
+        m_appKey = m_host->GetAppKey(window);
+        m_strategyTable->GetOrder(m_appKey, m_host->GetUnixSeconds(), m_order);
+        m_attempt = 0;
+        if (m_order[0] != ActivationStrategy::Direct) {
+            m_host->OnActivationEvent(ActivationEvent::LearnedOrder, window, m_order[0]);
+        }
+
+        TryStrategy();
+        return;
+    }
+
+    // Stack ran dry: try to find ANY visible window on this monitor
+    ActivationStats::Clock::time_point searchStart = m_windowSystem->Now();
+    m_host->TryFindWindowOnMonitor(m_monitorIndex);
+    m_stats->RecordStage(ActivationStage::FallbackSearch, searchStart, m_windowSystem->Now());
+    Finish();
+}
+
+void ActivationSequencer::TryStrategy() {
+    while (m_attempt < STRATEGY_COUNT) {
+        // Destroyed while an earlier strategy waited out its deadline: the key may name another window by now
+        if (!m_host->IsWindowAlive(m_targetHandle)) {
+            m_host->OnActivationEvent(ActivationEvent::TargetGone, m_target, ActivationStrategy::Direct);
+            m_stats->OnCandidateSkipped();
+            m_awaitedWindow.store(0, std::memory_order_release);
+            SelectNextCandidate();
+            return;
+        }
+
+        ActivationStrategy strategy = m_order[m_attempt];
+        m_strategyStart = m_windowSystem->Now();
+        bool issued = false;
+
+        switch (strategy) {
+            case ActivationStrategy::Direct:
+                issued = m_windowSystem->SetForeground(m_target);
+
+                // A ready target is only checked once it fails: it may have closed since
+                if (!issued && !m_windowSystem->IsWindow(m_target)) {
+                    m_host->OnActivationEvent(ActivationEvent::TargetGone, m_target, strategy);
+                    m_stats->RecordStrategy(strategy, m_strategyStart, m_windowSystem->Now(), false);
+                    m_stats->OnCandidateSkipped();
+                    m_host->RemoveWindowFromStack(m_monitorIndex, m_target);
+                    m_awaitedWindow.store(0, std::memory_order_release);
+                    SelectNextCandidate();
+                    return;
+                }
+                break;
+
+            case ActivationStrategy::AttachThreadInput: {
+                // Only useful across threads, and attaching to a hung queue can block
+                WindowKey currentForeground = m_windowSystem->GetForeground();
+                uint32_t foregroundThreadId =
+                    currentForeground != 0 ? m_windowSystem->GetWindowThread(currentForeground, nullptr) : 0;
+                uint32_t targetThreadId = m_windowSystem->GetWindowThread(m_target, nullptr);
+                if (foregroundThreadId == 0 || targetThreadId == 0 || foregroundThreadId == targetThreadId ||
+                    m_windowSystem->IsHung(currentForeground)) {
+                    ++m_attempt;
+                    continue;  // Not applicable, not counted
+                }
+
+                if (m_windowSystem->AttachInput(foregroundThreadId, targetThreadId, true)) {
+                    m_windowSystem->SetForeground(m_target);
+                    m_windowSystem->SetFocus(m_target);
+                    m_windowSystem->AttachInput(foregroundThreadId, targetThreadId, false);
+                    issued = true;
+                }
+                break;
+            }
+
+            case ActivationStrategy::BringToTop:
+                m_windowSystem->BringToTop(m_target);
+                m_windowSystem->SetFocus(m_target);
+                issued = true;
+                break;
+
+            default:
+                break;
+        }
+
+        if (!issued) {
+            ActivationStats::Clock::time_point now = m_windowSystem->Now();
+            m_stats->RecordStrategy(strategy, m_strategyStart, now, false);
+            LearnOutcome(strategy, false, now);
+            ++m_attempt;
+            continue;
+        }
+
+        // Confirmation is the foreground event; give up on this strategy after the deadline
+        m_deadlineArmed = true;
+        m_host->ArmDeadline(ATTEMPT_TIMEOUT_MS);
+        return;
+    }
+
+    // Every strategy timed out. A window that hung meanwhile keeps its place
+    // (the prober watches it); anything else is dropped. Then move down the stack.
+    m_stats->OnCandidateSkipped();
+    if (m_windowSystem->IsHung(m_target)) {
+        m_host->OnActivationEvent(ActivationEvent::StoppedResponding, m_target, ActivationStrategy::Direct);
+        MarkHung(m_target, m_windowSystem->Now());
+    } else {
+        m_host->OnActivationEvent(ActivationEvent::CouldNotActivate, m_target, ActivationStrategy::Direct);
+        m_host->RemoveWindowFromStack(m_monitorIndex, m_target);
+    }
+    m_awaitedWindow.store(0, std::memory_order_release);
+    SelectNextCandidate();
+}
+
+bool ActivationSequencer::IsHung(WindowKey window) {
+    ActivationStats::Clock::time_point now = m_windowSystem->Now();
+    Responsiveness state = m_responsiveness->Lookup(window, now, std::chrono::milliseconds(RESPONSIVENESS_MAX_AGE_MS));
+    if (state != Responsiveness::Unknown) {
+        return state == Responsiveness::Hung;
+    }
+
+    // Not probed recently: the flag check is cheap and never blocks
+    bool hung = m_windowSystem->IsHung(window);
+    if (hung) {
+        MarkHung(window, now);
+    }
+    return hung;
+}
+
+bool ActivationSequencer::IsKnownHung(WindowKey window) const {
+    // Cache only: no call on the fast path
+    Responsiveness state = m_responsiveness->Lookup(window, m_windowSystem->Now(),
+                                                    std::chrono::milliseconds(RESPONSIVENESS_MAX_AGE_MS));
+    return state == Responsiveness::Hung;
+}
+
+void ActivationSequencer::MarkHung(WindowKey window, ActivationStats::Clock::time_point now) {
+    m_responsiveness->Update(window, true, now);
+    m_host->ProbeSoon(window);  // Starts watching for recovery
+}
+
+void ActivationSequencer::HandleForeground() {
+    WindowKey window = m_foregroundWindow.exchange(0, std::memory_order_acq_rel);
+    if (!m_active || window == 0 || window != m_target) {
+        return;
+    }
+
+    ActivationStats::Clock::time_point now = m_windowSystem->Now();
+    m_responsiveness->Update(window, false, now);  // It just responded
+
+    ActivationStrategy strategy = m_order[m_attempt];
+    m_stats->RecordStrategy(strategy, m_strategyStart, now, true);
+    LearnOutcome(strategy, true, now);
+    m_stats->RecordStage(ActivationStage::Activate, m_selectedTime, now);
+    m_host->OnActivationEvent(ActivationEvent::Activated, window, strategy);
+    Finish();
+}
+
+void ActivationSequencer::HandleDeadline() {
+    m_deadlineArmed = false;
+    if (!m_active) {
+        return;
+    }
+
+    ActivationStrategy strategy = m_order[m_attempt];
+    ActivationStats::Clock::time_point now = m_windowSystem->Now();
+    m_stats->RecordStrategy(strategy, m_strategyStart, now, false);
+    LearnOutcome(strategy, false, now);
+    ++m_attempt;
+    TryStrategy();
+}
+
+void ActivationSequencer::LearnOutcome(ActivationStrategy strategy, bool success,
+                                       ActivationStats::Clock::time_point end) {
+    double latencyUs = std::chrono::duration<double, std::micro>(end - m_strategyStart).count();
+    m_strategyTable->Record(m_appKey, strategy, success, latencyUs, m_host->GetUnixSeconds());
+    m_host->OnStrategyLearned();
+}
+
+void ActivationSequencer::Finish() {
+    if (m_deadlineArmed) {
+        m_host->CancelDeadline();
+        m_deadlineArmed = false;
+    }
+
+    m_awaitedWindow.store(0, std::memory_order_release);
+    m_foregroundWindow.store(0, std::memory_order_relaxed);
+    m_active = false;
+    m_target = 0;
+    m_targetHandle = 0;
+
+    m_host->OnFinished();
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ActivationStats.h"
+#include "ResponsivenessCache.h"
+#include "StrategyTable.h"
+#include "WindowSystem.h"
+
+// Steps of an activation worth a log line; the owner decides what to say
+enum class ActivationEvent {
+    Superseded,         // A newer press took over from the target
+    SkippedGone,        // Candidate left the stacks since the copy
+    SkippedHidden,      // Hidden, minimized or on another desktop
+    SkippedHung,        // Not responding; keeps its place
+    SkippedReadyHung,   // The ready target, known hung
+    LearnedOrder,       // Starting with another strategy than Direct
+    TargetGone,         // Destroyed during the attempt
+    StoppedResponding,  // Hung while its strategies ran out; keeps its place
+    CouldNotActivate,   // Every strategy failed; dropped from the stack
+    Activated,          // Foreground event seen
+};
+
+// What an ActivationSequencer needs from its owner: the focus stacks, one
+// deadline timer and the application behind a window. Called on the
+// sequencer's thread.
+class ActivationHost {
+public:
+    virtual ~ActivationHost() {}
+
+    // Focus stacks of the current desktop
+    virtual WindowKey GetReadyTarget(int monitorIndex, WindowHandle* handle) = 0;  // 0 if none
+    virtual void CopyFocusStack(int monitorIndex, std::vector<WindowKey>* stack, std::vector<WindowHandle>* handles) = 0;
+    virtual bool IsWindowAlive(WindowHandle handle) = 0;
+    virtual uint32_t GetWindowState(WindowHandle handle) = 0;  // Cached WINDOW_STATE_* bits
+    virtual void RemoveWindowFromStack(int monitorIndex, WindowKey window) = 0;
+    virtual void TryFindWindowOnMonitor(int monitorIndex) = 0;  // Stack ran dry: activate any suitable window
+
+    virtual uint64_t GetAppKey(WindowKey window) = 0;  // StrategyTable key
+    virtual uint64_t GetUnixSeconds() = 0;  // Learned strategies age by wall clock
+
+    virtual void ArmDeadline(int delayMs) = 0;  // At most one armed; HandleDeadline() when it fires
+    virtual void CancelDeadline() = 0;
+    virtual void ProbeSoon(WindowKey window) = 0;  // Found hung; watch it for recovery
+    virtual void OnStrategyLearned() = 0;  // The table changed
+    virtual void OnFinished() = 0;  // Idle again, activated or not
+
+    virtual void OnActivationEvent(ActivationEvent event, WindowKey window, ActivationStrategy strategy) = 0;
+};
+
+// The state machine behind a hotkey press, free of threads and platform
+// types: the same code runs on ActivationPipeline's worker against Win32 and
+// headless against a SimulatedWindowSystem.
+//
+// Start() tries the monitor's ready target, validated by the focus worker,
+// without any validation calls of its own; the stack is copied and checked
+// entry by entry only if that target fails. Windows known to be hung are
+// skipped without losing their place in the stack.
+//
+// Each candidate gets the strategies in the order learned for its app
+// (StrategyTable), each with ATTEMPT_TIMEOUT_MS to produce a foreground
+// event, passed in through NotifyForeground(), before the next is tried. A
+// newer Start() supersedes the activation in flight.
+//
+// Single-threaded apart from NotifyForeground().
+class ActivationSequencer {
+public:
+    static const int ATTEMPT_TIMEOUT_MS = 150;
+    static const size_t MAX_CANDIDATES = 5;  // Stack entries per press before the fallback search
+    static const int RESPONSIVENESS_MAX_AGE_MS = 5000;  // Older probe results are not trusted
+
+    ActivationSequencer(WindowSystem* windowSystem, ActivationHost* host, ActivationStats* stats,
+                        StrategyTable* strategyTable, ResponsivenessCache* responsiveness);
+
+    void Start(int monitorIndex, ActivationStats::Clock::time_point hotkeyTime);
+    void Reset();  // Drops the activation in flight without a word; the deadline is the owner's to discard
+
+    // Any thread, once per foreground change; one atomic load when idle. True
+    // if it is the awaited window: HandleForeground() must follow.
+    bool NotifyForeground(WindowKey window);
+    void HandleForeground();
+    void HandleDeadline();
+
+    bool IsActive() const { return m_active; }
+    WindowKey GetTarget() const { return m_target; }
+
+private:
+    WindowSystem* m_windowSystem;
+    ActivationHost* m_host;
+    ActivationStats* m_stats;
+    StrategyTable* m_strategyTable;
+    ResponsivenessCache* m_responsiveness;
+
+    // NotifyForeground() -> HandleForeground()
+    std::atomic<WindowKey> m_awaitedWindow;  // Target of the running attempt, 0 if none
+    std::atomic<WindowKey> m_foregroundWindow;  // Awaited window seen as foreground, 0 if not yet
+
+    bool m_active;
+    int m_monitorIndex;
+    ActivationStats::Clock::time_point m_hotkeyTime;
+    std::vector<WindowKey> m_candidates;  // Ready target alone, then a copy of the monitor's stack
+    std::vector<WindowHandle> m_candidateHandles;  // Same indices
+    size_t m_nextCandidate;
+    WindowKey m_readyTarget;  // Tried first without validation; 0 if none
+    bool m_stackCopied;  // m_candidates holds the stack, validate each entry
+    bool m_targetSelected;
+    WindowKey m_target;
+    WindowHandle m_targetHandle;  // Dies once m_target leaves the stacks; its key may be reused then
+    uint64_t m_appKey;  // m_target's StrategyTable key
+    ActivationStrategy m_order[STRATEGY_COUNT];  // Learned order for m_target
+    int m_attempt;  // Index into m_order of the strategy being tried
+    ActivationStats::Clock::time_point m_selectedTime;
+    ActivationStats::Clock::time_point m_strategyStart;
+    bool m_deadlineArmed;
+
+    void CopyStackCandidates();
+    void SelectNextCandidate();
+    void TryStrategy();
+    bool IsHung(WindowKey window);
+    bool IsKnownHung(WindowKey window) const;
+    void MarkHung(WindowKey window, ActivationStats::Clock::time_point now);
+    void LearnOutcome(ActivationStrategy strategy, bool success, ActivationStats::Clock::time_point end);
+    void Finish();
+};
@@ -0,0 +1,175 @@
+#include "ActivationStats.h"
+#include <cstdio>
+
+// Bound by reference in std::chrono::milliseconds, so it needs a definition
+const int ActivationStats::CONFIRM_TIMEOUT_MS;
+
+const char* GetActivationStageName(ActivationStage stage) {
+    switch (stage) {
+        case ActivationStage::Select: return "select";
+        case ActivationStage::Activate: return "activate";
+        case ActivationStage::FallbackSearch: return "fallback-search";
+        case ActivationStage::EndToEnd: return "end-to-end";
+        default: return "?";
+    }
+}
+
+const char* GetActivationStrategyName(ActivationStrategy strategy) {
+    switch (strategy) {
+        case ActivationStrategy::Direct: return "direct";
+        case ActivationStrategy::AttachThreadInput: return "attach-thread-input";
+        case ActivationStrategy::BringToTop: return "bring-to-top";
+        default: return "?";
+    }
+}
+
+static uint64_t ElapsedNs(ActivationStats::Clock::time_point start, ActivationStats::Clock::time_point end) {
+    if (end <= start) {
+        return 0;
+    }
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+ActivationStats::ActivationStats()
+    : m_hotkeys(0)
+    , m_skippedCandidates(0)
+    , m_confirmed(0)
+    , m_unconfirmed(0)
+    , m_pendingWindow(0) {
+    for (int i = 0; i < static_cast<int>(ActivationStrategy::Count); ++i) {
+        m_strategySuccesses[i].store(0, std::memory_order_relaxed);
+        m_strategyFailures[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void ActivationStats::OnHotkey() {
+    m_hotkeys.fetch_add(1, std::memory_order_relaxed);
+
+    // The previous press's target never showed up as foreground
+    if (m_pendingWindow.load(std::memory_order_relaxed) != 0) {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        if (m_pendingWindow.load(std::memory_order_relaxed) != 0) {
+            m_pendingWindow.store(0, std::memory_order_relaxed);
+            m_unconfirmed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ActivationStats::RecordStage(ActivationStage stage, Clock::time_point start, Clock::time_point end) {
+    m_stages[static_cast<int>(stage)].Record(ElapsedNs(start, end));
+}
+
+void ActivationStats::RecordStrategy(ActivationStrategy strategy, Clock::time_point start, Clock::time_point end, bool success) {
+    int index = static_cast<int>(strategy);
+    m_strategies[index].Record(ElapsedNs(start, end));
+
+    if (success) {
+        m_strategySuccesses[index].fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_strategyFailures[index].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ActivationStats::OnCandidateSkipped() {
+    m_skippedCandidates.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ActivationStats::ExpectForeground(WindowKey window, Clock::time_point hotkeyTime) {
+    // Replaces the previous candidate of the same press, if any
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pendingSince = hotkeyTime;
+    m_pendingWindow.store(window, std::memory_order_relaxed);
+}
+
+void ActivationStats::OnForeground(WindowKey window, Clock::time_point now) {
+    // Almost every foreground change is the user's, not ours
+    if (window == 0 || m_pendingWindow.load(std::memory_order_relaxed) != window) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    if (m_pendingWindow.load(std::memory_order_relaxed) != window) {
+        return;
+    }
+    m_pendingWindow.store(0, std::memory_order_relaxed);
+
+    if (now - m_pendingSince > std::chrono::milliseconds(CONFIRM_TIMEOUT_MS)) {
+        m_unconfirmed.fetch_add(1, std::memory_order_relaxed);  // Most likely a later manual switch
+        return;
+    }
+
+    m_stages[static_cast<int>(ActivationStage::EndToEnd)].Record(ElapsedNs(m_pendingSince, now));
+    m_confirmed.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void AppendHistogramRow(std::string& report, const char* name, const LatencyHistogram& histogram) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "  %-22s %8llu %10.1f %10.1f %10.1f %10.1f\n",
+                  name,
+                  static_cast<unsigned long long>(histogram.GetCount()),
+                  histogram.GetValueAtPercentile(50.0) / 1000.0,
+                  histogram.GetValueAtPercentile(90.0) / 1000.0,
+                  histogram.GetValueAtPercentile(99.0) / 1000.0,
+                  histogram.GetMax() / 1000.0);
+    report += line;
+}
+
+std::string ActivationStats::FormatReport() const {
+    std::string report;
+    char line[160];
+
+    std::snprintf(line, sizeof(line), "  %-22s %8s %10s %10s %10s %10s\n", "stage (us)", "count", "p50", "p90", "p99", "max");
+    report += line;
+    for (int i = 0; i < static_cast<int>(ActivationStage::Count); ++i) {
+        AppendHistogramRow(report, GetActivationStageName(static_cast<ActivationStage>(i)), m_stages[i]);
+    }
+
+    report += "\n";
+    std::snprintf(line, sizeof(line), "  %-22s %8s %10s %10s %10s %10s %8s %8s\n",
+                  "strategy (us)", "count", "p50", "p90", "p99", "max", "ok", "failed");
+    report += line;
+    for (int i = 0; i < static_cast<int>(ActivationStrategy::Count); ++i) {
+        const LatencyHistogram& histogram = m_strategies[i];
+        std::snprintf(line, sizeof(line), "  %-22s %8llu %10.1f %10.1f %10.1f %10.1f %8llu %8llu\n",
+                      GetActivationStrategyName(static_cast<ActivationStrategy>(i)),
+                      static_cast<unsigned long long>(histogram.GetCount()),
+                      histogram.GetValueAtPercentile(50.0) / 1000.0,
+                      histogram.GetValueAtPercentile(90.0) / 1000.0,
+                      histogram.GetValueAtPercentile(99.0) / 1000.0,
+                      histogram.GetMax() / 1000.0,
+                      static_cast<unsigned long long>(m_strategySuccesses[i].load(std::memory_order_relaxed)),
+                      static_cast<unsigned long long>(m_strategyFailures[i].load(std::memory_order_relaxed)));
+        report += line;
+    }
+
+    report += "\n";
+    std::snprintf(line, sizeof(line),
+                  "  hotkeys %llu, skipped candidates %llu, fallback searches %llu, confirmed %llu, unconfirmed %llu\n",
+                  static_cast<unsigned long long>(m_hotkeys.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(m_skippedCandidates.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(GetStage(ActivationStage::FallbackSearch).GetCount()),
+                  static_cast<unsigned long long>(m_confirmed.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(m_unconfirmed.load(std::memory_order_relaxed)));
+    report += line;
+
+    return report;
+}
+
+void ActivationStats::Reset() {
+    for (int i = 0; i < static_cast<int>(ActivationStage::Count); ++i) {
+        m_stages[i].Reset();
+    }
+    for (int i = 0; i < static_cast<int>(ActivationStrategy::Count); ++i) {
+        m_strategies[i].Reset();
+        m_strategySuccesses[i].store(0, std::memory_order_relaxed);
+        m_strategyFailures[i].store(0, std::memory_order_relaxed);
+    }
+
+    m_hotkeys.store(0, std::memory_order_relaxed);
+    m_skippedCandidates.store(0, std::memory_order_relaxed);
+    m_confirmed.store(0, std::memory_order_relaxed);
+    m_unconfirmed.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pendingWindow.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "FocusStackEngine.h"
+#include "LatencyHistogram.h"
+
+// Timed stages of one hotkey press
+enum class ActivationStage {
+    Select,          // WM_HOTKEY -> valid target picked from the focus stack
+    Activate,        // Target picked -> its foreground event, strategies escalated as needed
+    FallbackSearch,  // TryFindWindowOnMonitor() after the stack ran dry
+    EndToEnd,        // WM_HOTKEY -> foreground change seen by the focus worker
+    Count
+};
+
+// ActivationPipeline strategies, in the order they are tried; a strategy
+// fails when no foreground event arrives within its deadline
+enum class ActivationStrategy {
+    Direct,             // SetForegroundWindow
+    AttachThreadInput,  // SetForegroundWindow with input queues attached
+    BringToTop,         // BringWindowToTop + SetFocus
+    Count
+};
+
+const char* GetActivationStageName(ActivationStage stage);
+const char* GetActivationStrategyName(ActivationStrategy strategy);
+
+// Hotkey-to-focus instrumentation: a latency histogram per stage and per
+// strategy plus outcome counters. The hotkey thread records stages; the
+// focus worker closes the end-to-end measurement when the expected window
+// becomes foreground. Everything is lock-free except the pending target.
+class ActivationStats {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Confirmations arriving later than this are counted as unconfirmed
+    static const int CONFIRM_TIMEOUT_MS = 1000;
+
+    ActivationStats();
+
+    ActivationStats(const ActivationStats&) = delete;
+    ActivationStats& operator=(const ActivationStats&) = delete;
+
+    // Hotkey thread
+    void OnHotkey();  // Closes out an unconfirmed previous press
+    void RecordStage(ActivationStage stage, Clock::time_point start, Clock::time_point end);
+    void RecordStrategy(ActivationStrategy strategy, Clock::time_point start, Clock::time_point end, bool success);
+    void OnCandidateSkipped();  // Stack entry invalid or not activatable
+    void ExpectForeground(WindowKey window, Clock::time_point hotkeyTime);
+
+    // Focus worker, once per foreground change; cheap when nothing is pending
+    void OnForeground(WindowKey window, Clock::time_point now);
+
+    const LatencyHistogram& GetStage(ActivationStage stage) const { return m_stages[static_cast<int>(stage)]; }
+    const LatencyHistogram& GetStrategy(ActivationStrategy strategy) const { return m_strategies[static_cast<int>(strategy)]; }
+
+    // p50/p90/p99/max table plus counters, one line per row
+    std::string FormatReport() const;
+
+    void Reset();
+
+private:
+    LatencyHistogram m_stages[static_cast<int>(ActivationStage::Count)];
+    LatencyHistogram m_strategies[static_cast<int>(ActivationStrategy::Count)];
+    std::atomic<uint64_t> m_strategySuccesses[static_cast<int>(ActivationStrategy::Count)];
+    std::atomic<uint64_t> m_strategyFailures[static_cast<int>(ActivationStrategy::Count)];
+
+    std::atomic<uint64_t> m_hotkeys;
+    std::atomic<uint64_t> m_skippedCandidates;
+    std::atomic<uint64_t> m_confirmed;
+    std::atomic<uint64_t> m_unconfirmed;
+
+    // Window whose foreground event ends the current measurement (0 = none).
+    // Checked without the lock on every foreground change.
+    std::atomic<WindowKey> m_pendingWindow;
+    Clock::time_point m_pendingSince;  // Guarded by m_pendingMutex
+    std::mutex m_pendingMutex;
+};
@@ -0,0 +1,44 @@
+#include "AppKeyCache.h"
+
+AppKeyCache::AppKeyCache()
+    : m_useCounter(0) {
+}
+
+bool AppKeyCache::Lookup(WindowKey window, uint32_t processId, uint64_t* appKey) {
+    std::unordered_map<WindowKey, Entry>::iterator it = m_entries.find(window);
+    if (it == m_entries.end() || it->second.processId != processId) {
+        return false;
+    }
+
+    it->second.lastUsed = ++m_useCounter;
+    *appKey = it->second.appKey;
+    return true;
+}
+
+void AppKeyCache::Store(WindowKey window, uint32_t processId, uint64_t appKey) {
+    std::unordered_map<WindowKey, Entry>::iterator it = m_entries.find(window);
+    if (it == m_entries.end()) {
+        if (m_entries.size() >= MAX_ENTRIES) {
+            EvictLeastRecentlyUsed();
+        }
+        it = m_entries.insert(std::make_pair(window, Entry())).first;
+    }
+
+    it->second.processId = processId;
+    it->second.appKey = appKey;
+    it->second.lastUsed = ++m_useCounter;
+}
+
+void AppKeyCache::EvictLeastRecentlyUsed() {
+    // Only past MAX_ENTRIES distinct windows, once per new one, so a linear scan is fine
+    std::unordered_map<WindowKey, Entry>::iterator oldest = m_entries.begin();
+    for (std::unordered_map<WindowKey, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->second.lastUsed < oldest->second.lastUsed) {
+            oldest = it;
+        }
+    }
+
+    if (oldest != m_entries.end()) {
+        m_entries.erase(oldest);
+    }
+}
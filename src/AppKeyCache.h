@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "FocusStackEngine.h"
+
+// Strategy table key of each window, so a press does not hash the process
+// image and class again. An entry remembers the process id it was computed
+// for, which catches a recycled handle. Not thread-safe; the activation
+// worker owns it.
+class AppKeyCache {
+public:
+    // Windows beyond this are forgotten, least recently used first
+    static const size_t MAX_ENTRIES = 1024;
+
+    AppKeyCache();
+
+    // False if unknown, or known for a different process
+    bool Lookup(WindowKey window, uint32_t processId, uint64_t* appKey);
+    void Store(WindowKey window, uint32_t processId, uint64_t appKey);
+
+    size_t GetSize() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint32_t processId;
+        uint64_t appKey;
+        uint64_t lastUsed;
+    };
+
+    std::unordered_map<WindowKey, Entry> m_entries;
+    uint64_t m_useCounter;
+
+    void EvictLeastRecentlyUsed();
+};
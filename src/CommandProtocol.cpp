@@ -0,0 +1,111 @@
+#include "CommandProtocol.h"
+#include <cstdlib>
+
+static std::string Trim(const std::string& text) {
+    const char* blanks = " \t\r";
+    size_t first = text.find_first_not_of(blanks);
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    size_t last = text.find_last_not_of(blanks);
+    return text.substr(first, last - first + 1);
+}
+
+bool ParseCommand(const std::string& line, Command* command, std::string* error) {
+    std::string text = Trim(line);
+    size_t space = text.find_first_of(" \t");
+    std::string name = text.substr(0, space);
+    std::string argument = space != std::string::npos ? Trim(text.substr(space)) : std::string();
+
+    command->monitorIndex = 0;
+
+    if (name == "monitor") {
+        char* end = nullptr;
+        long index = std::strtol(argument.c_str(), &end, 10);
+        if (argument.empty() || *end != '\0' || index < 0 || index > 1000) {
+            *error = "monitor needs a monitor number";
+            return false;
+        }
+        command->type = CommandType::SelectMonitor;
+        command->monitorIndex = static_cast<int>(index);
+        return true;
+    }
+
+    if (!argument.empty()) {
+        *error = name + " takes no argument";
+        return false;
+    }
+
+    if (name == "ping") {
+        command->type = CommandType::Ping;
+    } else if (name == "cycle") {
+        command->type = CommandType::Cycle;
+    } else if (name == "stacks") {
+        command->type = CommandType::QueryStacks;
+    } else if (name == "stats") {
+        command->type = CommandType::DumpStats;
+    } else {
+        *error = "unknown command: " + name;
+        return false;
+    }
+    return true;
+}
+
+void AppendCommandReply(const CommandReply& reply, std::string* out) {
+    out->append(reply.ok ? "ok" : "err");
+    if (!reply.summary.empty()) {
+        out->push_back(' ');
+        out->append(reply.summary);
+    }
+    out->push_back('\n');
+
+    // Indented, so an empty detail line cannot end the reply early
+    size_t start = 0;
+    while (start < reply.details.size()) {
+        size_t end = reply.details.find('\n', start);
+        if (end == std::string::npos) {
+            end = reply.details.size();
+        }
+        out->append("  ");
+        out->append(reply.details, start, end - start);
+        out->push_back('\n');
+        start = end + 1;
+    }
+}
+
+void CommandBatchBuffer::Append(const char* data, size_t length) {
+    // "\r\n" from Windows scripts counts as "\n"
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] != '\r') {
+            m_pending.push_back(data[i]);
+        }
+    }
+}
+
+bool CommandBatchBuffer::TakeBatch(std::vector<std::string>* lines) {
+    lines->clear();
+    if (m_pending.empty()) {
+        return false;
+    }
+
+    // A batch ends at the first empty line; one that starts with it is empty
+    size_t end = m_pending[0] == '\n' ? 0 : m_pending.find("\n\n");
+    if (end == std::string::npos) {
+        return false;
+    }
+
+    size_t start = 0;
+    while (start < end) {
+        size_t lineEnd = m_pending.find('\n', start);
+        lines->push_back(m_pending.substr(start, lineEnd - start));
+        start = lineEnd + 1;
+    }
+
+    m_pending.erase(0, end == 0 ? 1 : end + 2);
+    return true;
+}
+
+bool CommandBatchBuffer::IsOverflowing() const {
+    size_t end = m_pending.find("\n\n");
+    return (end != std::string::npos ? end : m_pending.size()) > COMMAND_MAX_BATCH_BYTES;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Text protocol of the local command endpoint (see CommandServer).
+//
+// A request is a batch: one command per line, ended by an empty line. The
+// reply has one entry per command, in order, also ended by an empty line:
+//
+//   > monitor 1            < ok monitor 1
+//   > stacks               < ok
+//   >                      <   current monitor: 1
+//                          <   Monitor 0: 0x1a2b 0x3c4d
+//                          <
+//
+// An entry is "ok" or "err", optionally followed by a space and a summary,
+// then any number of detail lines indented by two spaces. Commands:
+//
+//   ping         does nothing; for measuring the round trip
+//   cycle        same as the cycle hotkey
+//   monitor <n>  same as a monitor hotkey, n counted from 0 as in "stacks"
+//   stacks       current monitor and every focus stack, most recent first
+//   stats        hotkey-to-focus latency report
+
+#define COMMAND_ENDPOINT_BASE_NAME "true-recall"
+
+static const size_t COMMAND_MAX_BATCH_BYTES = 4096;  // Longer requests are refused
+
+enum class CommandType {
+    Ping,
+    Cycle,
+    SelectMonitor,
+    QueryStacks,
+    DumpStats,
+};
+
+struct Command {
+    CommandType type;
+    int monitorIndex;  // SelectMonitor only
+};
+
+struct CommandReply {
+    bool ok;
+    std::string summary;  // One line
+    std::string details;  // Any number of lines
+};
+
+// Leading/trailing blanks and '\r' are ignored
+bool ParseCommand(const std::string& line, Command* command, std::string* error);
+
+void AppendCommandReply(const CommandReply& reply, std::string* out);
+
+// Request side: collects received bytes and hands out complete batches
+class CommandBatchBuffer {
+public:
+    void Append(const char* data, size_t length);
+
+    // Lines of the next complete batch (without the empty line); false if
+    // none has arrived completely yet
+    bool TakeBatch(std::vector<std::string>* lines);
+
+    // The next batch is longer than COMMAND_MAX_BATCH_BYTES, complete or not
+    bool IsOverflowing() const;
+
+private:
+    std::string m_pending;
+};
@@ -0,0 +1,170 @@
+#include "CommandServer.h"
+
+CommandServer::CommandServer(EventLoop* loop)
+    : m_loop(loop)
+    , m_batchSignal(-1)
+    , m_stopping(false)
+    , m_batchCount(0)
+    , m_batchState(BatchState::Idle)
+    , m_batch(nullptr)
+    , m_replies(nullptr) {
+}
+
+CommandServer::~CommandServer() {
+    Stop();
+}
+
+bool CommandServer::Start(const std::string& endpointName, Handler handler) {
+    if (m_worker.joinable() || !m_listener.Listen(endpointName)) {
+        return false;
+    }
+
+    if (m_batchSignal < 0) {
+        m_batchSignal = m_loop->AddSignal([this]() { HandleBatch(); });
+        if (m_batchSignal < 0) {
+            m_listener.Close();
+            return false;
+        }
+    }
+
+    m_handler = handler;
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_worker = std::thread([this]() { Run(); });
+    return true;
+}
+
+void CommandServer::Stop() {
+    if (!m_worker.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        m_stopping.store(true, std::memory_order_relaxed);
+    }
+    m_batchDone.notify_all();  // A batch the loop will never run again
+    m_listener.Wake();
+    m_worker.join();
+    m_listener.Close();
+}
+
+void CommandServer::Run() {
+    LocalChannel channel;
+    while (!m_stopping.load(std::memory_order_relaxed) && m_listener.Accept(&channel)) {
+        ServeClient(&channel);
+        channel.Close();
+    }
+}
+
+void CommandServer::ServeClient(LocalChannel* channel) {
+    CommandBatchBuffer buffer;
+    std::vector<std::string> lines;
+    std::vector<Command> commands;
+    std::vector<CommandReply> replies;
+    std::string response;
+    char received[1024];
+
+    for (;;) {
+        size_t length = 0;
+        if (!channel->Receive(received, sizeof(received), &length, CLIENT_IDLE_MS)) {
+            return;  // Closed, idle or stopping
+        }
+        buffer.Append(received, length);
+
+        while (!buffer.IsOverflowing() && buffer.TakeBatch(&lines)) {
+            // Parsed here, so the loop thread only runs valid commands
+            commands.clear();
+            std::vector<CommandReply> parsed(lines.size());
+            std::vector<size_t> commandLines;
+            for (size_t i = 0; i < lines.size(); ++i) {
+                Command command;
+                if (ParseCommand(lines[i], &command, &parsed[i].summary)) {
+                    commands.push_back(command);
+                    commandLines.push_back(i);
+                } else {
+                    parsed[i].ok = false;
+                }
+            }
+
+            if (!commands.empty() && !RunOnLoop(commands, &replies)) {
+                return;  // Shutting down; the client sees the channel close
+            }
+            for (size_t i = 0; i < commands.size(); ++i) {
+                parsed[commandLines[i]] = replies[i];
+            }
+
+            response.clear();
+            for (const CommandReply& reply : parsed) {
+                AppendCommandReply(reply, &response);
+            }
+            response.push_back('\n');
+
+            if (!channel->Send(response.data(), response.size())) {
+                return;
+            }
+            m_batchCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (buffer.IsOverflowing()) {
+            static const char tooLarge[] = "err request too large\n\n";
+            channel->Send(tooLarge, sizeof(tooLarge) - 1);
+            return;
+        }
+    }
+}
+
+bool CommandServer::RunOnLoop(const std::vector<Command>& commands, std::vector<CommandReply>* replies) {
+    replies->assign(commands.size(), CommandReply());
+
+    std::unique_lock<std::mutex> lock(m_batchMutex);
+    if (m_stopping.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    m_batch = &commands;
+    m_replies = replies;
+    m_batchState = BatchState::Pending;
+    lock.unlock();
+
+    // One wakeup of the loop thread for the whole batch
+    m_loop->Notify(m_batchSignal);
+
+    lock.lock();
+    m_batchDone.wait(lock, [this]() {
+        return m_batchState == BatchState::Done ||
+               (m_batchState == BatchState::Pending && m_stopping.load(std::memory_order_relaxed));
+    });
+
+    // Once the loop thread started a batch it is allowed to finish it
+    bool done = m_batchState == BatchState::Done;
+    m_batchState = BatchState::Idle;
+    m_batch = nullptr;
+    m_replies = nullptr;
+    return done;
+}
+
+void CommandServer::HandleBatch() {
+    const std::vector<Command>* commands;
+    std::vector<CommandReply>* replies;
+    {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        if (m_batchState != BatchState::Pending) {
+            return;
+        }
+        m_batchState = BatchState::Running;
+        commands = m_batch;
+        replies = m_replies;
+    }
+
+    // The worker waits, so the batch and replies stay put without the lock
+    for (size_t i = 0; i < commands->size(); ++i) {
+        CommandReply& reply = (*replies)[i];
+        reply.ok = true;
+        m_handler((*commands)[i], &reply);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        m_batchState = BatchState::Done;
+    }
+    m_batchDone.notify_all();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CommandProtocol.h"
+#include "EventLoop.h"
+#include "LocalChannel.h"
+
+// Local command endpoint, so launchers and scripts can switch monitors
+// without simulating keystrokes.
+//
+// A worker thread owns the LocalChannel listener and parses requests. Each
+// batch is then handed to the owner's EventLoop in one notification and runs
+// there, on the same thread as the hotkeys, while the worker waits for the
+// replies. Clients are served one at a time; a client idle for
+// CLIENT_IDLE_MS is dropped so it cannot keep others waiting.
+class CommandServer {
+public:
+    // Loop thread, once per command of a batch
+    typedef std::function<void(const Command& command, CommandReply* reply)> Handler;
+
+    static const int CLIENT_IDLE_MS = 1000;
+
+    explicit CommandServer(EventLoop* loop);
+    ~CommandServer();
+
+    // Call before loop->Run() or from the loop thread
+    bool Start(const std::string& endpointName, Handler handler);
+    void Stop();
+
+    uint64_t GetBatchCount() const { return m_batchCount.load(std::memory_order_relaxed); }
+
+private:
+    enum class BatchState {
+        Idle,
+        Pending,  // Waiting for the loop thread
+        Running,
+        Done,
+    };
+
+    EventLoop* m_loop;
+    EventLoop::SignalId m_batchSignal;
+    Handler m_handler;
+
+    LocalListener m_listener;
+    std::thread m_worker;
+    std::atomic<bool> m_stopping;
+    std::atomic<uint64_t> m_batchCount;
+
+    // Hand-off of one batch to the loop thread; guarded by m_batchMutex
+    std::mutex m_batchMutex;
+    std::condition_variable m_batchDone;
+    BatchState m_batchState;
+    const std::vector<Command>* m_batch;
+    std::vector<CommandReply>* m_replies;
+
+    void Run();
+    void ServeClient(LocalChannel* channel);
+    bool RunOnLoop(const std::vector<Command>& commands, std::vector<CommandReply>* replies);
+    void HandleBatch();  // Loop thread
+};
@@ -1,10 +1,34 @@
 #include "Config.h"
-#include <iostream>
+#include "Logger.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <utility>
 
-Config::Config() : m_moveMouse(true) {
+ConfigSnapshot::ConfigSnapshot() : moveMouse(true), recordFocusTrace(false) {
+    // Default cycle hotkey (Alt+N) comes from HotkeyConfig; monitor hotkeys are opt-in
+    for (HotkeyConfig& monitorHotkey : monitorHotkeys) {
+        monitorHotkey.vkey = 0;
+    }
+}
+
+bool ConfigSnapshot::operator==(const ConfigSnapshot& other) const {
+    if (hotkey != other.hotkey || moveMouse != other.moveMouse || recordFocusTrace != other.recordFocusTrace) {
+        return false;
+    }
+    
+    for (int i = 0; i < MAX_MONITOR_HOTKEYS; ++i) {
+        if (monitorHotkeys[i] != other.monitorHotkeys[i]) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+Config::Config() : m_snapshot(nullptr) {
+    Publish(std::unique_ptr<ConfigSnapshot>(new ConfigSnapshot()));
+    
     // Get config file path in the same directory as the executable
     wchar_t exePath[MAX_PATH];
     GetModuleFileNameW(NULL, exePath, MAX_PATH);
@@ -22,11 +46,59 @@ bool Config::Load() {
     std::wifstream file(m_configPath);
     
     if (!file.is_open()) {
-        std::wcout << L"Config file not found, creating default: " << m_configPath << std::endl;
-        CreateDefaultConfig();
+        // Defaults are already published
+        TR_LOG_INFO("Config file not found, creating default: {}", m_configPath);
+        Save();
         return true;
     }
     
+    // Lenient at startup: a bad line is reported and its default kept
+    std::unique_ptr<ConfigSnapshot> snapshot(new ConfigSnapshot());
+    Parse(file, snapshot.get(), false);
+    file.close();
+    
+    Publish(std::move(snapshot));
+    TR_LOG_INFO("Config loaded: {}", GetHotkeyString());
+    return true;
+}
+
+bool Config::Reload() {
+    std::wifstream file(m_configPath);
+    
+    if (!file.is_open()) {
+        // Deleted, or still locked by the editor; the next change retries
+        TR_LOG_WARN("Config reload skipped, cannot open {}", m_configPath);
+        return false;
+    }
+    
+    // Strict on reload: half an edit must not replace working settings
+    std::unique_ptr<ConfigSnapshot> snapshot(new ConfigSnapshot());
+    bool valid = Parse(file, snapshot.get(), true);
+    file.close();
+    
+    if (!valid) {
+        TR_LOG_ERROR("Config reload rejected, keeping previous settings");
+        return false;
+    }
+    
+    const ConfigSnapshot& current = GetSnapshot();
+    if (*snapshot == current) {
+        return false;  // Saved without changes, or a second event for the same save
+    }
+    
+    if (snapshot->recordFocusTrace != current.recordFocusTrace) {
+        TR_LOG_INFO("RecordFocusTrace takes effect after a restart");
+    }
+    
+    Publish(std::move(snapshot));
+    TR_LOG_INFO("Config reloaded: {}", GetHotkeyString());
+    return true;
+}
+
+bool Config::Parse(std::wistream& file, ConfigSnapshot* snapshot, bool strict) const {
+    int errors = 0;
+    bool hasCycleHotkey = false;
+    
     std::wstring line;
     while (std::getline(file, line)) {
         // Skip comments and empty lines
@@ -50,58 +122,98 @@ bool Config::Load() {
         value.erase(value.find_last_not_of(L" \t") + 1);
         
         if (key == L"CycleMonitorHotkey") {
-            if (!ParseHotkeyString(value)) {
-                std::wcerr << L"Invalid hotkey format: " << value << std::endl;
+            if (ParseHotkey(value, &snapshot->hotkey)) {
+                hasCycleHotkey = true;
+            } else {
+                TR_LOG_ERROR("Invalid hotkey format: {}", value);
+                ++errors;
+            }
+        } else if (key.compare(0, 13, L"MonitorHotkey") == 0) {
+            // MonitorHotkey1..9 select monitors 0..8; an empty value disables it
+            int number = _wtoi(key.substr(13).c_str());
+            if (number < 1 || number > MAX_MONITOR_HOTKEYS) {
+                TR_LOG_ERROR("Unknown setting: {}", key);
+                ++errors;
+                continue;
+            }
+            
+            HotkeyConfig& hotkey = snapshot->monitorHotkeys[number - 1];
+            hotkey.vkey = 0;
+            if (!value.empty() && !ParseHotkey(value, &hotkey)) {
+                TR_LOG_ERROR("Invalid hotkey format for {}: {}", key, value);
+                ++errors;
             }
         } else if (key == L"MoveMouseToMonitor") {
             // Parse boolean (true/false, yes/no, 1/0)
             std::transform(value.begin(), value.end(), value.begin(), ::towlower);
-            m_moveMouse = (value == L"true" || value == L"yes" || value == L"1");
+            snapshot->moveMouse = (value == L"true" || value == L"yes" || value == L"1");
+        } else if (key == L"RecordFocusTrace") {
+            std::transform(value.begin(), value.end(), value.begin(), ::towlower);
+            snapshot->recordFocusTrace = (value == L"true" || value == L"yes" || value == L"1");
         }
     }
     
-    file.close();
-    std::wcout << L"Config loaded: " << GetHotkeyString() << std::endl;
-    return true;
+    if (!strict) {
+        return errors == 0;
+    }
+    
+    // An empty or truncated file mid-save would otherwise reset everything to defaults
+    if (!hasCycleHotkey) {
+        TR_LOG_ERROR("CycleMonitorHotkey missing from {}", m_configPath);
+        return false;
+    }
+    return errors == 0;
+}
+
+void Config::Publish(std::unique_ptr<ConfigSnapshot> snapshot) {
+    std::lock_guard<std::mutex> lock(m_publishMutex);
+    const ConfigSnapshot* published = snapshot.get();
+    m_snapshots.push_back(std::move(snapshot));
+    m_snapshot.store(published, std::memory_order_release);
 }
 
 bool Config::Save() {
     std::wofstream file(m_configPath);
     
     if (!file.is_open()) {
-        std::wcerr << L"Failed to save config file: " << m_configPath << std::endl;
+        TR_LOG_ERROR("Failed to save config file: {}", m_configPath);
         return false;
     }
     
+    const ConfigSnapshot& snapshot = GetSnapshot();
+    
     file << L"; True Recall Configuration File\n";
     file << L"; \n";
+    file << L"; Changes are picked up while True Recall is running\n";
+    file << L"; \n";
     file << L"; Hotkey format: Modifier+Modifier+Key\n";
     file << L"; Modifiers: Ctrl, Alt, Shift, Win\n";
     file << L"; Keys: A-Z, 0-9, F1-F12, or special keys\n";
     file << L"; Example: Alt+N\n";
     file << L"\n";
-    file << L"CycleMonitorHotkey=" << GetHotkeyString() << L"\n";
+    file << L"CycleMonitorHotkey=" << FormatHotkey(snapshot.hotkey) << L"\n";
+    file << L"\n";
+    file << L"; Optional: jump straight to monitor N (1 = first monitor) with one press\n";
+    file << L"; Example: MonitorHotkey1=Alt+1\n";
+    for (int i = 0; i < MAX_MONITOR_HOTKEYS; ++i) {
+        if (snapshot.monitorHotkeys[i].vkey != 0) {
+            file << L"MonitorHotkey" << (i + 1) << L"=" << FormatHotkey(snapshot.monitorHotkeys[i]) << L"\n";
+        }
+    }
     file << L"\n";
     file << L"; Move mouse cursor to the monitor when switching\n";
     file << L"; Set to true or false\n";
-    file << L"MoveMouseToMonitor=" << (m_moveMouse ? L"true" : L"false") << L"\n";
+    file << L"MoveMouseToMonitor=" << (snapshot.moveMouse ? L"true" : L"false") << L"\n";
+    file << L"\n";
+    file << L"; Record focus events to true-recall.trace for offline replay (read at startup)\n";
+    file << L"; Set to true or false\n";
+    file << L"RecordFocusTrace=" << (snapshot.recordFocusTrace ? L"true" : L"false") << L"\n";
     
     file.close();
-    std::wcout << L"Config saved: " << m_configPath << std::endl;
+    TR_LOG_INFO("Config saved: {}", m_configPath);
     return true;
 }
 
-void Config::CreateDefaultConfig() {
-    // Use default hotkey (Alt+N)
-    m_hotkey.modifiers = MOD_ALT | MOD_NOREPEAT;
-    m_hotkey.vkey = 'N';
-    
-    // Enable mouse repositioning by default
-    m_moveMouse = true;
-    
-    Save();
-}
-
 std::wstring Config::GetModifierString(UINT modifiers) const {
     std::wstring result;
     
@@ -156,19 +268,41 @@ std::wstring Config::GetKeyString(UINT vkey) const {
     }
 }
 
+std::vector<HotkeyBinding> Config::GetHotkeyBindings() const {
+    const ConfigSnapshot& snapshot = GetSnapshot();
+    std::vector<HotkeyBinding> bindings(1 + MAX_MONITOR_HOTKEYS);
+    
+    bindings[0].hotkey = snapshot.hotkey;
+    bindings[0].action = HotkeyAction::CycleMonitor;
+    bindings[0].monitorIndex = -1;
+    
+    for (int i = 0; i < MAX_MONITOR_HOTKEYS; ++i) {
+        HotkeyBinding& select = bindings[1 + i];
+        select.hotkey = snapshot.monitorHotkeys[i];
+        select.action = HotkeyAction::SelectMonitor;
+        select.monitorIndex = i;
+    }
+    
+    return bindings;
+}
+
 std::wstring Config::GetHotkeyString() const {
-    std::wstring result = GetModifierString(m_hotkey.modifiers);
+    return FormatHotkey(GetSnapshot().hotkey);
+}
+
+std::wstring Config::FormatHotkey(const HotkeyConfig& hotkey) const {
+    std::wstring result = GetModifierString(hotkey.modifiers);
     
     if (!result.empty()) {
         result += L"+";
     }
     
-    result += GetKeyString(m_hotkey.vkey);
+    result += GetKeyString(hotkey.vkey);
     
     return result;
 }
 
-bool Config::ParseHotkeyString(const std::wstring& hotkeyStr) {
+bool Config::ParseHotkey(const std::wstring& hotkeyStr, HotkeyConfig* hotkey) const {
     UINT modifiers = MOD_NOREPEAT;
     UINT vkey = 0;
     
@@ -228,11 +362,11 @@ bool Config::ParseHotkeyString(const std::wstring& hotkeyStr) {
     
     // Check for conflicts
     if (IsHotkeyConflict(modifiers, vkey)) {
-        std::wcerr << L"Warning: Hotkey may conflict with Windows system hotkeys" << std::endl;
+        TR_LOG_WARN("Warning: Hotkey may conflict with Windows system hotkeys");
     }
     
-    m_hotkey.modifiers = modifiers;
-    m_hotkey.vkey = vkey;
+    hotkey->modifiers = modifiers;
+    hotkey->vkey = vkey;
     
     return true;
 }
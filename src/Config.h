@@ -1,40 +1,106 @@
 #pragma once
 
 #include <windows.h>
+#include <atomic>
+#include <istream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 struct HotkeyConfig {
     UINT modifiers;  // MOD_CONTROL, MOD_ALT, MOD_SHIFT, MOD_WIN
     UINT vkey;       // Virtual key code (e.g., 'N', VK_F1, etc.)
     
     HotkeyConfig() : modifiers(MOD_ALT | MOD_NOREPEAT), vkey('N') {}
+    
+    bool operator==(const HotkeyConfig& other) const { return modifiers == other.modifiers && vkey == other.vkey; }
+    bool operator!=(const HotkeyConfig& other) const { return !(*this == other); }
+};
+
+// What a registered hotkey does
+enum class HotkeyAction {
+    CycleMonitor,   // Next monitor, wrapping around
+    SelectMonitor,  // One specific monitor
+};
+
+struct HotkeyBinding {
+    HotkeyConfig hotkey;
+    HotkeyAction action;
+    int monitorIndex;  // SelectMonitor only
+};
+
+// Everything read from true-recall.ini. Never modified once published.
+struct ConfigSnapshot {
+    static const int MAX_MONITOR_HOTKEYS = 9;  // MonitorHotkey1..MonitorHotkey9
+    
+    HotkeyConfig hotkey;
+    HotkeyConfig monitorHotkeys[MAX_MONITOR_HOTKEYS];  // vkey 0 = not set
+    bool moveMouse;
+    bool recordFocusTrace;
+    
+    ConfigSnapshot();
+    
+    bool operator==(const ConfigSnapshot& other) const;
+    bool operator!=(const ConfigSnapshot& other) const { return !(*this == other); }
 };
 
+// Settings are held as an immutable ConfigSnapshot behind an atomic pointer.
+// Readers on any thread load the pointer and never take a lock; Reload()
+// parses a new snapshot and swaps it in whole, so a reader sees either the
+// old settings or the new ones, never a mix.
 class Config {
 public:
+    static const int MAX_MONITOR_HOTKEYS = ConfigSnapshot::MAX_MONITOR_HOTKEYS;
+    
     Config();
     
-    bool Load();  // Load from true-recall.ini
-    bool Save();  // Save to true-recall.ini
+    bool Load();  // Load from true-recall.ini at startup; bad lines keep their defaults
+    bool Save();  // Save the current snapshot to true-recall.ini
+    
+    // Any thread: re-read true-recall.ini. Returns true if a new snapshot was
+    // published. An edit that does not parse completely is rejected and the
+    // current snapshot stays.
+    bool Reload();
+    
+    // Any thread, lock-free. The reference stays valid for the lifetime of
+    // the Config, even after a newer snapshot replaces it.
+    const ConfigSnapshot& GetSnapshot() const { return *m_snapshot.load(std::memory_order_acquire); }
+    
+    const std::wstring& GetConfigPath() const { return m_configPath; }
     
-    HotkeyConfig GetHotkeyConfig() const { return m_hotkey; }
-    void SetHotkeyConfig(const HotkeyConfig& hotkey) { m_hotkey = hotkey; }
+    HotkeyConfig GetHotkeyConfig() const { return GetSnapshot().hotkey; }
     
-    bool GetMoveMouse() const { return m_moveMouse; }
-    void SetMoveMouse(bool moveMouse) { m_moveMouse = moveMouse; }
+    // Fixed table of every hotkey slot: the cycle hotkey first, then one
+    // entry per MonitorHotkeyN (vkey 0 when not set). HotkeyManager registers
+    // entry i as hotkey id HOTKEY_FIRST_ID + i, so ids never move between
+    // reloads.
+    std::vector<HotkeyBinding> GetHotkeyBindings() const;
+    
+    bool GetMoveMouse() const { return GetSnapshot().moveMouse; }
+    bool GetRecordFocusTrace() const { return GetSnapshot().recordFocusTrace; }
     
     std::wstring GetHotkeyString() const;
-    bool ParseHotkeyString(const std::wstring& hotkeyStr);
+    std::wstring FormatHotkey(const HotkeyConfig& hotkey) const;
+    bool ParseHotkey(const std::wstring& hotkeyStr, HotkeyConfig* hotkey) const;
     
     // Check if hotkey conflicts with Windows system hotkeys
     bool IsHotkeyConflict(UINT modifiers, UINT vkey) const;
 
 private:
-    HotkeyConfig m_hotkey;
-    bool m_moveMouse;
     std::wstring m_configPath;
     
-    void CreateDefaultConfig();
+    std::atomic<const ConfigSnapshot*> m_snapshot;  // Current settings, never null
+    
+    // Every snapshot ever published. A reader may still hold an older one, so
+    // none is freed before the Config; that is one small struct per edit.
+    std::vector<std::unique_ptr<const ConfigSnapshot>> m_snapshots;
+    std::mutex m_publishMutex;  // Writers only
+    
+    // strict: any bad line, or a missing CycleMonitorHotkey, fails the parse
+    bool Parse(std::wistream& file, ConfigSnapshot* snapshot, bool strict) const;
+    void Publish(std::unique_ptr<ConfigSnapshot> snapshot);
+    
     std::wstring GetModifierString(UINT modifiers) const;
     std::wstring GetKeyString(UINT vkey) const;
 };
@@ -0,0 +1,148 @@
+#include "ConfigWatcher.h"
+#include "Config.h"
+#include "Logger.h"
+
+ConfigWatcher::ConfigWatcher(Config* config)
+    : m_config(config)
+    , m_directory(INVALID_HANDLE_VALUE)
+    , m_changeEvent(nullptr)
+    , m_stopEvent(nullptr)
+{
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    Stop();
+}
+
+bool ConfigWatcher::Start(Callback onChange) {
+    if (m_worker.joinable()) {
+        TR_LOG_ERROR("ConfigWatcher already started");
+        return false;
+    }
+
+    const std::wstring& path = m_config->GetConfigPath();
+    size_t lastSlash = path.find_last_of(L"\\/");
+    if (lastSlash == std::wstring::npos) {
+        TR_LOG_ERROR("Cannot watch config path without a directory: {}", path);
+        return false;
+    }
+    std::wstring directory = path.substr(0, lastSlash);
+    m_fileName = path.substr(lastSlash + 1);
+
+    m_directory = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (m_directory == INVALID_HANDLE_VALUE) {
+        TR_LOG_ERROR("Failed to open config directory for watching: {}", GetLastError());
+        return false;
+    }
+
+    m_changeEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (m_changeEvent == nullptr || m_stopEvent == nullptr) {
+        TR_LOG_ERROR("Failed to create config watcher events: {}", GetLastError());
+        CloseHandles();
+        return false;
+    }
+
+    m_onChange = onChange;
+    m_worker = std::thread([this]() { Run(); });
+    return true;
+}
+
+void ConfigWatcher::Stop() {
+    if (m_worker.joinable()) {
+        SetEvent(m_stopEvent);
+        m_worker.join();
+    }
+    CloseHandles();
+}
+
+void ConfigWatcher::Run() {
+    HANDLE handles[2] = { m_stopEvent, m_changeEvent };
+    // The directory is shared with the log, trace and snapshot files. Size
+    // changes would wake us on every log append; last-write times are updated
+    // lazily (mostly on flush and close), so the remaining noise is a few
+    // wakeups per log rotation or snapshot save, each one name compare.
+    // Every way an editor saves (in place or by rename) still shows up.
+    const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+
+    for (;;) {
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = m_changeEvent;
+        ResetEvent(m_changeEvent);
+
+        // Changes that happen between two reads are queued on the handle, not lost
+        if (!ReadDirectoryChangesW(m_directory, m_buffer, sizeof(m_buffer), FALSE, filter, nullptr, &overlapped,
+                                   nullptr)) {
+            TR_LOG_ERROR("Config watcher stopped, ReadDirectoryChangesW failed: {}", GetLastError());
+            return;
+        }
+
+        DWORD bytes = 0;
+        if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
+            // Stop requested: the read must be finished before the buffer goes away
+            CancelIoEx(m_directory, &overlapped);
+            GetOverlappedResult(m_directory, &overlapped, &bytes, TRUE);
+            return;
+        }
+
+        if (!GetOverlappedResult(m_directory, &overlapped, &bytes, FALSE)) {
+            TR_LOG_ERROR("Config watcher stopped: {}", GetLastError());
+            return;
+        }
+
+        // Zero bytes means the queue overflowed and names were dropped: reload to be safe
+        if (bytes != 0 && !MentionsConfigFile(bytes)) {
+            continue;  // The log or the focus snapshot, most likely
+        }
+
+        // Let the editor finish writing; the later records of the same save
+        // come back as an unchanged snapshot and are dropped by Reload()
+        if (WaitForSingleObject(m_stopEvent, SETTLE_MS) == WAIT_OBJECT_0) {
+            return;
+        }
+
+        if (m_config->Reload() && m_onChange) {
+            m_onChange();
+        }
+    }
+}
+
+bool ConfigWatcher::MentionsConfigFile(DWORD bytes) const {
+    const BYTE* record = reinterpret_cast<const BYTE*>(m_buffer);
+    const BYTE* end = record + bytes;
+
+    while (record < end) {
+        const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+        int length = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+
+        // Names are not null-terminated; renames report the new name too
+        if (CompareStringOrdinal(info->FileName, length, m_fileName.c_str(), static_cast<int>(m_fileName.size()),
+                                 TRUE) == CSTR_EQUAL) {
+            return true;
+        }
+
+        if (info->NextEntryOffset == 0) {
+            break;
+        }
+        record += info->NextEntryOffset;
+    }
+
+    return false;
+}
+
+void ConfigWatcher::CloseHandles() {
+    if (m_directory != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_directory);
+        m_directory = INVALID_HANDLE_VALUE;
+    }
+    if (m_changeEvent != nullptr) {
+        CloseHandle(m_changeEvent);
+        m_changeEvent = nullptr;
+    }
+    if (m_stopEvent != nullptr) {
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+    }
+}
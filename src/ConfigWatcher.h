@@ -0,0 +1,45 @@
+#pragma once
+
+#include <windows.h>
+#include <functional>
+#include <string>
+#include <thread>
+
+class Config;
+
+// Reloads a Config when its file changes, from its own thread, so parsing
+// never runs on the message loop.
+//
+// Waits on ReadDirectoryChangesW for the config file's directory and ignores
+// changes to other files there. A change is given SETTLE_MS to finish (editors
+// save in several writes) before Config::Reload() runs; onChange is called on
+// the watcher thread only when a new snapshot was published.
+class ConfigWatcher {
+public:
+    typedef std::function<void()> Callback;
+
+    static const int SETTLE_MS = 200;
+
+    explicit ConfigWatcher(Config* config);
+    ~ConfigWatcher();
+
+    bool Start(Callback onChange);
+    void Stop();
+
+private:
+    Config* m_config;
+    Callback m_onChange;
+    std::wstring m_fileName;  // Compared case-insensitively with change records
+
+    HANDLE m_directory;
+    HANDLE m_changeEvent;  // Completes the overlapped directory read
+    HANDLE m_stopEvent;
+    std::thread m_worker;
+
+    // Change records land here; DWORD-aligned as ReadDirectoryChangesW requires
+    DWORD m_buffer[1024];
+
+    void Run();
+    bool MentionsConfigFile(DWORD bytes) const;
+    void CloseHandles();
+};
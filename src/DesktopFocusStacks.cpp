@@ -0,0 +1,183 @@
+#include "DesktopFocusStacks.h"
+
+DesktopFocusStacks::DesktopFocusStacks(int maxDesktops, int maxMonitors, size_t perMonitorCapacity)
+    : m_engine((maxDesktops < 1 ? 1 : maxDesktops) * (maxMonitors < 1 ? 1 : maxMonitors), perMonitorCapacity)
+    , m_maxMonitors(maxMonitors < 1 ? 1 : maxMonitors)
+    , m_currentRow(0)
+    , m_tick(0)
+{
+    m_rows.resize(static_cast<size_t>(maxDesktops < 1 ? 1 : maxDesktops));
+    Clear();
+}
+
+void DesktopFocusStacks::Clear() {
+    m_engine.Clear();
+    for (Row& row : m_rows) {
+        row.desktop = 0;
+        row.used = false;
+        row.lastCurrent = 0;
+    }
+
+    // Until someone says otherwise, the current desktop is the unknown one
+    m_currentRow = 0;
+    m_rows[0].used = true;
+    m_rows[0].lastCurrent = ++m_tick;
+}
+
+int DesktopFocusStacks::FindRow(DesktopId desktop) const {
+    for (size_t i = 0; i < m_rows.size(); ++i) {
+        if (m_rows[i].used && m_rows[i].desktop == desktop) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int DesktopFocusStacks::AcquireRow(DesktopId desktop) {
+    int row = FindRow(desktop);
+    if (row >= 0) {
+        return row;
+    }
+
+    // A free row, else the one that was current longest ago
+    int victim = -1;
+    for (size_t i = 0; i < m_rows.size(); ++i) {
+        int candidate = static_cast<int>(i);
+        if (candidate == m_currentRow) {
+            continue;
+        }
+        if (!m_rows[i].used) {
+            victim = candidate;
+            break;
+        }
+        if (victim < 0 || m_rows[i].lastCurrent < m_rows[victim].lastCurrent) {
+            victim = candidate;
+        }
+    }
+
+    if (victim < 0) {
+        return m_currentRow;  // A single row: every desktop shares it
+    }
+
+    DropRow(victim);
+    m_rows[victim].desktop = desktop;
+    m_rows[victim].used = true;
+    m_rows[victim].lastCurrent = ++m_tick;
+    return victim;
+}
+
+int DesktopFocusStacks::GetRowFor(DesktopId desktop) {
+    return desktop == 0 ? m_currentRow : AcquireRow(desktop);
+}
+
+void DesktopFocusStacks::DropRow(int row) {
+    for (int monitorIndex = 0; monitorIndex < m_maxMonitors; ++monitorIndex) {
+        int stackIndex = GetStackIndex(row, monitorIndex);
+        while (WindowKey window = m_engine.GetTop(stackIndex)) {
+            m_engine.Remove(window);
+        }
+    }
+    m_rows[row].used = false;
+}
+
+bool DesktopFocusStacks::SetCurrentDesktop(DesktopId desktop) {
+    if (desktop == 0 || m_rows[m_currentRow].desktop == desktop) {
+        return false;
+    }
+
+    // The unknown desktop we were on turns out to be this one: same windows, new name
+    if (m_rows[m_currentRow].desktop == 0 && FindRow(desktop) < 0) {
+        m_rows[m_currentRow].desktop = desktop;
+        return true;
+    }
+
+    m_currentRow = AcquireRow(desktop);
+    m_rows[m_currentRow].desktop = desktop;  // Only differs with a single row, which every desktop shares
+    m_rows[m_currentRow].lastCurrent = ++m_tick;
+    return true;
+}
+
+bool DesktopFocusStacks::Promote(WindowKey window, int monitorIndex, DesktopId desktop) {
+    if (!IsValidMonitor(monitorIndex)) {
+        return false;
+    }
+    return m_engine.Promote(window, GetStackIndex(GetRowFor(desktop), monitorIndex));
+}
+
+bool DesktopFocusStacks::Append(WindowKey window, int monitorIndex, DesktopId desktop) {
+    if (!IsValidMonitor(monitorIndex)) {
+        return false;
+    }
+    return m_engine.Append(window, GetStackIndex(GetRowFor(desktop), monitorIndex));
+}
+
+bool DesktopFocusStacks::MoveToMonitor(WindowKey window, int monitorIndex, bool toFront) {
+    int stackIndex = m_engine.GetMonitorOf(window);
+    if (stackIndex < 0 || !IsValidMonitor(monitorIndex)) {
+        return false;
+    }
+    return m_engine.MoveToMonitor(window, GetStackIndex(stackIndex / m_maxMonitors, monitorIndex), toFront);
+}
+
+bool DesktopFocusStacks::SetWindowDesktop(WindowKey window, DesktopId desktop) {
+    if (!m_engine.Contains(window)) {
+        return false;
+    }
+
+    // Row first: taking a row for a new desktop may drop windows, this one included
+    int row = GetRowFor(desktop);
+    int stackIndex = m_engine.GetMonitorOf(window);
+    if (stackIndex < 0) {
+        return true;  // Dropped along with its old row
+    }
+    if (stackIndex / m_maxMonitors == row) {
+        return false;
+    }
+
+    return m_engine.MoveToMonitor(window, GetStackIndex(row, stackIndex % m_maxMonitors), false);
+}
+
+int DesktopFocusStacks::Remove(WindowKey window) {
+    int stackIndex = m_engine.Remove(window);
+    return stackIndex >= 0 ? stackIndex % m_maxMonitors : -1;
+}
+
+bool DesktopFocusStacks::RemoveFromMonitor(int monitorIndex, WindowKey window) {
+    if (GetMonitorOf(window) != monitorIndex || monitorIndex < 0) {
+        return false;
+    }
+    return m_engine.Remove(window) >= 0;
+}
+
+int DesktopFocusStacks::GetMonitorOf(WindowKey window) const {
+    int stackIndex = m_engine.GetMonitorOf(window);
+    return stackIndex >= 0 ? stackIndex % m_maxMonitors : -1;
+}
+
+DesktopId DesktopFocusStacks::GetDesktopOf(WindowKey window) const {
+    int stackIndex = m_engine.GetMonitorOf(window);
+    return stackIndex >= 0 ? m_rows[stackIndex / m_maxMonitors].desktop : 0;
+}
+
+void DesktopFocusStacks::CopyWindows(std::vector<WindowKey>* windows) const {
+    windows->clear();
+    for (int stackIndex = 0; stackIndex < m_engine.GetMaxMonitors(); ++stackIndex) {
+        m_engine.ForEachInStack(stackIndex, [windows](WindowKey window) { windows->push_back(window); });
+    }
+}
+
+WindowKey DesktopFocusStacks::GetTop(int monitorIndex) const {
+    return IsValidMonitor(monitorIndex) ? m_engine.GetTop(GetStackIndex(m_currentRow, monitorIndex)) : 0;
+}
+
+size_t DesktopFocusStacks::GetStackSize(int monitorIndex) const {
+    return IsValidMonitor(monitorIndex) ? m_engine.GetStackSize(GetStackIndex(m_currentRow, monitorIndex)) : 0;
+}
+
+size_t DesktopFocusStacks::GetDesktopCount() const {
+    size_t count = 0;
+    for (const Row& row : m_rows) {
+        count += row.used;
+    }
+    return count;
+}
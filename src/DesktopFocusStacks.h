@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DesktopProvider.h"
+#include "FocusStackEngine.h"
+
+// Focus stacks per (virtual desktop, monitor).
+//
+// Each known desktop owns a row of per-monitor stacks in one FocusStackEngine,
+// so a window is still tracked in exactly one stack, with one handle and one
+// state word. The row a window sits in is its cached desktop; it only changes
+// when the caller reports a move (SetWindowDesktop) or focuses the window.
+//
+// Per-monitor lookups (GetTop, ForEachInStack, ...) see the current desktop's
+// row and never visit windows on other desktops. Desktop 0 ("unknown") always
+// means the current desktop, so without virtual desktops this behaves like a
+// plain FocusStackEngine.
+//
+// Rows are allocated up front. A desktop beyond maxDesktops takes the row of
+// the one that was current longest ago, whose windows are dropped.
+//
+// Not thread-safe; callers serialize. Handle checks through GetRegistry() are
+// the exception, see WindowRegistry.
+class DesktopFocusStacks {
+public:
+    DesktopFocusStacks(int maxDesktops, int maxMonitors, size_t perMonitorCapacity);
+
+    bool SetCurrentDesktop(DesktopId desktop);  // True if it changed; 0 is ignored
+    DesktopId GetCurrentDesktop() const { return m_rows[m_currentRow].desktop; }
+
+    // desktop: where the window lives, 0 for the current desktop
+    bool Promote(WindowKey window, int monitorIndex, DesktopId desktop);  // Move to top of that stack
+    bool Append(WindowKey window, int monitorIndex, DesktopId desktop);  // Below everything; false if tracked or full
+    bool MoveToMonitor(WindowKey window, int monitorIndex, bool toFront);  // Same desktop; see FocusStackEngine
+    bool SetWindowDesktop(WindowKey window, DesktopId desktop);  // Same monitor, at the bottom; false if unchanged
+    int Remove(WindowKey window);  // From any desktop, returns former monitor or -1
+    bool RemoveFromMonitor(int monitorIndex, WindowKey window);  // Whichever desktop it is on
+    void Clear();
+
+    bool Contains(WindowKey window) const { return m_engine.Contains(window); }
+    int GetMonitorOf(WindowKey window) const;  // -1 if not tracked
+    DesktopId GetDesktopOf(WindowKey window) const;  // Cached; 0 if not tracked or unknown
+    void CopyWindows(std::vector<WindowKey>* windows) const;  // Every desktop
+
+    // Current desktop only
+    WindowKey GetTop(int monitorIndex) const;  // 0 if the stack is empty
+    size_t GetStackSize(int monitorIndex) const;
+
+    size_t GetTrackedCount() const { return m_engine.GetTrackedCount(); }
+    size_t GetDesktopCount() const;  // Rows in use
+    int GetMaxDesktops() const { return static_cast<int>(m_rows.size()); }
+
+    WindowHandle GetHandle(WindowKey window) const { return m_engine.GetHandle(window); }
+    bool SetState(WindowKey window, uint32_t state) { return m_engine.SetState(window, state); }
+    uint32_t GetState(WindowKey window) const { return m_engine.GetState(window); }
+    const WindowRegistry& GetRegistry() const { return m_engine.GetRegistry(); }
+
+    // Visit a monitor's stack on the current desktop in MRU order
+    template <typename Fn>
+    void ForEachInStack(int monitorIndex, Fn&& fn) const {
+        if (IsValidMonitor(monitorIndex)) {
+            m_engine.ForEachInStack(GetStackIndex(m_currentRow, monitorIndex), fn);
+        }
+    }
+
+    // Same, with each window's handle
+    template <typename Fn>
+    void ForEachHandleInStack(int monitorIndex, Fn&& fn) const {
+        if (IsValidMonitor(monitorIndex)) {
+            m_engine.ForEachHandleInStack(GetStackIndex(m_currentRow, monitorIndex), fn);
+        }
+    }
+
+private:
+    struct Row {
+        DesktopId desktop;
+        bool used;
+        uint64_t lastCurrent;  // m_tick when it was last current or taken
+    };
+
+    FocusStackEngine m_engine;  // Stack index = row * m_maxMonitors + monitor
+    std::vector<Row> m_rows;
+    int m_maxMonitors;
+    int m_currentRow;
+    uint64_t m_tick;
+
+    bool IsValidMonitor(int monitorIndex) const { return monitorIndex >= 0 && monitorIndex < m_maxMonitors; }
+    int GetStackIndex(int row, int monitorIndex) const { return row * m_maxMonitors + monitorIndex; }
+
+    int FindRow(DesktopId desktop) const;  // -1 if the desktop has none
+    int AcquireRow(DesktopId desktop);  // Finds or takes one, never the current row
+    int GetRowFor(DesktopId desktop);  // 0 = the current row
+    void DropRow(int row);
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "WindowRegistry.h"
+
+// Virtual desktop identity (a hash of the desktop's GUID on Windows). Zero is
+// reserved as "unknown": no virtual desktops, a window pinned to all of them,
+// or a query that failed.
+using DesktopId = uint64_t;
+
+// Which virtual desktop is current and which one a window lives on.
+//
+// Answers may take a cross-process call, so callers query outside their
+// locks and cache the results. Call from one thread.
+//
+// GetWindowDesktop() takes the current desktop as the caller last read it
+// (0 if unknown), only to tell windows pinned to every desktop apart; a
+// refresh reads the current desktop once, not once per window.
+class DesktopProvider {
+public:
+    virtual ~DesktopProvider() {}
+
+    virtual DesktopId GetCurrentDesktop() = 0;  // 0 if unknown
+    virtual DesktopId GetWindowDesktop(WindowKey window, DesktopId current) = 0;  // 0 if unknown or pinned
+};
+
+// The platform's provider: the shell's virtual desktop manager on Windows.
+// Elsewhere every answer is 0, i.e. a single desktop.
+std::unique_ptr<DesktopProvider> CreateDesktopProvider();
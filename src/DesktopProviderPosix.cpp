@@ -0,0 +1,13 @@
+#include "DesktopProvider.h"
+
+// POSIX backend: the core has no window system here, so one desktop
+
+class SingleDesktopProvider : public DesktopProvider {
+public:
+    DesktopId GetCurrentDesktop() override { return 0; }
+    DesktopId GetWindowDesktop(WindowKey, DesktopId) override { return 0; }
+};
+
+std::unique_ptr<DesktopProvider> CreateDesktopProvider() {
+    return std::unique_ptr<DesktopProvider>(new SingleDesktopProvider());
+}
@@ -0,0 +1,112 @@
+#include "DesktopProvider.h"
+#include <windows.h>
+#include <shobjidl.h>
+#include <cstring>
+#include <string>
+
+// Win32 backend: IVirtualDesktopManager for a window's desktop. There is no
+// public call for the current desktop; Explorer records it in the registry,
+// per session before Windows 11. The value is missing until a second desktop
+// is created; until then the foreground window's desktop is the only one.
+
+static const wchar_t* const VIRTUAL_DESKTOPS_KEY = L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops";
+static const wchar_t* const SESSION_INFO_KEY = L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\SessionInfo\\";
+
+static DesktopId HashDesktopGuid(const GUID& guid) {
+    uint64_t halves[2];
+    std::memcpy(halves, &guid, sizeof(halves));
+    if ((halves[0] | halves[1]) == 0) {
+        return 0;  // GUID_NULL: not assigned to a desktop yet
+    }
+
+    uint64_t h = halves[0] ^ (halves[1] * 0x9E3779B97F4A7C15ull);
+    return h != 0 ? h : 1;
+}
+
+static bool ReadDesktopGuid(const std::wstring& key, GUID* guid) {
+    DWORD size = sizeof(*guid);
+    return RegGetValueW(HKEY_CURRENT_USER, key.c_str(), L"CurrentVirtualDesktop", RRF_RT_REG_BINARY, nullptr, guid,
+                        &size) == ERROR_SUCCESS && size == sizeof(*guid);
+}
+
+class ShellDesktopProvider : public DesktopProvider {
+public:
+    ShellDesktopProvider();
+    ~ShellDesktopProvider();
+
+    DesktopId GetCurrentDesktop() override;
+    DesktopId GetWindowDesktop(WindowKey window, DesktopId current) override;
+
+private:
+    IVirtualDesktopManager* m_manager;  // nullptr before Windows 10 or if creation failed
+    bool m_created;  // Creation was attempted
+
+    IVirtualDesktopManager* GetManager();
+};
+
+ShellDesktopProvider::ShellDesktopProvider()
+    : m_manager(nullptr)
+    , m_created(false) {
+}
+
+ShellDesktopProvider::~ShellDesktopProvider() {
+    if (m_manager != nullptr) {
+        m_manager->Release();
+    }
+}
+
+IVirtualDesktopManager* ShellDesktopProvider::GetManager() {
+    // Created on the first caller's thread, in the MTA so releasing it later needs no marshaling
+    if (!m_created) {
+        m_created = true;
+        HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        if (SUCCEEDED(hr) || hr == RPC_E_CHANGED_MODE) {
+            if (FAILED(CoCreateInstance(CLSID_VirtualDesktopManager, nullptr, CLSCTX_ALL, IID_PPV_ARGS(&m_manager)))) {
+                m_manager = nullptr;
+            }
+        }
+    }
+    return m_manager;
+}
+
+DesktopId ShellDesktopProvider::GetCurrentDesktop() {
+    GUID guid;
+    if (ReadDesktopGuid(VIRTUAL_DESKTOPS_KEY, &guid)) {
+        return HashDesktopGuid(guid);
+    }
+
+    DWORD session = 0;
+    if (ProcessIdToSessionId(GetCurrentProcessId(), &session) &&
+        ReadDesktopGuid(SESSION_INFO_KEY + std::to_wstring(session) + L"\\VirtualDesktops", &guid)) {
+        return HashDesktopGuid(guid);
+    }
+
+    IVirtualDesktopManager* manager = GetManager();
+    if (manager != nullptr && SUCCEEDED(manager->GetWindowDesktopId(GetForegroundWindow(), &guid))) {
+        return HashDesktopGuid(guid);
+    }
+    return 0;
+}
+
+DesktopId ShellDesktopProvider::GetWindowDesktop(WindowKey window, DesktopId current) {
+    IVirtualDesktopManager* manager = GetManager();
+    HWND hwnd = reinterpret_cast<HWND>(window);
+    GUID guid;
+    if (manager == nullptr || FAILED(manager->GetWindowDesktopId(hwnd, &guid))) {
+        return 0;
+    }
+    DesktopId desktop = HashDesktopGuid(guid);
+
+    // A pinned window reports a desktop of its own but shows on every one:
+    // "on the current desktop" while not on the current desktop's id
+    BOOL onCurrent = FALSE;
+    if (desktop != 0 && current != 0 && desktop != current &&
+        SUCCEEDED(manager->IsWindowOnCurrentVirtualDesktop(hwnd, &onCurrent)) && onCurrent) {
+        return 0;
+    }
+    return desktop;
+}
+
+std::unique_ptr<DesktopProvider> CreateDesktopProvider() {
+    return std::unique_ptr<DesktopProvider>(new ShellDesktopProvider());
+}
@@ -0,0 +1,151 @@
+#include "EventLoop.h"
+
+EventLoop::EventLoop()
+    : m_backend(CreateBackend())
+    , m_pendingSignals(0)
+    , m_nextTimerId(1)
+    , m_stopRequested(false)
+    , m_wakeups(0) {
+}
+
+EventLoop::~EventLoop() {
+    DestroyBackend(m_backend);
+}
+
+EventLoop::SignalId EventLoop::AddSignal(Callback callback) {
+    if (m_signals.size() >= MAX_SIGNALS) {
+        return -1;
+    }
+
+    m_signals.push_back(callback);
+    return static_cast<SignalId>(m_signals.size()) - 1;
+}
+
+void EventLoop::Notify(SignalId signal) {
+    uint32_t bit = 1u << signal;
+
+    // Already pending: the loop will see it, no need for another RMW or wakeup.
+    // Pairs with the claim in DispatchSignals: the caller's queue push may not be
+    // reordered after this load, or the loop could claim the bit, find the
+    // queue empty and leave our record waiting for an unrelated Notify().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_pendingSignals.load(std::memory_order_relaxed) & bit) {
+        return;
+    }
+
+    if (m_pendingSignals.fetch_or(bit, std::memory_order_acq_rel) == 0) {
+        Wake();
+    }
+}
+
+EventLoop::TimerId EventLoop::AddTimer(std::chrono::milliseconds delay, bool repeating, Callback callback) {
+    Timer timer;
+    timer.id = m_nextTimerId++;
+    timer.due = std::chrono::steady_clock::now() + delay;
+    timer.interval = delay;
+    timer.repeating = repeating;
+    timer.callback = callback;
+
+    m_timers.push_back(timer);
+    return timer.id;
+}
+
+void EventLoop::CancelTimer(TimerId timer) {
+    for (size_t i = 0; i < m_timers.size(); ++i) {
+        if (m_timers[i].id == timer) {
+            m_timers.erase(m_timers.begin() + i);
+            return;
+        }
+    }
+}
+
+void EventLoop::RequestStop() {
+    m_stopRequested.store(true, std::memory_order_release);
+    Wake();
+}
+
+int EventLoop::GetTimeoutMs() const {
+    if (m_timers.empty()) {
+        return -1;
+    }
+
+    std::chrono::steady_clock::time_point next = m_timers[0].due;
+    for (const Timer& timer : m_timers) {
+        if (timer.due < next) {
+            next = timer.due;
+        }
+    }
+
+    // Round up so we never wake a hair before the timer is due and spin
+    std::chrono::steady_clock::duration remaining = next - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero()) {
+        return 0;
+    }
+
+    int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        remaining + std::chrono::milliseconds(1) - std::chrono::nanoseconds(1)).count();
+    return ms > 0x7FFFFFFF ? 0x7FFFFFFF : static_cast<int>(ms);
+}
+
+void EventLoop::DispatchSignals() {
+    // Claim everything raised so far; later Notify() calls wake us again
+    uint32_t pending = m_pendingSignals.exchange(0, std::memory_order_seq_cst);
+
+    for (size_t i = 0; pending != 0 && i < m_signals.size(); ++i) {
+        if (pending & (1u << i)) {
+            pending &= ~(1u << i);
+            m_signals[i]();
+        }
+    }
+}
+
+void EventLoop::RunDueTimers() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    // Collect ids first: callbacks may add or cancel timers, including ones due in this pass
+    std::vector<TimerId> due;
+    for (const Timer& timer : m_timers) {
+        if (timer.due <= now) {
+            due.push_back(timer.id);
+        }
+    }
+
+    for (TimerId id : due) {
+        // Look it up again; an earlier callback may have cancelled it
+        size_t i = 0;
+        while (i < m_timers.size() && m_timers[i].id != id) {
+            ++i;
+        }
+        if (i == m_timers.size()) {
+            continue;
+        }
+
+        Callback callback = m_timers[i].callback;
+        if (m_timers[i].repeating) {
+            m_timers[i].due = now + m_timers[i].interval;
+        } else {
+            m_timers.erase(m_timers.begin() + i);
+        }
+        callback();
+    }
+}
+
+void EventLoop::Run() {
+    if (m_backend == nullptr) {
+        return;
+    }
+
+    while (!IsStopRequested()) {
+        if (!WaitForWork(GetTimeoutMs())) {
+            break;  // WM_QUIT
+        }
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+
+        if (IsStopRequested()) {
+            break;
+        }
+
+        DispatchSignals();
+        RunDueTimers();
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Blocking event loop for one thread.
+//
+// Run() sleeps in the kernel until there is work: a signal raised from any
+// thread, a due timer, a stop request or (Win32 backend) a window message
+// for this thread. There is no polling, so an idle loop never wakes up.
+//
+// Backends: MsgWaitForMultipleObjectsEx + auto-reset event on Windows,
+// epoll + eventfd on Linux.
+class EventLoop {
+public:
+    typedef std::function<void()> Callback;
+    typedef int SignalId;
+    typedef int TimerId;
+
+    static const int MAX_SIGNALS = 32;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool IsValid() const { return m_backend != nullptr; }
+
+    // Register a callback run on the loop thread after Notify(); returns -1 when full.
+    // Register before Run() or from the loop thread.
+    SignalId AddSignal(Callback callback);
+
+    // Any thread. Notifications coalesce until the loop runs the callback;
+    // only the first one after that costs a kernel wakeup.
+    void Notify(SignalId signal);
+
+    // Loop thread only
+    TimerId AddTimer(std::chrono::milliseconds delay, bool repeating, Callback callback);
+    void CancelTimer(TimerId timer);
+
+    // Any thread, including console control handlers
+    void RequestStop();
+    bool IsStopRequested() const { return m_stopRequested.load(std::memory_order_acquire); }
+
+    // Returns on RequestStop() or WM_QUIT (Win32)
+    void Run();
+
+    // Kernel wakeups taken so far (for idle-wakeup accounting)
+    uint64_t GetWakeupCount() const { return m_wakeups.load(std::memory_order_relaxed); }
+
+private:
+    struct Backend;  // Defined by the platform implementation
+
+    struct Timer {
+        TimerId id;
+        std::chrono::steady_clock::time_point due;
+        std::chrono::milliseconds interval;
+        bool repeating;
+        Callback callback;
+    };
+
+    Backend* m_backend;
+    std::vector<Callback> m_signals;
+    std::atomic<uint32_t> m_pendingSignals;
+    std::vector<Timer> m_timers;
+    TimerId m_nextTimerId;
+    std::atomic<bool> m_stopRequested;
+    std::atomic<uint64_t> m_wakeups;
+
+    int GetTimeoutMs() const;  // -1 = infinite
+    void DispatchSignals();
+    void RunDueTimers();
+
+    // Platform backend
+    static Backend* CreateBackend();
+    static void DestroyBackend(Backend* backend);
+    bool WaitForWork(int timeoutMs);  // Returns false if the thread was asked to quit
+    void Wake();
+};
@@ -0,0 +1,70 @@
+#include "EventLoop.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Linux backend: epoll over a single eventfd used for signals and stop
+
+struct EventLoop::Backend {
+    int epollFd;
+    int eventFd;
+};
+
+EventLoop::Backend* EventLoop::CreateBackend() {
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        return nullptr;
+    }
+
+    int eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd < 0) {
+        close(epollFd);
+        return nullptr;
+    }
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = eventFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, eventFd, &event) != 0) {
+        close(eventFd);
+        close(epollFd);
+        return nullptr;
+    }
+
+    Backend* backend = new Backend();
+    backend->epollFd = epollFd;
+    backend->eventFd = eventFd;
+    return backend;
+}
+
+void EventLoop::DestroyBackend(Backend* backend) {
+    if (backend != nullptr) {
+        close(backend->eventFd);
+        close(backend->epollFd);
+        delete backend;
+    }
+}
+
+bool EventLoop::WaitForWork(int timeoutMs) {
+    epoll_event events[4];
+    int count = epoll_wait(m_backend->epollFd, events, 4, timeoutMs);
+
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.fd == m_backend->eventFd) {
+            // Reset the counter; pending signal bits say what to run
+            uint64_t value;
+            ssize_t ignored = read(m_backend->eventFd, &value, sizeof(value));
+            (void)ignored;
+        }
+    }
+
+    return true;
+}
+
+void EventLoop::Wake() {
+    if (m_backend != nullptr) {
+        uint64_t one = 1;
+        ssize_t ignored = write(m_backend->eventFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
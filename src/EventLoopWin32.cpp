@@ -0,0 +1,53 @@
+#include "EventLoop.h"
+#include <windows.h>
+
+// Win32 backend: one auto-reset event for signals/stop, plus the thread's
+// message queue via MsgWaitForMultipleObjectsEx
+
+struct EventLoop::Backend {
+    HANDLE wakeEvent;
+};
+
+EventLoop::Backend* EventLoop::CreateBackend() {
+    HANDLE wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (wakeEvent == nullptr) {
+        return nullptr;
+    }
+
+    Backend* backend = new Backend();
+    backend->wakeEvent = wakeEvent;
+    return backend;
+}
+
+void EventLoop::DestroyBackend(Backend* backend) {
+    if (backend != nullptr) {
+        CloseHandle(backend->wakeEvent);
+        delete backend;
+    }
+}
+
+bool EventLoop::WaitForWork(int timeoutMs) {
+    // MWMO_INPUTAVAILABLE: also return for messages that were already queued
+    // before we started waiting, not just newly arrived ones
+    MsgWaitForMultipleObjectsEx(1, &m_backend->wakeEvent,
+                                timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs),
+                                QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+    // Dispatch everything queued for this thread (hotkeys, tray, WinEvent callbacks)
+    MSG msg;
+    while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+        if (msg.message == WM_QUIT) {
+            return false;
+        }
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
+    }
+
+    return true;
+}
+
+void EventLoop::Wake() {
+    if (m_backend != nullptr) {
+        SetEvent(m_backend->wakeEvent);
+    }
+}
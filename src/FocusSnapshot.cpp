@@ -0,0 +1,196 @@
+#include "FocusSnapshot.h"
+#include <atomic>
+#include <cstring>
+#include "Hash.h"
+
+static const char SNAPSHOT_MAGIC[8] = { 'T', 'R', 'S', 'N', 'A', 'P', '1', '\0' };
+
+struct SnapshotFileHeader {
+    char magic[8];
+    uint32_t slotSize;
+    uint32_t reserved;
+};
+
+struct SnapshotSlot {
+    uint64_t sequence;  // 0 = never written
+    uint32_t count;
+    uint32_t checksum;  // Over sequence, count and the used entries
+    SnapshotEntry entries[FocusSnapshotFile::MAX_ENTRIES];
+};
+
+static const size_t SNAPSHOT_FILE_SIZE = sizeof(SnapshotFileHeader) + 2 * sizeof(SnapshotSlot);
+
+static uint32_t ComputeChecksum(const SnapshotSlot& slot, uint64_t sequence) {
+    uint32_t hash = HashFnv32(&sequence, sizeof(sequence));
+    hash = HashFnv32(&slot.count, sizeof(slot.count), hash);
+    return HashFnv32(slot.entries, slot.count * sizeof(SnapshotEntry), hash);
+}
+
+static bool IsSlotValid(const SnapshotSlot& slot) {
+    return slot.sequence != 0 && slot.count <= static_cast<uint32_t>(FocusSnapshotFile::MAX_ENTRIES) &&
+           slot.checksum == ComputeChecksum(slot, slot.sequence);
+}
+
+bool FocusSnapshotFile::Open(const std::string& path) {
+    Close();
+
+    if (!m_file.OpenReadWrite(path, SNAPSHOT_FILE_SIZE)) {
+        return false;
+    }
+
+    // New file, or one from an incompatible build: start over
+    SnapshotFileHeader* header = reinterpret_cast<SnapshotFileHeader*>(m_file.GetData());
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header->slotSize != sizeof(SnapshotSlot)) {
+        std::memset(m_file.GetData(), 0, SNAPSHOT_FILE_SIZE);
+        std::memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header->slotSize = sizeof(SnapshotSlot);
+    }
+
+    return true;
+}
+
+void FocusSnapshotFile::Close() {
+    m_file.Close();
+}
+
+bool FocusSnapshotFile::Write(const std::vector<SnapshotEntry>& entries) {
+    if (!m_file.IsOpen()) {
+        return false;
+    }
+
+    SnapshotSlot* slots = reinterpret_cast<SnapshotSlot*>(m_file.GetData() + sizeof(SnapshotFileHeader));
+
+    // Overwrite the older (or broken) slot, never the newest valid one
+    bool valid0 = IsSlotValid(slots[0]);
+    bool valid1 = IsSlotValid(slots[1]);
+    uint64_t newest = 0;
+    int target = 0;
+    if (valid0 && valid1) {
+        target = slots[0].sequence < slots[1].sequence ? 0 : 1;
+        newest = slots[1 - target].sequence;
+    } else if (valid0) {
+        target = 1;
+        newest = slots[0].sequence;
+    } else if (valid1) {
+        newest = slots[1].sequence;
+    }
+
+    SnapshotSlot& slot = slots[target];
+    uint32_t count = static_cast<uint32_t>(entries.size() < static_cast<size_t>(MAX_ENTRIES) ? entries.size() : MAX_ENTRIES);
+
+    // Invalidate first, fill, then publish the sequence
+    slot.sequence = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.count = count;
+    if (count > 0) {
+        std::memcpy(slot.entries, entries.data(), count * sizeof(SnapshotEntry));
+    }
+    slot.checksum = ComputeChecksum(slot, newest + 1);
+
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sequence = newest + 1;
+    return true;
+}
+
+bool FocusSnapshotFile::Read(std::vector<SnapshotEntry>* entries) const {
+    entries->clear();
+    if (!m_file.IsOpen()) {
+        return false;
+    }
+
+    const SnapshotSlot* slots = reinterpret_cast<const SnapshotSlot*>(m_file.GetData() + sizeof(SnapshotFileHeader));
+    const SnapshotSlot* best = nullptr;
+    for (int i = 0; i < 2; ++i) {
+        if (IsSlotValid(slots[i]) && (best == nullptr || slots[i].sequence > best->sequence)) {
+            best = &slots[i];
+        }
+    }
+
+    if (best == nullptr) {
+        return false;
+    }
+
+    entries->assign(best->entries, best->entries + best->count);
+    return true;
+}
+
+SnapshotMatcher::SnapshotMatcher(const std::vector<SnapshotEntry>& entries)
+    : m_entries(entries) {
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const WindowIdentity& identity = m_entries[i].identity;
+        if (identity.windowHint != 0) {
+            m_byHint[identity.windowHint] = static_cast<int>(i);
+        }
+        m_byIdentity[GetIdentityKey(identity)].push_back(static_cast<int>(i));
+    }
+}
+
+uint64_t SnapshotMatcher::GetIdentityKey(const WindowIdentity& identity) {
+    uint64_t hash = HashFnv64(&identity.processHash, sizeof(identity.processHash));
+    hash = HashFnv64(&identity.classHash, sizeof(identity.classHash), hash);
+    return HashFnv64(&identity.titleHash, sizeof(identity.titleHash), hash);
+}
+
+std::vector<int> SnapshotMatcher::Match(const std::vector<LiveWindow>& windows, const IdentityFetcher& fetchIdentity) {
+    std::vector<int> result(windows.size(), -1);
+    std::vector<bool> claimed(m_entries.size(), false);
+    size_t unclaimed = m_entries.size();
+
+    // Pass 1: same handle, process and class is the very same window (titles change)
+    for (size_t i = 0; i < windows.size(); ++i) {
+        std::unordered_map<uint64_t, int>::const_iterator hint = m_byHint.find(static_cast<uint64_t>(windows[i].window));
+        if (hint == m_byHint.end() || claimed[hint->second]) {
+            continue;
+        }
+
+        const SnapshotEntry& stored = m_entries[hint->second];
+        if (stored.processId != 0 && stored.processId == windows[i].processId &&
+            stored.identity.classHash == windows[i].classHash) {
+            claimed[hint->second] = true;
+            result[i] = hint->second;
+            --unclaimed;
+        }
+    }
+
+    // Classes some unclaimed entry has; other windows are never fetched
+    std::unordered_map<uint32_t, size_t> wantedClasses;
+    for (size_t index = 0; index < m_entries.size(); ++index) {
+        if (!claimed[index]) {
+            ++wantedClasses[m_entries[index].identity.classHash];
+        }
+    }
+
+    // Pass 2: first unclaimed entry with the same process image, class and title
+    for (size_t i = 0; i < windows.size() && unclaimed > 0; ++i) {
+        if (result[i] >= 0) {
+            continue;
+        }
+
+        std::unordered_map<uint32_t, size_t>::iterator wanted = wantedClasses.find(windows[i].classHash);
+        WindowIdentity identity;
+        if (wanted == wantedClasses.end() || wanted->second == 0 || !fetchIdentity(windows[i], &identity)) {
+            continue;
+        }
+
+        std::unordered_map<uint64_t, std::vector<int>>::const_iterator bucket = m_byIdentity.find(GetIdentityKey(identity));
+        if (bucket == m_byIdentity.end()) {
+            continue;
+        }
+
+        for (int index : bucket->second) {
+            const WindowIdentity& stored = m_entries[index].identity;
+            if (!claimed[index] && stored.processHash == identity.processHash &&
+                stored.classHash == identity.classHash && stored.titleHash == identity.titleHash) {
+                claimed[index] = true;
+                result[i] = index;
+                --unclaimed;
+                --wanted->second;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "FocusStackEngine.h"
+#include "MappedFile.h"
+
+// Identity of a window that survives a restart of True Recall (or, minus
+// the handle, of the whole session)
+struct WindowIdentity {
+    uint64_t processHash;  // HashFnv64 of the lower-cased process image name
+    uint32_t classHash;    // HashFnv32 of the window class name
+    uint32_t titleHash;    // HashFnv32 of the title; 0 if untitled
+    uint64_t windowHint;   // HWND value when the snapshot was taken
+};
+
+struct SnapshotEntry {
+    WindowIdentity identity;
+    int16_t monitor;     // Stack the window was in
+    uint16_t rank;       // Position in that stack, 0 = most recent
+    uint32_t processId;  // Owner when the snapshot was taken; 0 if unknown
+};
+
+// Small memory-mapped file holding the latest focus stacks.
+//
+// Two slots, each with a sequence number and checksum. Write() fills the
+// older slot and stamps its sequence last, so a crash mid-write leaves the
+// previous snapshot intact; Read() returns the newest slot that verifies.
+// Single writer, not thread-safe.
+class FocusSnapshotFile {
+public:
+    static const int MAX_ENTRIES = 512;
+
+    bool Open(const std::string& path);  // Creates the file if missing
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    bool Write(const std::vector<SnapshotEntry>& entries);
+    bool Read(std::vector<SnapshotEntry>* entries) const;
+
+private:
+    MappedFile m_file;
+};
+
+// A window found by the startup enumeration, with only what is cheap to read
+struct LiveWindow {
+    WindowKey window;
+    uint32_t processId;
+    uint32_t classHash;
+};
+
+// Full identity of a live window; false if it is gone. Only asked for
+// windows the handle pass left unmatched whose class an entry still wants.
+typedef std::function<bool(const LiveWindow& window, WindowIdentity* identity)> IdentityFetcher;
+
+// Hash index from snapshot entries to the windows found by one enumeration
+// pass at startup. A window matches by handle when handle, process id and
+// class agree (True Recall restarted, window survived); the rest match by
+// process image, class and title (new session). Handle matches are made
+// first so a look-alike window never takes the entry of the real one. Each
+// entry is matched at most once.
+class SnapshotMatcher {
+public:
+    explicit SnapshotMatcher(const std::vector<SnapshotEntry>& entries);
+
+    // Entry index for each live window, -1 if none
+    std::vector<int> Match(const std::vector<LiveWindow>& windows, const IdentityFetcher& fetchIdentity);
+
+    const SnapshotEntry& GetEntry(int index) const { return m_entries[index]; }
+
+private:
+    std::vector<SnapshotEntry> m_entries;
+    std::unordered_map<uint64_t, int> m_byHint;
+    std::unordered_map<uint64_t, std::vector<int>> m_byIdentity;
+
+    static uint64_t GetIdentityKey(const WindowIdentity& identity);
+};
@@ -0,0 +1,215 @@
+#include "FocusSnapshotter.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "Hash.h"
+#include "Logger.h"
+#include "MonitorManager.h"
+#include "WindowTitleCache.h"
+
+FocusSnapshotter::FocusSnapshotter(MonitorManager* monitorManager)
+    : m_monitorManager(monitorManager)
+    , m_useCounter(0) {
+}
+
+bool FocusSnapshotter::Open(const std::string& path) {
+    if (!m_file.Open(path)) {
+        TR_LOG_WARN("Could not open focus snapshot {}", path);
+        return false;
+    }
+    return true;
+}
+
+uint64_t HashProcessImage(HWND hwnd) {
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (process == nullptr) {
+        return HashFnv64(&processId, sizeof(processId));  // Elevated process: the pid is the best we have
+    }
+
+    char path[MAX_PATH];
+    DWORD length = MAX_PATH;
+    uint64_t hash = 0;
+    if (QueryFullProcessImageNameA(process, 0, path, &length)) {
+        // Image name only, case-folded: installs move, names don't
+        std::string name(path, length);
+        size_t lastSlash = name.find_last_of("\\/");
+        if (lastSlash != std::string::npos) {
+            name = name.substr(lastSlash + 1);
+        }
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        hash = HashFnv64(name.data(), name.size());
+    }
+
+    CloseHandle(process);
+    return hash;
+}
+
+uint32_t HashWindowClass(HWND hwnd) {
+    char className[256];
+    int classLength = GetClassNameA(hwnd, className, sizeof(className));
+    return classLength > 0 ? HashFnv32(className, static_cast<size_t>(classLength)) : 0;
+}
+
+// The caption the system keeps for the window; never sends the owner a message
+static uint32_t HashWindowCaption(HWND hwnd) {
+    wchar_t title[WindowTitleCache::MAX_TITLE_LENGTH + 1];
+    int length = InternalGetWindowText(hwnd, title, WindowTitleCache::MAX_TITLE_LENGTH + 1);
+    return length > 0 ? HashFnv32(title, static_cast<size_t>(length) * sizeof(wchar_t)) : 0;
+}
+
+WindowIdentity FocusSnapshotter::GetIdentity(HWND hwnd, uint32_t processId) {
+    WindowKey key = reinterpret_cast<WindowKey>(hwnd);
+    WindowIdentity identity = {};
+    identity.windowHint = key;
+
+    std::unordered_map<WindowKey, CachedIdentity>::iterator cached = m_identityCache.find(key);
+    if (cached != m_identityCache.end() && cached->second.processId == processId) {
+        cached->second.lastUsed = ++m_useCounter;
+        identity.processHash = cached->second.processHash;
+        identity.classHash = cached->second.classHash;
+    } else {
+        identity.processHash = HashProcessImage(hwnd);
+        identity.classHash = HashWindowClass(hwnd);
+
+        if (cached == m_identityCache.end() && m_identityCache.size() >= MAX_CACHED_IDENTITIES) {
+            EvictLeastRecentlyUsed();
+        }
+        CachedIdentity entry = { processId, identity.classHash, identity.processHash, ++m_useCounter };
+        m_identityCache[key] = entry;
+    }
+
+    // Titles change all the time; read the same caption Restore() compares against
+    identity.titleHash = HashWindowCaption(hwnd);
+    return identity;
+}
+
+void FocusSnapshotter::EvictLeastRecentlyUsed() {
+    // Only past MAX_CACHED_IDENTITIES distinct windows, once per new one, so a linear scan is fine
+    std::unordered_map<WindowKey, CachedIdentity>::iterator oldest = m_identityCache.begin();
+    for (std::unordered_map<WindowKey, CachedIdentity>::iterator it = m_identityCache.begin();
+         it != m_identityCache.end(); ++it) {
+        if (it->second.lastUsed < oldest->second.lastUsed) {
+            oldest = it;
+        }
+    }
+    m_identityCache.erase(oldest);
+}
+
+void FocusSnapshotter::ForgetWindow(WindowKey window) {
+    m_identityCache.erase(window);
+}
+
+void FocusSnapshotter::Save() {
+    if (!m_file.IsOpen()) {
+        return;
+    }
+
+    std::vector<SnapshotEntry> entries;
+    std::vector<WindowKey> stack;
+
+    for (int monitorIndex = 0; monitorIndex < m_monitorManager->GetMonitorCount(); ++monitorIndex) {
+        m_monitorManager->CopyFocusStack(monitorIndex, &stack);
+
+        for (size_t rank = 0; rank < stack.size(); ++rank) {
+            HWND hwnd = reinterpret_cast<HWND>(stack[rank]);
+            DWORD processId = 0;
+            if (GetWindowThreadProcessId(hwnd, &processId) == 0) {
+                continue;  // Destroy event still queued
+            }
+
+            SnapshotEntry entry = {};
+            entry.identity = GetIdentity(hwnd, processId);
+            entry.processId = processId;
+            entry.monitor = static_cast<int16_t>(monitorIndex);
+            entry.rank = static_cast<uint16_t>(rank);
+            entries.push_back(entry);
+        }
+    }
+
+    m_file.Write(entries);
+    TR_LOG_TRACE("Focus snapshot saved ({} window(s))", entries.size());
+}
+
+static BOOL CALLBACK CollectVisibleWindowsProc(HWND hwnd, LPARAM lParam) {
+    std::vector<HWND>* windows = reinterpret_cast<std::vector<HWND>*>(lParam);
+    if (IsWindowVisible(hwnd)) {
+        windows->push_back(hwnd);
+    }
+    return TRUE;
+}
+
+void FocusSnapshotter::Restore() {
+    std::vector<SnapshotEntry> entries;
+    if (!m_file.IsOpen() || !m_file.Read(&entries) || entries.empty()) {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // One pass over the top-level windows, reading only what is local and cheap
+    std::vector<HWND> windows;
+    EnumWindows(CollectVisibleWindowsProc, reinterpret_cast<LPARAM>(&windows));
+
+    std::vector<LiveWindow> live(windows.size());
+    for (size_t i = 0; i < windows.size(); ++i) {
+        DWORD processId = 0;
+        GetWindowThreadProcessId(windows[i], &processId);
+        live[i].window = reinterpret_cast<WindowKey>(windows[i]);
+        live[i].processId = processId;
+        live[i].classHash = HashWindowClass(windows[i]);
+    }
+
+    // Image name and caption only for windows the handle pass could not place
+    size_t fetched = 0;
+    SnapshotMatcher matcher(entries);
+    std::vector<int> matches = matcher.Match(live, [&fetched](const LiveWindow& window, WindowIdentity* identity) {
+        HWND hwnd = reinterpret_cast<HWND>(window.window);
+        ++fetched;
+        identity->processHash = HashProcessImage(hwnd);
+        identity->classHash = window.classHash;
+        identity->titleHash = HashWindowCaption(hwnd);
+        identity->windowHint = window.window;
+        return true;
+    });
+
+    // Windows go to the monitor they are on now, in their saved order
+    struct Seed {
+        int monitor;
+        int rank;
+        WindowKey window;
+    };
+    std::vector<Seed> seeds;
+    for (size_t i = 0; i < windows.size(); ++i) {
+        if (matches[i] < 0) {
+            continue;
+        }
+
+        int monitorIndex = m_monitorManager->GetMonitorIndexForWindow(live[i].window);
+        if (monitorIndex >= 0) {
+            Seed seed = { monitorIndex, matcher.GetEntry(matches[i]).rank, live[i].window };
+            seeds.push_back(seed);
+        }
+    }
+
+    std::stable_sort(seeds.begin(), seeds.end(), [](const Seed& a, const Seed& b) {
+        return a.monitor != b.monitor ? a.monitor < b.monitor : a.rank < b.rank;
+    });
+
+    size_t seeded = 0;
+    std::vector<WindowKey> stack;
+    for (size_t i = 0; i < seeds.size(); ++i) {
+        stack.push_back(seeds[i].window);
+        if (i + 1 == seeds.size() || seeds[i + 1].monitor != seeds[i].monitor) {
+            seeded += m_monitorManager->SeedFocusStack(seeds[i].monitor, stack);
+            stack.clear();
+        }
+    }
+
+    int64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    TR_LOG_INFO("Restored {} of {} window(s) from the focus snapshot in {} us ({} of {} identities fetched)", seeded,
+                entries.size(), elapsedUs, fetched, windows.size());
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <windows.h>
+#include <string>
+#include <unordered_map>
+#include "FocusSnapshot.h"
+
+class MonitorManager;
+
+// Parts of a window's identity that never change while it exists; also
+// key the learned activation strategies
+uint64_t HashProcessImage(HWND hwnd);  // HashFnv64 of the lower-cased image name
+uint32_t HashWindowClass(HWND hwnd);   // HashFnv32 of the class name, 0 if unavailable
+
+// Persists the focus stacks so a restart starts warm. Runs on the focus
+// worker: Save() after focus changes (debounced by the caller), Restore()
+// once at startup, seeding stacks below anything already focused.
+class FocusSnapshotter {
+public:
+    explicit FocusSnapshotter(MonitorManager* monitorManager);
+
+    bool Open(const std::string& path);
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    void Restore();  // One EnumWindows pass against the saved snapshot
+    void Save();
+    void ForgetWindow(WindowKey window);  // EVENT_OBJECT_DESTROY
+
+private:
+    // Windows beyond this are forgotten, least recently used first
+    static const size_t MAX_CACHED_IDENTITIES = 1024;
+
+    // Process and class never change for a window; cache them between saves.
+    // The process id catches a recycled handle.
+    struct CachedIdentity {
+        uint32_t processId;
+        uint32_t classHash;
+        uint64_t processHash;
+        uint64_t lastUsed;
+    };
+
+    MonitorManager* m_monitorManager;
+    FocusSnapshotFile m_file;
+    std::unordered_map<WindowKey, CachedIdentity> m_identityCache;
+    uint64_t m_useCounter;
+
+    WindowIdentity GetIdentity(HWND hwnd, uint32_t processId);
+    void EvictLeastRecentlyUsed();
+};
@@ -0,0 +1,245 @@
+#include "FocusStackEngine.h"
+
+FocusStackEngine::FocusStackEngine(int maxMonitors, size_t perMonitorCapacity)
+    : m_registry(static_cast<size_t>(maxMonitors < 1 ? 1 : maxMonitors) * (perMonitorCapacity > 0 ? perMonitorCapacity : 1))
+    , m_perMonitorCapacity(perMonitorCapacity > 0 ? perMonitorCapacity : 1)
+{
+    if (maxMonitors < 1) {
+        maxMonitors = 1;
+    }
+
+    m_stacks.resize(static_cast<size_t>(maxMonitors));
+    m_slots.resize(m_registry.GetCapacity());
+
+    Clear();
+}
+
+void FocusStackEngine::Clear() {
+    for (StackList& stack : m_stacks) {
+        stack.head = NIL;
+        stack.tail = NIL;
+        stack.size = 0;
+    }
+
+    for (Slot& slot : m_slots) {
+        slot.window = 0;
+        slot.handle = 0;
+        slot.prev = NIL;
+        slot.next = NIL;
+        slot.monitor = -1;
+    }
+    m_registry.Clear();
+}
+
+uint32_t FocusStackEngine::FindSlot(WindowKey window) const {
+    WindowHandle handle = m_registry.Find(window);
+    return handle != 0 ? WindowRegistry::GetSlot(handle) : NIL;
+}
+
+uint32_t FocusStackEngine::AddSlot(WindowKey window) {
+    WindowHandle handle = m_registry.Register(window);
+    if (handle == 0) {
+        return NIL;
+    }
+
+    uint32_t slot = WindowRegistry::GetSlot(handle);
+    m_slots[slot].window = window;
+    m_slots[slot].handle = handle;
+    return slot;
+}
+
+void FocusStackEngine::LinkFront(uint32_t slot, int monitorIndex) {
+    StackList& stack = m_stacks[monitorIndex];
+    Slot& s = m_slots[slot];
+
+    s.monitor = monitorIndex;
+    s.prev = NIL;
+    s.next = stack.head;
+
+    if (stack.head != NIL) {
+        m_slots[stack.head].prev = slot;
+    } else {
+        stack.tail = slot;
+    }
+    stack.head = slot;
+    ++stack.size;
+}
+
+void FocusStackEngine::LinkBack(uint32_t slot, int monitorIndex) {
+    StackList& stack = m_stacks[monitorIndex];
+    Slot& s = m_slots[slot];
+
+    s.monitor = monitorIndex;
+    s.prev = stack.tail;
+    s.next = NIL;
+
+    if (stack.tail != NIL) {
+        m_slots[stack.tail].next = slot;
+    } else {
+        stack.head = slot;
+    }
+    stack.tail = slot;
+    ++stack.size;
+}
+
+void FocusStackEngine::Unlink(uint32_t slot) {
+    Slot& s = m_slots[slot];
+    StackList& stack = m_stacks[s.monitor];
+
+    if (s.prev != NIL) {
+        m_slots[s.prev].next = s.next;
+    } else {
+        stack.head = s.next;
+    }
+
+    if (s.next != NIL) {
+        m_slots[s.next].prev = s.prev;
+    } else {
+        stack.tail = s.prev;
+    }
+
+    s.prev = NIL;
+    s.next = NIL;
+    --stack.size;
+}
+
+void FocusStackEngine::ReleaseSlot(uint32_t slot) {
+    Unlink(slot);
+
+    // Every copy of its handle is dead from here on
+    Slot& s = m_slots[slot];
+    m_registry.Unregister(s.window);
+    s.window = 0;
+    s.handle = 0;
+    s.monitor = -1;
+}
+
+bool FocusStackEngine::Promote(WindowKey window, int monitorIndex) {
+    if (window == 0 || !IsValidMonitor(monitorIndex)) {
+        return false;
+    }
+
+    uint32_t slot = FindSlot(window);
+
+    if (slot != NIL) {
+        // Already tracked: relink at the head (possibly of another monitor)
+        if (m_stacks[monitorIndex].head == slot) {
+            return true;
+        }
+
+        bool changesMonitor = (m_slots[slot].monitor != monitorIndex);
+        Unlink(slot);
+
+        // Moving onto a full stack pushes that stack's oldest entry out
+        if (changesMonitor && m_stacks[monitorIndex].size >= m_perMonitorCapacity) {
+            ReleaseSlot(m_stacks[monitorIndex].tail);
+        }
+
+        LinkFront(slot, monitorIndex);
+        return true;
+    }
+
+    // New window: make room on this monitor first
+    if (m_stacks[monitorIndex].size >= m_perMonitorCapacity) {
+        ReleaseSlot(m_stacks[monitorIndex].tail);
+    }
+
+    slot = AddSlot(window);
+    if (slot == NIL) {
+        return false;
+    }
+    LinkFront(slot, monitorIndex);
+    return true;
+}
+
+bool FocusStackEngine::Append(WindowKey window, int monitorIndex) {
+    if (window == 0 || !IsValidMonitor(monitorIndex)) {
+        return false;
+    }
+
+    // Seeding never reorders or evicts what live focus events already put there
+    if (FindSlot(window) != NIL || m_stacks[monitorIndex].size >= m_perMonitorCapacity) {
+        return false;
+    }
+
+    uint32_t slot = AddSlot(window);
+    if (slot == NIL) {
+        return false;
+    }
+    LinkBack(slot, monitorIndex);
+    return true;
+}
+
+// Re-home a tracked window whose monitor changed without a focus event.
+// toFront: it becomes the most recent entry there, evicting the oldest if the
+// stack is full. Otherwise it goes below everything; a full stack has no room
+// for an entry older than all of its own, so the window is dropped. Returns
+// false (nothing changed) if the window is untracked or already there.
+bool FocusStackEngine::MoveToMonitor(WindowKey window, int monitorIndex, bool toFront) {
+    if (window == 0 || !IsValidMonitor(monitorIndex)) {
+        return false;
+    }
+
+    uint32_t slot = FindSlot(window);
+    if (slot == NIL || m_slots[slot].monitor == monitorIndex) {
+        return false;
+    }
+
+    if (toFront) {
+        return Promote(window, monitorIndex);
+    }
+
+    if (m_stacks[monitorIndex].size >= m_perMonitorCapacity) {
+        ReleaseSlot(slot);
+        return true;
+    }
+
+    Unlink(slot);
+    LinkBack(slot, monitorIndex);
+    return true;
+}
+
+int FocusStackEngine::Remove(WindowKey window) {
+    uint32_t slot = FindSlot(window);
+    if (slot == NIL) {
+        return -1;
+    }
+
+    int monitorIndex = m_slots[slot].monitor;
+    ReleaseSlot(slot);
+    return monitorIndex;
+}
+
+bool FocusStackEngine::RemoveFromMonitor(int monitorIndex, WindowKey window) {
+    if (!IsValidMonitor(monitorIndex)) {
+        return false;
+    }
+
+    uint32_t slot = FindSlot(window);
+    if (slot == NIL || m_slots[slot].monitor != monitorIndex) {
+        return false;
+    }
+
+    ReleaseSlot(slot);
+    return true;
+}
+
+bool FocusStackEngine::Contains(WindowKey window) const {
+    return m_registry.Find(window) != 0;
+}
+
+int FocusStackEngine::GetMonitorOf(WindowKey window) const {
+    uint32_t slot = FindSlot(window);
+    return slot != NIL ? m_slots[slot].monitor : -1;
+}
+
+WindowKey FocusStackEngine::GetTop(int monitorIndex) const {
+    if (!IsValidMonitor(monitorIndex) || m_stacks[monitorIndex].head == NIL) {
+        return 0;
+    }
+    return m_slots[m_stacks[monitorIndex].head].window;
+}
+
+size_t FocusStackEngine::GetStackSize(int monitorIndex) const {
+    return IsValidMonitor(monitorIndex) ? m_stacks[monitorIndex].size : 0;
+}
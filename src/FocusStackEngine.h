@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "WindowRegistry.h"
+
+// Per-monitor MRU focus stacks with a global window index.
+//
+// All storage is allocated up front: every tracked window holds a slot in a
+// WindowRegistry, each monitor's stack is an intrusive doubly-linked list
+// through those slots, and the registry's open-addressing table maps
+// window -> slot. Promote, remove and membership checks are O(1) and never
+// allocate.
+//
+// A tracked window has a generation-tagged handle that dies when the window
+// leaves the stacks (removed, destroyed or pushed out), so a handle copied
+// out earlier can be checked with one compare instead of a syscall.
+//
+// A window lives in at most one stack. Not thread-safe; callers serialize.
+// Handle checks through GetRegistry() are the exception, see WindowRegistry.
+class FocusStackEngine {
+public:
+    FocusStackEngine(int maxMonitors, size_t perMonitorCapacity);
+
+    bool Promote(WindowKey window, int monitorIndex);  // Move to top of the monitor's stack
+    bool Append(WindowKey window, int monitorIndex);  // Add below everything else; false if tracked or the stack is full
+    bool MoveToMonitor(WindowKey window, int monitorIndex, bool toFront);  // Migrate a tracked window; see .cpp
+    int Remove(WindowKey window);  // Remove from any stack, returns former monitor or -1
+    bool RemoveFromMonitor(int monitorIndex, WindowKey window);
+    void Clear();
+
+    bool Contains(WindowKey window) const;  // Single hash probe
+    int GetMonitorOf(WindowKey window) const;  // -1 if not tracked
+    WindowKey GetTop(int monitorIndex) const;  // 0 if the stack is empty
+    size_t GetStackSize(int monitorIndex) const;
+    size_t GetTrackedCount() const { return m_registry.GetCount(); }
+
+    WindowHandle GetHandle(WindowKey window) const { return m_registry.Find(window); }  // 0 if not tracked
+    bool SetState(WindowKey window, uint32_t state) { return m_registry.SetState(window, state); }  // WINDOW_STATE_*
+    uint32_t GetState(WindowKey window) const { return m_registry.GetStateOf(window); }
+    const WindowRegistry& GetRegistry() const { return m_registry; }
+
+    int GetMaxMonitors() const { return static_cast<int>(m_stacks.size()); }
+    size_t GetPerMonitorCapacity() const { return m_perMonitorCapacity; }
+
+    // Visit a monitor's stack in MRU order (most recent first)
+    template <typename Fn>
+    void ForEachInStack(int monitorIndex, Fn&& fn) const {
+        if (!IsValidMonitor(monitorIndex)) {
+            return;
+        }
+        for (uint32_t s = m_stacks[monitorIndex].head; s != NIL; s = m_slots[s].next) {
+            fn(m_slots[s].window);
+        }
+    }
+
+    // Same, with each window's handle
+    template <typename Fn>
+    void ForEachHandleInStack(int monitorIndex, Fn&& fn) const {
+        if (!IsValidMonitor(monitorIndex)) {
+            return;
+        }
+        for (uint32_t s = m_stacks[monitorIndex].head; s != NIL; s = m_slots[s].next) {
+            fn(m_slots[s].window, m_slots[s].handle);
+        }
+    }
+
+private:
+    static const uint32_t NIL = 0xFFFFFFFFu;
+
+    // Stack links of a registry slot; only meaningful while it is registered
+    struct Slot {
+        WindowKey window;
+        WindowHandle handle;
+        uint32_t prev;
+        uint32_t next;
+        int32_t monitor;
+    };
+
+    struct StackList {
+        uint32_t head;
+        uint32_t tail;
+        uint32_t size;
+    };
+
+    WindowRegistry m_registry;
+    std::vector<Slot> m_slots;  // Indexed like the registry's slots
+    std::vector<StackList> m_stacks;
+    size_t m_perMonitorCapacity;
+
+    bool IsValidMonitor(int monitorIndex) const {
+        return monitorIndex >= 0 && monitorIndex < static_cast<int>(m_stacks.size());
+    }
+
+    uint32_t FindSlot(WindowKey window) const;  // NIL if not tracked
+    uint32_t AddSlot(WindowKey window);  // Registers the window; NIL if the registry is full
+
+    void LinkFront(uint32_t slot, int monitorIndex);
+    void LinkBack(uint32_t slot, int monitorIndex);
+    void Unlink(uint32_t slot);
+    void ReleaseSlot(uint32_t slot);
+};
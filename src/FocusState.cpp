@@ -0,0 +1,142 @@
+#include "FocusState.h"
+#include <cstdio>
+#include <cstring>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Seqlock sequence must be lock-free to live in shared memory");
+
+std::string FormatFocusState(const FocusState& state) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "current monitor: %d\n", static_cast<int>(state.currentMonitor));
+    std::string text = buffer;
+
+    for (uint32_t monitor = 0; monitor < state.monitorCount && monitor < FOCUS_STATE_MAX_MONITORS; ++monitor) {
+        const FocusStateMonitor& entry = state.monitors[monitor];
+        std::snprintf(buffer, sizeof(buffer), "Monitor %u:", monitor);
+        text += buffer;
+        for (uint32_t i = 0; i < entry.depth && i < FOCUS_STATE_MAX_STACK; ++i) {
+            std::snprintf(buffer, sizeof(buffer), " %#llx", static_cast<unsigned long long>(entry.windows[i]));
+            text += buffer;
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+FocusStatePublisher::FocusStatePublisher()
+    : m_region(nullptr) {
+}
+
+FocusStatePublisher::~FocusStatePublisher() {
+    Close();
+}
+
+bool FocusStatePublisher::Create(const std::string& name) {
+    Close();
+
+    if (!m_memory.Create(name, sizeof(FocusStateRegion))) {
+        return false;
+    }
+
+    m_region = reinterpret_cast<FocusStateRegion*>(m_memory.GetData());
+    FocusStateHeader& header = m_region->header;
+    header.version = FOCUS_STATE_VERSION;
+    header.stateSize = sizeof(FocusState);
+    header.writerActive.store(1, std::memory_order_relaxed);
+    header.sequence.store(0, std::memory_order_relaxed);
+    m_region->state.currentMonitor = -1;
+
+    // Magic last: a reader that sees it sees a complete header
+    std::atomic_thread_fence(std::memory_order_release);
+    header.magic = FOCUS_STATE_MAGIC;
+    return true;
+}
+
+void FocusStatePublisher::Close() {
+    if (m_region != nullptr) {
+        m_region->header.writerActive.store(0, std::memory_order_release);
+        m_region = nullptr;
+    }
+    m_memory.Close();
+}
+
+FocusState* FocusStatePublisher::BeginWrite() {
+    std::atomic<uint64_t>& sequence = m_region->header.sequence;
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Odd sequence is visible before any of the state changes
+    std::atomic_thread_fence(std::memory_order_release);
+    return &m_region->state;
+}
+
+void FocusStatePublisher::EndWrite() {
+    std::atomic<uint64_t>& sequence = m_region->header.sequence;
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+uint64_t FocusStatePublisher::GetPublishCount() const {
+    return m_region != nullptr ? m_region->header.sequence.load(std::memory_order_relaxed) / 2 : 0;
+}
+
+FocusStateReader::FocusStateReader()
+    : m_region(nullptr) {
+}
+
+bool FocusStateReader::Open(const std::string& name) {
+    Close();
+
+    if (!m_memory.OpenRead(name) || m_memory.GetSize() < sizeof(FocusStateRegion)) {
+        m_memory.Close();
+        return false;
+    }
+
+    const FocusStateRegion* region = reinterpret_cast<const FocusStateRegion*>(m_memory.GetData());
+    if (region->header.magic != FOCUS_STATE_MAGIC || region->header.version != FOCUS_STATE_VERSION ||
+        region->header.stateSize != sizeof(FocusState)) {
+        m_memory.Close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    m_region = region;
+    return true;
+}
+
+void FocusStateReader::Close() {
+    m_region = nullptr;
+    m_memory.Close();
+}
+
+FocusStateReadResult FocusStateReader::Read(FocusState* state, uint64_t* sequence, int attempts) const {
+    const FocusStateHeader& header = m_region->header;
+
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        uint64_t before = header.sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return header.writerActive.load(std::memory_order_acquire) != 0 ? FocusStateReadResult::NotPublished
+                                                                           : FocusStateReadResult::WriterGone;
+        }
+        if (before & 1) {
+            continue;  // Write in progress
+        }
+
+        // May copy a half-written state; the sequence check below throws it away
+        std::memcpy(state, &m_region->state, sizeof(FocusState));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header.sequence.load(std::memory_order_relaxed) == before) {
+            if (sequence != nullptr) {
+                *sequence = before;
+            }
+            if (header.writerActive.load(std::memory_order_acquire) == 0) {
+                return FocusStateReadResult::WriterGone;  // Consistent, but final
+            }
+            return FocusStateReadResult::Ok;
+        }
+    }
+
+    return FocusStateReadResult::Busy;
+}
+
+uint64_t FocusStateReader::GetSequence() const {
+    return m_region->header.sequence.load(std::memory_order_acquire);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "SharedMemory.h"
+
+// Live focus state published for other processes (status bars, scripts).
+//
+// A named shared memory region with a fixed, versioned layout. One writer
+// (True Recall) updates it under a seqlock; readers copy it and retry if
+// the sequence changed meanwhile. Readers never block the writer and the
+// writer never waits for readers, so they can poll as often as they like.
+//
+// Region names: "Local\TrueRecallFocusState" on Windows (per session),
+// "/true-recall-focus-state" elsewhere (POSIX shared memory).
+
+#ifdef _WIN32
+#define FOCUS_STATE_REGION_NAME "Local\\TrueRecallFocusState"
+#else
+#define FOCUS_STATE_REGION_NAME "/true-recall-focus-state"
+#endif
+
+static const uint32_t FOCUS_STATE_MAGIC = 0x53465254;  // "TRFS"
+static const uint32_t FOCUS_STATE_VERSION = 1;  // Bumped on any layout change
+
+static const int FOCUS_STATE_MAX_MONITORS = 32;
+static const int FOCUS_STATE_MAX_STACK = 16;
+
+struct FocusStateMonitor {
+    uint32_t depth;     // Valid entries in windows
+    uint32_t reserved;
+    uint64_t windows[FOCUS_STATE_MAX_STACK];  // Window handles, most recent first
+};
+
+// Everything a reader gets in one consistent copy
+struct FocusState {
+    int32_t currentMonitor;  // Monitor the hotkeys last switched to, -1 before the first press
+    uint32_t monitorCount;   // Entries of monitors in use
+    FocusStateMonitor monitors[FOCUS_STATE_MAX_MONITORS];
+};
+
+struct FocusStateHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t stateSize;  // sizeof(FocusState), guards against mismatched builds
+    std::atomic<uint32_t> writerActive;  // 0 once the writer shut down cleanly: reopen later
+    std::atomic<uint64_t> sequence;  // Odd while a write is in progress; 0 = nothing published yet
+};
+
+struct FocusStateRegion {
+    FocusStateHeader header;
+    FocusState state;
+};
+
+// "current monitor: N" then one "Monitor i: <windows>" line per monitor
+std::string FormatFocusState(const FocusState& state);
+
+static_assert(sizeof(FocusStateHeader) == 24, "FocusStateHeader layout is shared with other processes");
+static_assert(sizeof(FocusStateMonitor) == 136, "FocusStateMonitor layout is shared with other processes");
+
+// Writer side. Single writer: callers serialize BeginWrite()..EndWrite().
+class FocusStatePublisher {
+public:
+    FocusStatePublisher();
+    ~FocusStatePublisher();
+
+    bool Create(const std::string& name);
+    void Close();  // Tells readers the writer is gone
+    bool IsOpen() const { return m_region != nullptr; }
+
+    // Returns the shared state to update in place; readers retry until EndWrite()
+    FocusState* BeginWrite();
+    void EndWrite();
+
+    uint64_t GetPublishCount() const;
+
+private:
+    SharedMemory m_memory;
+    FocusStateRegion* m_region;
+};
+
+enum class FocusStateReadResult {
+    Ok,
+    NotPublished,  // Region exists but nothing was written yet
+    WriterGone,    // Writer closed the region; reopen to find a new one
+    Busy,          // Every attempt overlapped a write
+};
+
+// Reader side, for other processes. Lock-free; a read is a copy of a few KB.
+class FocusStateReader {
+public:
+    static const int DEFAULT_ATTEMPTS = 64;
+
+    FocusStateReader();
+
+    bool Open(const std::string& name);  // False if absent or of another version
+    void Close();
+    bool IsOpen() const { return m_region != nullptr; }
+
+    // Copies a consistent state; *sequence (optional) identifies it, so an
+    // unchanged sequence means nothing changed since the last read
+    FocusStateReadResult Read(FocusState* state, uint64_t* sequence = nullptr, int attempts = DEFAULT_ATTEMPTS) const;
+
+    uint64_t GetSequence() const;  // Cheap change check without copying
+
+private:
+    SharedMemory m_memory;
+    const FocusStateRegion* m_region;
+};
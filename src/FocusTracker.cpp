@@ -1,133 +1,571 @@
 #include "FocusTracker.h"
+#include <vector>
 #include "MonitorManager.h"
-#include <iostream>
+#include "Hash.h"
+#include "Logger.h"
 
-FocusTracker::FocusTracker(MonitorManager* monitorManager)
+// Static pointer for hook callback access
+static FocusTracker* g_focusTracker = nullptr;
+
+// Maximum records applied per worker pass
+static const size_t MAX_BATCH_SIZE = 64;
+
+// Stack changes are saved this long after the first one, batching bursts
+static const int SNAPSHOT_DELAY_MS = 2000;
+
+// A window's location changes are applied once it has been still this long
+static const int MOVE_SETTLE_MS = 100;
+
+// Desktops are re-queried once a burst of cloak events (a desktop switch) has
+// been quiet this long
+static const int DESKTOP_SETTLE_MS = 50;
+
+// Cached window states are re-queried this long after activity, fixing
+// whatever a dropped or unreported event left wrong
+static const int RECONCILE_DELAY_MS = 5000;
+
+// Out-of-context hook for [eventMin, eventMax], all processes but ours
+static HWINEVENTHOOK InstallHook(DWORD eventMin, DWORD eventMax, WINEVENTPROC proc) {
+    return SetWinEventHook(eventMin, eventMax, nullptr, proc, 0, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+}
+
+static void RemoveHook(HWINEVENTHOOK* hook) {
+    if (*hook != nullptr) {
+        UnhookWinEvent(*hook);
+        *hook = nullptr;
+    }
+}
+
+FocusTracker::FocusTracker(MonitorManager* monitorManager, ActivationStats* activationStats,
+                           ActivationPipeline* activationPipeline)
     : m_focusHook(nullptr)
     , m_destroyHook(nullptr)
+    , m_moveSizeHook(nullptr)
+    , m_minimizeHook(nullptr)
+    , m_locationHook(nullptr)
+    , m_nameChangeHook(nullptr)
+    , m_showHideHook(nullptr)
+    , m_cloakHook(nullptr)
     , m_monitorManager(monitorManager)
+    , m_activationStats(activationStats)
+    , m_activationPipeline(activationPipeline)
+    , m_queue(new HookEventQueue())
+    , m_moveQueue(new MoveEventQueue())
+    , m_queueSignal(-1)
+    , m_reportedDrops(0)
+    , m_snapshotter(monitorManager)
+    , m_snapshotTimer(-1)
+    , m_moveTimer(-1)
+    , m_desktopTimer(-1)
+    , m_reconcileTimer(-1)
 {
+    g_focusTracker = this;
 }
 
 FocusTracker::~FocusTracker() {
     Stop();
+    g_focusTracker = nullptr;
+}
+
+bool FocusTracker::StartRecording(const std::string& path) {
+    if (m_worker.joinable()) {
+        TR_LOG_ERROR("Trace recording must start before the focus tracker");
+        return false;
+    }
+
+    MonitorLayout layout = m_monitorManager->GetLayout();
+    if (!m_traceWriter.Open(path, layout, MonitorManager::GetMaxMonitors(), MonitorManager::GetMaxStackSize())) {
+        TR_LOG_ERROR("Failed to open focus trace {}", path);
+        return false;
+    }
+
+    TR_LOG_INFO("Recording focus trace to {}", path);
+    return true;
+}
+
+bool FocusTracker::EnableSnapshots(const std::string& path) {
+    if (m_worker.joinable()) {
+        TR_LOG_ERROR("Focus snapshots must be enabled before the focus tracker starts");
+        return false;
+    }
+
+    return m_snapshotter.Open(path);
 }
 
 bool FocusTracker::Start() {
     if (m_focusHook != nullptr) {
-        std::cerr << "FocusTracker already started" << std::endl;
+        TR_LOG_ERROR("FocusTracker already started");
+        return false;
+    }
+
+    // Start the worker before the hooks so nothing is queued without a consumer
+    m_workerLoop.reset(new EventLoop());
+    if (!m_workerLoop->IsValid()) {
+        TR_LOG_ERROR("Failed to create focus worker event loop");
+        m_workerLoop.reset();
         return false;
     }
 
+    m_queueSignal = m_workerLoop->AddSignal([this]() { DrainQueue(); });
+
+    // First thing on the worker, off the startup path: fill the stacks. Seeds
+    // go below anything focused in the meantime, so ordering against live
+    // events does not matter.
+    m_workerLoop->AddTimer(std::chrono::milliseconds(0), false, [this]() { SeedStacks(); });
+    m_worker = std::thread([this]() { m_workerLoop->Run(); });
+
     // Install hook for foreground window changes
-    m_focusHook = SetWinEventHook(
-        EVENT_SYSTEM_FOREGROUND,     // eventMin
-        EVENT_SYSTEM_FOREGROUND,     // eventMax
-        nullptr,                     // hmodWinEventProc
-        FocusEventProc,              // callback function
-        0,                           // idProcess (0 = all processes)
-        0,                           // idThread (0 = all threads)
-        WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS  // dwFlags
-    );
+    m_focusHook = InstallHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, WinEventProc);
 
     if (m_focusHook == nullptr) {
-        std::cerr << "Failed to install focus tracking hook" << std::endl;
+        TR_LOG_ERROR("Failed to install focus tracking hook");
+        Stop();
         return false;
     }
-    
+
     // Install hook for window destruction
-    m_destroyHook = SetWinEventHook(
-        EVENT_OBJECT_DESTROY,        // eventMin
-        EVENT_OBJECT_DESTROY,        // eventMax
-        nullptr,                     // hmodWinEventProc
-        DestroyEventProc,            // callback function
-        0,                           // idProcess (0 = all processes)
-        0,                           // idThread (0 = all threads)
-        WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS  // dwFlags
-    );
-    
+    m_destroyHook = InstallHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_DESTROY, WinEventProc);
+
     if (m_destroyHook == nullptr) {
-        std::cerr << "Warning: Failed to install destroy tracking hook" << std::endl;
+        TR_LOG_WARN("Warning: Failed to install destroy tracking hook");
         // Continue anyway, this is not critical
     }
 
-    std::cout << "Focus tracking started" << std::endl;
+    // Install hooks for windows changing monitor without a focus change.
+    // Separate hooks keep the unrelated events between these codes out.
+    m_moveSizeHook = InstallHook(EVENT_SYSTEM_MOVESIZEEND, EVENT_SYSTEM_MOVESIZEEND, WinEventProc);
+    m_minimizeHook = InstallHook(EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND, WinEventProc);
+    m_locationHook = InstallHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, WinEventProc);
+
+    if (m_moveSizeHook == nullptr || m_minimizeHook == nullptr || m_locationHook == nullptr) {
+        TR_LOG_WARN("Warning: Failed to install window move tracking hooks");
+        // Continue anyway; windows are re-homed when next focused
+    }
+
+    // Install hooks for windows being shown, hidden (e.g. minimized to the tray)
+    // or cloaked (moved to another virtual desktop, suspended store apps)
+    m_showHideHook = InstallHook(EVENT_OBJECT_SHOW, EVENT_OBJECT_HIDE, WinEventProc);
+    m_cloakHook = InstallHook(EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED, WinEventProc);
+
+    if (m_showHideHook == nullptr || m_cloakHook == nullptr) {
+        TR_LOG_WARN("Warning: Failed to install window state hooks");
+        // Continue anyway; reconciliation after activity corrects the cached states
+    }
+
+    // Install hook for title changes, which keeps the title cache current
+    m_nameChangeHook = InstallHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, WinEventProc);
+
+    if (m_nameChangeHook == nullptr) {
+        TR_LOG_WARN("Warning: Failed to install title change hook");
+        // Continue anyway; cached titles only feed logs, snapshots and the has-title check
+    }
+
+    TR_LOG_INFO("Focus tracking started");
     return true;
 }
 
 void FocusTracker::Stop() {
-    if (m_focusHook != nullptr) {
-        UnhookWinEvent(m_focusHook);
-        m_focusHook = nullptr;
+    RemoveHook(&m_focusHook);
+    RemoveHook(&m_destroyHook);
+    RemoveHook(&m_moveSizeHook);
+    RemoveHook(&m_minimizeHook);
+    RemoveHook(&m_locationHook);
+    RemoveHook(&m_nameChangeHook);
+    RemoveHook(&m_showHideHook);
+    RemoveHook(&m_cloakHook);
+
+    // Hooks are gone, so the queue has no producer left; let the worker finish
+    if (m_worker.joinable()) {
+        m_workerLoop->RequestStop();
+        m_worker.join();
+
+        // The worker is gone, so saving from here is safe; catches a pending save
+        if (m_snapshotter.IsOpen()) {
+            m_snapshotter.Save();
+        }
     }
-    
-    if (m_destroyHook != nullptr) {
-        UnhookWinEvent(m_destroyHook);
-        m_destroyHook = nullptr;
+    m_workerLoop.reset();
+    m_snapshotTimer = -1;
+    m_moveTimer = -1;
+    m_desktopTimer = -1;
+    m_reconcileTimer = -1;
+    m_pendingMoves.clear();
+
+    if (m_traceWriter.IsOpen()) {
+        TR_LOG_INFO("Focus trace closed, {} event(s) recorded", m_traceWriter.GetRecordCount());
+        m_traceWriter.Close();
     }
-    
-    std::cout << "Focus tracking stopped" << std::endl;
+
+    TR_LOG_INFO("Focus tracking stopped");
 }
 
-void CALLBACK FocusTracker::FocusEventProc(
-    HWINEVENTHOOK hWinEventHook,
-    DWORD event,
-    HWND hwnd,
-    LONG idObject,
-    LONG idChild,
-    DWORD idEventThread,
-    DWORD dwmsEventTime
-) {
-    // Only process if it's a window object
-    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
-        return;
+uint64_t FocusTracker::GetDroppedEventCount() const {
+    return m_queue->GetDroppedCount() + m_moveQueue->GetDroppedCount();
+}
+
+void FocusTracker::Enqueue(DWORD event, HWND hwnd, LONG idObject, DWORD dwmsEventTime) {
+    HookEvent record;
+    record.event = event;
+    record.idObject = idObject;
+    record.hwnd = reinterpret_cast<WindowKey>(hwnd);
+    record.eventTime = dwmsEventTime;
+
+    if (!m_queue->TryPush(record)) {
+        return;  // Counted by the queue, reported by the worker
     }
 
-    // Skip if no valid window handle
-    if (hwnd == nullptr || !IsWindow(hwnd)) {
+    // Coalesced: only the first push after the worker drained costs a wakeup
+    m_workerLoop->Notify(m_queueSignal);
+}
+
+void FocusTracker::EnqueueMove(HWND hwnd) {
+    if (!m_moveQueue->Push(reinterpret_cast<WindowKey>(hwnd))) {
+        return;  // Already pending, or counted as dropped
+    }
+    m_workerLoop->Notify(m_queueSignal);
+}
+
+void FocusTracker::DrainQueue() {
+    HookEvent batch[MAX_BATCH_SIZE];
+
+    size_t count;
+    while ((count = m_queue->PopBatch(batch, MAX_BATCH_SIZE)) > 0) {
+        ProcessBatch(batch, count);
+    }
+
+    // After the batch, so a window focused and moved in one burst is already tracked
+    WindowKey moved[MAX_BATCH_SIZE];
+    while ((count = m_moveQueue->PopBatch(moved, MAX_BATCH_SIZE)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            QueueLocationChange(moved[i]);
+        }
+    }
+}
+
+void FocusTracker::ProcessBatch(const HookEvent* events, size_t count) {
+    bool focusChanged = false;
+    bool stacksChanged = false;
+    bool readyChanged = false;  // Some stacked window may have stopped being activatable
+
+    for (size_t i = 0; i < count; ++i) {
+        WindowKey window = events[i].hwnd;
+
+        switch (events[i].event) {
+            case EVENT_SYSTEM_FOREGROUND:
+                HandleFocusEvent(window);
+                focusChanged = true;
+                break;
+            case EVENT_OBJECT_DESTROY:
+                stacksChanged |= HandleDestroyEvent(window);
+                break;
+            case EVENT_SYSTEM_MOVESIZEEND:
+                // End of a gesture: apply now rather than after the settle delay
+                stacksChanged |= HandleMoveEvent(window);
+                break;
+            case EVENT_SYSTEM_MINIMIZESTART:
+            case EVENT_SYSTEM_MINIMIZEEND:
+                stacksChanged |= HandleMoveEvent(window);
+                readyChanged |= m_monitorManager->SetWindowStateFlag(window, WINDOW_STATE_MINIMIZED,
+                                                                     events[i].event == EVENT_SYSTEM_MINIMIZESTART);
+                break;
+            case EVENT_OBJECT_SHOW:
+            case EVENT_OBJECT_HIDE:
+                // Carets and cursors report their owner window; only the window itself counts.
+                // Tooltips and menus come and go all the time; untracked windows cost one probe.
+                if (events[i].idObject == OBJID_WINDOW) {
+                    readyChanged |= m_monitorManager->SetWindowStateFlag(window, WINDOW_STATE_VISIBLE,
+                                                                         events[i].event == EVENT_OBJECT_SHOW);
+                }
+                break;
+            case EVENT_OBJECT_CLOAKED:
+            case EVENT_OBJECT_UNCLOAKED:
+                // A stacked window (un)cloaking: a desktop switch, or moved to another desktop
+                if (m_monitorManager->SetWindowStateFlag(window, WINDOW_STATE_CLOAKED,
+                                                         events[i].event == EVENT_OBJECT_CLOAKED)) {
+                    readyChanged = true;
+                    ScheduleDesktopRefresh();
+                }
+                break;
+        }
+    }
+
+    if (focusChanged || stacksChanged || readyChanged) {
+        RefreshReadyTargets();
+    }
+
+    // Only activity on stacked windows: background windows coming and going
+    // must not keep the re-query of every stacked window armed
+    if (stacksChanged || readyChanged) {
+        ScheduleReconcile();
+    }
+
+    if ((focusChanged || stacksChanged) && m_snapshotter.IsOpen()) {
+        ScheduleSnapshot();
+    }
+
+    // Print focus stacks once per batch rather than once per event
+    if (focusChanged) {
+        m_monitorManager->PrintFocusStacks();
+    }
+
+    uint64_t dropped = GetDroppedEventCount();
+    if (dropped != m_reportedDrops) {
+        TR_LOG_WARN("Warning: {} window event(s) dropped, event queue full", dropped - m_reportedDrops);
+        m_reportedDrops = dropped;
+    }
+}
+
+void FocusTracker::HandleFocusEvent(WindowKey window) {
+    // Ends a hotkey measurement if this is the window the hotkey activated
+    m_activationStats->OnForeground(window, ActivationStats::Clock::now());
+    m_activationPipeline->OnForeground(window);
+
+    // Resolve the monitor exactly once; this also fails if the window
+    // went away while the event was queued
+    int monitorIdx = m_monitorManager->GetMonitorIndexForWindow(window);
+
+    if (m_traceWriter.IsOpen()) {
+        RecordTraceEvent(TraceEventType::Focus, window, monitorIdx,
+                         m_monitorManager->IsWindowTracked(window) ? TRACE_FLAG_TRACKED : 0);
+    }
+
+    if (monitorIdx < 0) {
         return;
     }
 
-    // Get the FocusTracker instance from thread-local storage or global
-    // For now, we need to pass monitor manager statically
-    // This is a limitation of the callback approach - we'll use a static pointer
-    static MonitorManager* s_monitorManager = nullptr;
-    
-    // Get from the current FocusTracker context (we'll set this in Start())
-    // For simplicity, we'll use a global pointer approach
-    extern MonitorManager* g_monitorManager;
-    
-    // Get monitor index
-    int monitorIdx = -1;
-    if (g_monitorManager != nullptr) {
-        monitorIdx = g_monitorManager->GetMonitorIndexForWindow(hwnd);
-        
-        // Update focus stack
-        g_monitorManager->OnWindowFocused(hwnd);
-    }
-
-    // Get window title
-    wchar_t title[256] = L"";
-    int titleLength = GetWindowTextW(hwnd, title, sizeof(title) / sizeof(title[0]));
+    // Update focus stack
+    m_monitorManager->OnWindowFocused(window, monitorIdx);
+
+    // The title is only needed for the log line, skip even the cache otherwise
+    if (!TR_LOG_ENABLED(LogLevel::Debug)) {
+        return;
+    }
 
     // Print focus change with monitor index
-    if (titleLength > 0) {
-        std::wcout << L"Focus changed: Monitor " << monitorIdx 
-                   << L" HWND=0x" << std::hex << reinterpret_cast<uintptr_t>(hwnd)
-                   << std::dec << L" Title=" << title << std::endl;
+    std::wstring title;
+    if (m_monitorManager->GetWindowTitle(window, &title)) {
+        TR_LOG_DEBUG("Focus changed: Monitor {} HWND={} Title={}", monitorIdx, reinterpret_cast<HWND>(window), title);
     } else {
-        std::cout << "Focus changed: Monitor " << monitorIdx 
-                  << " HWND=0x" << std::hex << reinterpret_cast<uintptr_t>(hwnd)
-                  << std::dec << " Title=(no title)" << std::endl;
+        TR_LOG_DEBUG("Focus changed: Monitor {} HWND={} Title=(no title)", monitorIdx, reinterpret_cast<HWND>(window));
+    }
+}
+
+bool FocusTracker::HandleDestroyEvent(WindowKey window) {
+    // Titles are cached for untracked windows too (window searches, seeding),
+    // identities for windows that have since left the stacks
+    m_monitorManager->ForgetWindowTitle(window);
+    m_snapshotter.ForgetWindow(window);
+
+    // This fires for every window in the system; reject untracked ones with one probe
+    bool tracked = m_monitorManager->IsWindowTracked(window);
+
+    if (m_traceWriter.IsOpen()) {
+        RecordTraceEvent(TraceEventType::Destroy, window, -1, tracked ? TRACE_FLAG_TRACKED : 0);
+    }
+
+    if (!tracked) {
+        return false;
+    }
+
+    // Remove this window from all focus stacks
+    m_monitorManager->RemoveWindowFromAllStacks(window);
+    m_pendingMoves.erase(window);
+    return true;
+}
+
+bool FocusTracker::HandleMoveEvent(WindowKey window) {
+    m_pendingMoves.erase(window);
+
+    // Only stacked windows can be on the wrong stack; one probe rejects the rest
+    if (!m_monitorManager->IsWindowTracked(window)) {
+        return false;
+    }
+
+    int monitorIdx = m_monitorManager->GetMonitorIndexForWindow(window);
+    if (monitorIdx < 0) {
+        return false;
+    }
+
+    // Dragging the active window keeps it the most recent one; a window moved
+    // in the background has not been used more recently than anything there
+    bool foreground = (reinterpret_cast<WindowKey>(GetForegroundWindow()) == window);
+    if (!m_monitorManager->MoveWindowToMonitor(window, monitorIdx, foreground)) {
+        return false;
+    }
+
+    if (m_traceWriter.IsOpen()) {
+        RecordTraceEvent(TraceEventType::Move, window, monitorIdx,
+                         TRACE_FLAG_TRACKED | (foreground ? TRACE_FLAG_FOREGROUND : 0));
+    }
+    return true;
+}
+
+void FocusTracker::QueueLocationChange(WindowKey window) {
+    // Fires for every window, child and animation frame; keep only stacked windows
+    if (!m_monitorManager->IsWindowTracked(window)) {
+        return;
+    }
+
+    // Per-window coalescing: a drag collapses to one entry, applied once it settles
+    m_pendingMoves[window] = std::chrono::steady_clock::now();
+
+    if (m_moveTimer < 0) {
+        ArmMoveTimer();
+    }
+}
+
+void FocusTracker::ArmMoveTimer() {
+    m_moveTimer = m_workerLoop->AddTimer(std::chrono::milliseconds(MOVE_SETTLE_MS), false, [this]() {
+        m_moveTimer = -1;
+        FlushPendingMoves();
+    });
+}
+
+void FocusTracker::FlushPendingMoves() {
+    std::chrono::steady_clock::time_point settled =
+        std::chrono::steady_clock::now() - std::chrono::milliseconds(MOVE_SETTLE_MS);
+
+    std::vector<WindowKey> ready;
+    for (const auto& pending : m_pendingMoves) {
+        if (pending.second <= settled) {
+            ready.push_back(pending.first);
+        }
+    }
+
+    bool stacksChanged = false;
+    for (WindowKey window : ready) {
+        stacksChanged |= HandleMoveEvent(window);  // Also drops the pending entry
+    }
+
+    // Still moving: check again later, at most once per settle interval
+    if (!m_pendingMoves.empty() && m_moveTimer < 0) {
+        ArmMoveTimer();
+    }
+
+    if (stacksChanged) {
+        if (m_snapshotter.IsOpen()) {
+            ScheduleSnapshot();
+        }
+        RefreshReadyTargets();
+        ScheduleReconcile();
+        m_monitorManager->PrintFocusStacks();
+    }
+}
+
+void FocusTracker::SeedStacks() {
+    // Which desktop is current, before anything is placed on one
+    m_monitorManager->RefreshDesktops();
+
+    // The snapshot knows the real focus order; z-order fills whatever is left
+    if (m_snapshotter.IsOpen()) {
+        m_snapshotter.Restore();
     }
-    
-    // Print focus stacks after each focus change
-    if (g_monitorManager != nullptr) {
-        g_monitorManager->PrintFocusStacks();
+    m_monitorManager->SeedFocusStacksFromZOrder();
+    RefreshReadyTargets();
+    m_monitorManager->PrintFocusStacks();
+}
+
+void FocusTracker::RefreshReadyTargets() {
+    if (m_monitorManager->RefreshReadyTargets() && TR_LOG_ENABLED(LogLevel::Trace)) {
+        for (int monitorIndex = 0; monitorIndex < m_monitorManager->GetMonitorCount(); ++monitorIndex) {
+            TR_LOG_TRACE("Ready target Monitor {}: {}", monitorIndex,
+                         reinterpret_cast<HWND>(m_monitorManager->GetReadyTarget(monitorIndex)));
+        }
     }
 }
 
-void CALLBACK FocusTracker::DestroyEventProc(
+void FocusTracker::ScheduleDesktopRefresh() {
+    // A switch cloaks and uncloaks every window of both desktops; refresh once it settles
+    if (m_desktopTimer >= 0) {
+        m_workerLoop->CancelTimer(m_desktopTimer);
+    }
+
+    m_desktopTimer = m_workerLoop->AddTimer(std::chrono::milliseconds(DESKTOP_SETTLE_MS), false, [this]() {
+        m_desktopTimer = -1;
+        if (!m_monitorManager->RefreshDesktops()) {
+            return;
+        }
+
+        TR_LOG_DEBUG("Virtual desktop changed");
+        if (m_snapshotter.IsOpen()) {
+            ScheduleSnapshot();
+        }
+        RefreshReadyTargets();
+        m_monitorManager->PrintFocusStacks();
+    });
+}
+
+void FocusTracker::ScheduleReconcile() {
+    // Pushed back by nothing: during a burst it fires at most once per interval
+    if (m_reconcileTimer >= 0) {
+        return;
+    }
+
+    m_reconcileTimer = m_workerLoop->AddTimer(std::chrono::milliseconds(RECONCILE_DELAY_MS), false, [this]() {
+        m_reconcileTimer = -1;
+        size_t corrected = m_monitorManager->ReconcileWindowStates();
+        if (corrected > 0) {
+            TR_LOG_DEBUG("Reconciled {} window state(s) that events missed", corrected);
+            RefreshReadyTargets();
+        }
+    });
+}
+
+void FocusTracker::ScheduleSnapshot() {
+    // One pending save at a time; an idle desktop arms no timer at all
+    if (m_snapshotTimer >= 0) {
+        return;
+    }
+
+    m_snapshotTimer = m_workerLoop->AddTimer(std::chrono::milliseconds(SNAPSHOT_DELAY_MS), false, [this]() {
+        m_snapshotTimer = -1;
+        m_snapshotter.Save();
+    });
+}
+
+void FocusTracker::RecordTraceEvent(TraceEventType type, WindowKey window, int monitorIndex, uint32_t flags) {
+    HWND hwnd = reinterpret_cast<HWND>(window);
+    TraceRecord record = {};
+    record.window = window;
+    record.type = static_cast<uint16_t>(type);
+    record.monitor = static_cast<int16_t>(monitorIndex);
+    record.flags = flags;
+
+    // A destroyed window has nothing left to query
+    if (type != TraceEventType::Destroy) {
+        RECT rect;
+        if (GetWindowRect(hwnd, &rect)) {
+            record.rect.left = rect.left;
+            record.rect.top = rect.top;
+            record.rect.right = rect.right;
+            record.rect.bottom = rect.bottom;
+        }
+
+        DWORD processId = 0;
+        GetWindowThreadProcessId(hwnd, &processId);
+        record.processId = processId;
+
+        // Groups windows by class without storing names
+        char className[256];
+        int length = GetClassNameA(hwnd, className, sizeof(className));
+        if (length > 0) {
+            record.classHash = HashFnv32(className, static_cast<size_t>(length));
+        }
+
+        if (IsWindowVisible(hwnd)) {
+            record.flags |= TRACE_FLAG_VISIBLE;
+        }
+        if (IsIconic(hwnd)) {
+            record.flags |= TRACE_FLAG_MINIMIZED;
+        }
+    }
+
+    if (!m_traceWriter.Append(record)) {
+        TR_LOG_WARN("Focus trace stopped: could not grow the trace file");
+    }
+}
+
+void CALLBACK FocusTracker::WinEventProc(
     HWINEVENTHOOK hWinEventHook,
     DWORD event,
     HWND hwnd,
@@ -142,14 +580,22 @@ void CALLBACK FocusTracker::DestroyEventProc(
     }
 
     // Skip if no valid window handle
-    if (hwnd == nullptr) {
+    if (hwnd == nullptr || g_focusTracker == nullptr) {
         return;
     }
 
-    extern MonitorManager* g_monitorManager;
-    
-    if (g_monitorManager != nullptr) {
-        // Remove this window from all focus stacks
-        g_monitorManager->RemoveWindowFromAllStacks(hwnd);
+    // Far too frequent to queue, and only needs a short cache lock: handle inline
+    if (event == EVENT_OBJECT_NAMECHANGE) {
+        g_focusTracker->m_monitorManager->InvalidateWindowTitle(reinterpret_cast<WindowKey>(hwnd));
+        return;
     }
+
+    // Coalesced per window on the way in, so move bursts cannot fill the event queue
+    if (event == EVENT_OBJECT_LOCATIONCHANGE) {
+        g_focusTracker->EnqueueMove(hwnd);
+        return;
+    }
+
+    // Everything else happens on the worker
+    g_focusTracker->Enqueue(event, hwnd, idObject, dwmsEventTime);
 }
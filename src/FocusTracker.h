@@ -1,36 +1,82 @@
 #pragma once
 
 #include <windows.h>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "ActivationPipeline.h"
+#include "ActivationStats.h"
+#include "EventLoop.h"
+#include "FocusSnapshotter.h"
+#include "HookEvent.h"
+#include "TraceWriter.h"
 
 // Forward declaration
 class MonitorManager;
 
 class FocusTracker {
 public:
-    FocusTracker(MonitorManager* monitorManager);
+    FocusTracker(MonitorManager* monitorManager, ActivationStats* activationStats, ActivationPipeline* activationPipeline);
     ~FocusTracker();
 
-    bool Start();  // Install hook
-    void Stop();   // Remove hook
+    bool StartRecording(const std::string& path);  // Trace every event the worker applies; call before Start()
+    bool EnableSnapshots(const std::string& path);  // Restore stacks on start, persist changes; call before Start()
+    bool Start();  // Install hooks and start the worker
+    void Stop();   // Remove hooks and join the worker
+
+    uint64_t GetDroppedEventCount() const;  // Hook events lost to a full queue
 
 private:
     HWINEVENTHOOK m_focusHook;
     HWINEVENTHOOK m_destroyHook;
+    HWINEVENTHOOK m_moveSizeHook;  // Drag/resize ended
+    HWINEVENTHOOK m_minimizeHook;  // Minimize start/end
+    HWINEVENTHOOK m_locationHook;  // Every location change; coalesced per window before queueing
+    HWINEVENTHOOK m_nameChangeHook;  // Invalidates cached titles, never queued
+    HWINEVENTHOOK m_showHideHook;  // Keeps the cached visible bit current
+    HWINEVENTHOOK m_cloakHook;  // Likewise the cloaked bit (virtual desktop switches)
     MonitorManager* m_monitorManager;
+    ActivationStats* m_activationStats;  // Told about every foreground change
+    ActivationPipeline* m_activationPipeline;  // Likewise; confirms activations
 
-    // Static callback for focus events
-    static void CALLBACK FocusEventProc(
-        HWINEVENTHOOK hWinEventHook,
-        DWORD event,
-        HWND hwnd,
-        LONG idObject,
-        LONG idChild,
-        DWORD idEventThread,
-        DWORD dwmsEventTime
-    );
-    
-    // Static callback for window destruction
-    static void CALLBACK DestroyEventProc(
+    // Hook thread -> worker hand-off
+    std::unique_ptr<HookEventQueue> m_queue;
+    std::unique_ptr<MoveEventQueue> m_moveQueue;  // Location changes, one entry per window
+    std::unique_ptr<EventLoop> m_workerLoop;
+    EventLoop::SignalId m_queueSignal;  // Raised by the hook thread after a push
+    std::thread m_worker;
+    uint64_t m_reportedDrops;  // Worker-only
+    TraceWriter m_traceWriter;  // Worker-only once started
+    FocusSnapshotter m_snapshotter;  // Worker-only once started
+    EventLoop::TimerId m_snapshotTimer;  // Pending save, -1 if none
+
+    // Tracked windows with location changes not yet applied -> last change (worker-only)
+    std::unordered_map<WindowKey, std::chrono::steady_clock::time_point> m_pendingMoves;
+    EventLoop::TimerId m_moveTimer;  // Pending flush, -1 if none
+    EventLoop::TimerId m_desktopTimer;  // Desktop refresh once cloak events settle, -1 if none
+    EventLoop::TimerId m_reconcileTimer;  // Window state re-query after activity, -1 if none
+
+    void Enqueue(DWORD event, HWND hwnd, LONG idObject, DWORD dwmsEventTime);
+    void EnqueueMove(HWND hwnd);
+    void DrainQueue();
+    void ProcessBatch(const HookEvent* events, size_t count);
+    void HandleFocusEvent(WindowKey window);
+    bool HandleDestroyEvent(WindowKey window);  // True if a tracked window was removed
+    bool HandleMoveEvent(WindowKey window);  // True if a tracked window changed stacks
+    void QueueLocationChange(WindowKey window);
+    void ArmMoveTimer();  // One-shot; an idle desktop arms none
+    void FlushPendingMoves();
+    void RefreshReadyTargets();
+    void ScheduleDesktopRefresh();  // Pushed back by every call
+    void ScheduleReconcile();  // One-shot after a stacked window changed; other windows' activity arms none
+    void SeedStacks();
+    void ScheduleSnapshot();
+    void RecordTraceEvent(TraceEventType type, WindowKey window, int monitorIndex, uint32_t flags);
+
+    // Static callback shared by all hooks; only queues the event
+    static void CALLBACK WinEventProc(
         HWINEVENTHOOK hWinEventHook,
         DWORD event,
         HWND hwnd,
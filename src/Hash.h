@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// FNV-1a: tiny, no tables, good enough for identity and integrity hashes.
+// Not for hash tables keyed by HWND (see WindowRegistry::HomeBucket).
+
+inline uint32_t HashFnv32(const void* data, size_t size, uint32_t seed = 2166136261u) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+inline uint64_t HashFnv64(const void* data, size_t size, uint64_t seed = 14695981039346656037ull) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "FocusStackEngine.h"
+#include "SpscQueue.h"
+
+// Raw WinEvent record handed from the hook callbacks to the processing worker.
+// Plain data only: the hook thread copies the callback arguments and returns.
+struct HookEvent {
+    uint32_t event;      // EVENT_* code
+    int32_t idObject;    // OBJID_* of the source object
+    WindowKey hwnd;
+    uint32_t eventTime;  // dwmsEventTime from the callback
+};
+
+// 4096 records (~96 KB) absorbs bursts far beyond normal desktop event rates
+typedef SpscQueue<HookEvent, 4096> HookEventQueue;
+
+// Location changes travel separately, at most one queued entry per window, so
+// a drag or animation burst cannot crowd foreground and destroy records out
+// of the event queue. Queued windows are marked in a small open-addressed
+// table; when a window finds no free slot it is queued unmarked, so the
+// worst case is duplicates, never a lost move.
+class MoveEventQueue {
+public:
+    static const size_t SLOT_COUNT = 128;
+    static const size_t MAX_PROBE = 4;
+
+    MoveEventQueue() {
+        for (std::atomic<WindowKey>& slot : m_pending) {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Hook thread, the only one that marks. Marks before pushing, so the
+    // worker never pops an entry whose mark is still to come.
+    bool Push(WindowKey window) {
+        size_t home = HomeSlot(window);
+        std::atomic<WindowKey>* free = nullptr;
+        for (size_t i = 0; i < MAX_PROBE; ++i) {
+            std::atomic<WindowKey>& slot = m_pending[(home + i) & (SLOT_COUNT - 1)];
+            WindowKey marked = slot.load(std::memory_order_relaxed);
+            if (marked == window) {
+                return false;  // Already queued; the worker timestamps it when it gets there
+            }
+            if (marked == 0 && free == nullptr) {
+                free = &slot;
+            }
+        }
+
+        if (free != nullptr) {
+            free->store(window, std::memory_order_relaxed);
+        }
+        if (!m_queue.TryPush(window)) {
+            if (free != nullptr) {
+                free->store(0, std::memory_order_relaxed);
+            }
+            return false;
+        }
+        return true;
+    }
+
+    // Worker. Unmarks each popped window, so its next change is queued again.
+    size_t PopBatch(WindowKey* out, size_t maxCount) {
+        size_t count = m_queue.PopBatch(out, maxCount);
+        for (size_t n = 0; n < count; ++n) {
+            size_t home = HomeSlot(out[n]);
+            for (size_t i = 0; i < MAX_PROBE; ++i) {
+                WindowKey window = out[n];
+                if (m_pending[(home + i) & (SLOT_COUNT - 1)].compare_exchange_strong(window, 0, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+        }
+        return count;
+    }
+
+    uint64_t GetDroppedCount() const { return m_queue.GetDroppedCount(); }
+
+private:
+    SpscQueue<WindowKey, 512> m_queue;
+    std::atomic<WindowKey> m_pending[SLOT_COUNT];
+
+    static size_t HomeSlot(WindowKey window) {
+        // Same mixing as WindowRegistry: HWND values are aligned and clustered
+        return static_cast<size_t>((static_cast<uint64_t>(window) * 0x9E3779B97F4A7C15ull) >> 57);
+    }
+};
@@ -1,12 +1,15 @@
 #include "HotkeyManager.h"
-#include <iostream>
+#include "Logger.h"
 
 // Static pointer for window procedure access
 static HotkeyManager* g_hotkeyManager = nullptr;
 
-HotkeyManager::HotkeyManager(MonitorManager* monitorManager, Config* config)
+HotkeyManager::HotkeyManager(MonitorManager* monitorManager, Config* config, ActivationStats* stats,
+                             ActivationPipeline* pipeline)
     : m_monitorManager(monitorManager)
     , m_config(config)
+    , m_stats(stats)
+    , m_pipeline(pipeline)
     , m_currentMonitor(0)
     , m_messageWindow(nullptr) {
     g_hotkeyManager = this;
@@ -29,7 +32,7 @@ bool HotkeyManager::CreateMessageWindow() {
     if (!RegisterClassEx(&wc)) {
         DWORD error = GetLastError();
         if (error != ERROR_CLASS_ALREADY_EXISTS) {
-            std::cerr << "Failed to register window class: " << error << std::endl;
+            TR_LOG_ERROR("Failed to register window class: {}", error);
             return false;
         }
     }
@@ -48,7 +51,7 @@ bool HotkeyManager::CreateMessageWindow() {
     );
     
     if (!m_messageWindow) {
-        std::cerr << "Failed to create message window: " << GetLastError() << std::endl;
+        TR_LOG_ERROR("Failed to create message window: {}", GetLastError());
         return false;
     }
     
@@ -68,150 +71,165 @@ bool HotkeyManager::RegisterHotkeys() {
         return false;
     }
     
-    // Get hotkey config
-    HotkeyConfig hotkey = m_config->GetHotkeyConfig();
-    
-    // Register hotkey for monitor cycling
-    if (!RegisterHotKey(m_messageWindow, HOTKEY_CYCLE_MONITOR, hotkey.modifiers, hotkey.vkey)) {
-        std::wcerr << L"Failed to register hotkey " << m_config->GetHotkeyString() 
-                   << L": " << GetLastError() << std::endl;
-        std::wcerr << L"The hotkey may already be in use by another application." << std::endl;
-        return false;
-    }
-    
-    std::wcout << L"Hotkey registered: " << m_config->GetHotkeyString() 
-               << L" = Cycle Monitor" << std::endl;
-    return true;
+    // Without the cycle hotkey the tool is useless; a missing monitor hotkey is not fatal
+    ApplyBindings(m_config->GetHotkeyBindings());
+    return m_registered[0];
 }
 
-void HotkeyManager::UnregisterHotkeys() {
-    if (m_messageWindow) {
-        UnregisterHotKey(m_messageWindow, HOTKEY_CYCLE_MONITOR);
-    }
-}
-
-void HotkeyManager::HandleHotkey(int hotkeyId) {
-    if (hotkeyId != HOTKEY_CYCLE_MONITOR) {
+void HotkeyManager::ReloadHotkeys() {
+    if (!m_messageWindow) {
         return;
     }
     
-    int monitorCount = m_monitorManager->GetMonitorCount();
-    if (monitorCount == 0) {
-        std::cerr << "No monitors detected" << std::endl;
-        return;
+    ApplyBindings(m_config->GetHotkeyBindings());
+    if (!m_registered[0]) {
+        TR_LOG_ERROR("No cycle hotkey registered; fix CycleMonitorHotkey in {}", m_config->GetConfigPath());
     }
-    
-    // Cycle to next monitor
-    m_currentMonitor = (m_currentMonitor + 1) % monitorCount;
-    
-    std::cout << "\nSwitched to Monitor " << m_currentMonitor << std::endl;
-    
-    // Move mouse cursor to the target monitor if configured
-    if (m_config->GetMoveMouse()) {
-        HMONITOR hMonitor = m_monitorManager->GetMonitorHandle(m_currentMonitor);
-        if (hMonitor) {
-            MONITORINFO info = {};
-            info.cbSize = sizeof(MONITORINFO);
-            if (GetMonitorInfo(hMonitor, &info)) {
-                // Move cursor to center of the monitor
-                int centerX = (info.rcMonitor.left + info.rcMonitor.right) / 2;
-                int centerY = (info.rcMonitor.top + info.rcMonitor.bottom) / 2;
-                SetCursorPos(centerX, centerY);
-                std::cout << "  Moved cursor to monitor center (" << centerX << ", " << centerY << ")" << std::endl;
-            }
+}
+
+void HotkeyManager::ApplyBindings(const std::vector<HotkeyBinding>& bindings) {
+    // Slots are fixed, so a slot whose key combination is unchanged keeps
+    // its registration untouched
+    m_bindings.resize(bindings.size());
+    m_registered.resize(bindings.size(), false);
+    std::vector<bool> changed(bindings.size(), false);
+    std::vector<bool> released(bindings.size(), false);
+    
+    // Release every changed slot first: swapping two hotkeys must not
+    // collide with the registration it is about to replace
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        if (m_registered[i] && m_bindings[i].hotkey == bindings[i].hotkey) {
+            continue;
+        }
+        changed[i] = true;
+        if (m_registered[i]) {
+            UnregisterHotKey(m_messageWindow, HOTKEY_FIRST_ID + static_cast<int>(i));
+            m_registered[i] = false;
+            released[i] = true;
         }
     }
     
-    // Try to get a valid window from the focus stack
-    // If the top window is invalid, try the next one
-    HWND targetWindow = nullptr;
-    const int MAX_ATTEMPTS = 5;  // Try up to 5 windows from the stack
-    
-    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-        targetWindow = m_monitorManager->GetLastFocusedWindow(m_currentMonitor);
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        if (!changed[i]) {
+            continue;
+        }
         
-        if (!targetWindow) {
-            break;  // No more windows in stack
+        HotkeyBinding previous = m_bindings[i];
+        m_bindings[i] = bindings[i];
+        if (bindings[i].hotkey.vkey == 0) {
+            continue;  // Slot not configured
         }
         
-        // Validate window
-        if (IsWindow(targetWindow) && IsWindowVisible(targetWindow) && !IsIconic(targetWindow)) {
-            // Found a valid window, try to activate it
-            if (ActivateWindow(targetWindow)) {
-                return;  // Success!
+        const HotkeyBinding& binding = m_bindings[i];
+        int hotkeyId = HOTKEY_FIRST_ID + static_cast<int>(i);
+        std::wstring hotkeyString = m_config->FormatHotkey(binding.hotkey);
+        
+        if (!RegisterHotKey(m_messageWindow, hotkeyId, binding.hotkey.modifiers, binding.hotkey.vkey)) {
+            TR_LOG_ERROR("Failed to register hotkey {}: {}", hotkeyString, GetLastError());
+            TR_LOG_ERROR("The hotkey may already be in use by another application.");
+            
+            // Keep what worked before rather than leave the slot empty
+            if (released[i] &&
+                RegisterHotKey(m_messageWindow, hotkeyId, previous.hotkey.modifiers, previous.hotkey.vkey)) {
+                m_bindings[i] = previous;
+                m_registered[i] = true;
+                TR_LOG_INFO("Kept previous hotkey {}", m_config->FormatHotkey(previous.hotkey));
             }
+            continue;
         }
+        m_registered[i] = true;
         
-        // Window is invalid or couldn't be activated, remove it and try next
-        std::cout << "  Removing invalid/unactivatable window from stack" << std::endl;
-        m_monitorManager->RemoveWindowFromStack(m_currentMonitor, targetWindow);
+        if (binding.action == HotkeyAction::CycleMonitor) {
+            TR_LOG_INFO("Hotkey registered: {} = Cycle Monitor", hotkeyString);
+        } else {
+            TR_LOG_INFO("Hotkey registered: {} = Monitor {}", hotkeyString, binding.monitorIndex + 1);
+        }
     }
-    
-    // If we got here, no valid windows were found
-    std::cout << "  No valid windows found on Monitor " << m_currentMonitor << std::endl;
-    
-    // Try to find ANY visible window on this monitor as a fallback
-    m_monitorManager->TryFindWindowOnMonitor(m_currentMonitor);
 }
 
-bool HotkeyManager::ActivateWindow(HWND hwnd) {
-    // Validate window exists
-    if (!IsWindow(hwnd)) {
-        std::cout << "  Window no longer valid" << std::endl;
-        return false;
-    }
-    
-    // Validate window is visible
-    if (!IsWindowVisible(hwnd)) {
-        std::cout << "  Window not visible" << std::endl;
-        return false;
+void HotkeyManager::UnregisterHotkeys() {
+    if (m_messageWindow) {
+        for (size_t i = 0; i < m_registered.size(); ++i) {
+            if (m_registered[i]) {
+                UnregisterHotKey(m_messageWindow, HOTKEY_FIRST_ID + static_cast<int>(i));
+            }
+        }
     }
-    
-    // Don't focus minimized windows
-    if (IsIconic(hwnd)) {
-        std::cout << "  Window is minimized, restoring first" << std::endl;
-        ShowWindow(hwnd, SW_RESTORE);
+    m_registered.assign(m_registered.size(), false);
+}
+
+void HotkeyManager::HandleHotkey(int hotkeyId) {
+    // One bounds check and an index: no search, whatever the number of hotkeys
+    size_t index = static_cast<size_t>(hotkeyId - HOTKEY_FIRST_ID);
+    if (hotkeyId < HOTKEY_FIRST_ID || index >= m_bindings.size()) {
+        return;
     }
-    
-    // Strategy 1: Direct SetForegroundWindow
-    if (SetForegroundWindow(hwnd)) {
-        std::cout << "  Activated successfully (direct)" << std::endl;
-        return true;
+    if (!m_registered[index]) {
+        return;  // Released by a reload after the message was posted
     }
+    const HotkeyBinding& binding = m_bindings[index];
+    RunAction(binding.action, binding.monitorIndex);
+}
+
+int HotkeyManager::CycleMonitor() {
+    return RunAction(HotkeyAction::CycleMonitor, 0);
+}
+
+int HotkeyManager::SelectMonitor(int monitorIndex) {
+    return RunAction(HotkeyAction::SelectMonitor, monitorIndex);
+}
+
+int HotkeyManager::RunAction(HotkeyAction action, int requestedMonitor) {
+    // Start of every hotkey-to-focus measurement
+    ActivationStats::Clock::time_point hotkeyTime = ActivationStats::Clock::now();
+    m_stats->OnHotkey();
     
-    // Strategy 2: AttachThreadInput workaround
-    HWND currentForeground = GetForegroundWindow();
-    if (currentForeground != nullptr) {
-        DWORD foregroundThreadId = GetWindowThreadProcessId(currentForeground, nullptr);
-        DWORD targetThreadId = GetWindowThreadProcessId(hwnd, nullptr);
-        
-        if (foregroundThreadId != 0 && targetThreadId != 0 && foregroundThreadId != targetThreadId) {
-            if (AttachThreadInput(foregroundThreadId, targetThreadId, TRUE)) {
-                SetForegroundWindow(hwnd);
-                SetFocus(hwnd);
-                AttachThreadInput(foregroundThreadId, targetThreadId, FALSE);
-                
-                if (GetForegroundWindow() == hwnd) {
-                    std::cout << "  Activated successfully (AttachThreadInput)" << std::endl;
-                    return true;
-                }
+    int monitorCount = m_monitorManager->GetMonitorCount();
+    if (monitorCount == 0) {
+        TR_LOG_ERROR("No monitors detected");
+        return -1;
+    }
+    
+    int monitorIndex;
+    switch (action) {
+        case HotkeyAction::CycleMonitor:
+            monitorIndex = (m_currentMonitor + 1) % monitorCount;
+            break;
+        case HotkeyAction::SelectMonitor:
+            if (requestedMonitor < 0 || requestedMonitor >= monitorCount) {
+                TR_LOG_DEBUG("Monitor {} is not connected", requestedMonitor + 1);
+                return -1;
             }
-        }
+            monitorIndex = requestedMonitor;
+            break;
+        default:
+            return -1;
     }
     
-    // Strategy 3: BringWindowToTop + SetFocus fallback
-    BringWindowToTop(hwnd);
-    SetFocus(hwnd);
+    SwitchToMonitor(monitorIndex, hotkeyTime);
+    return monitorIndex;
+}
+
+void HotkeyManager::SwitchToMonitor(int monitorIndex, ActivationStats::Clock::time_point hotkeyTime) {
+    // Cycling continues from here, whichever hotkey got us here
+    m_currentMonitor = monitorIndex;
     
-    // Final check
-    bool success = (GetForegroundWindow() == hwnd);
-    if (success) {
-        std::cout << "  Activated successfully (fallback)" << std::endl;
-    } else {
-        std::cout << "  Warning: Could not fully activate window" << std::endl;
+    TR_LOG_DEBUG("Switched to Monitor {}", m_currentMonitor);
+    m_monitorManager->SetCurrentMonitor(m_currentMonitor);  // For status bars reading the shared state
+    
+    // Move mouse cursor to the target monitor if configured (current snapshot, no lock)
+    if (m_config->GetMoveMouse()) {
+        // Move cursor to center of the monitor (cached geometry)
+        MonitorPoint center;
+        if (m_monitorManager->GetMonitorCenter(m_currentMonitor, &center)) {
+            SetCursorPos(center.x, center.y);
+            TR_LOG_DEBUG("  Moved cursor to monitor center ({}, {})", center.x, center.y);
+        }
     }
     
-    return success;
+    // Selection and activation run on the pipeline's worker; a press that
+    // arrives while one is in flight supersedes it
+    m_pipeline->Request(m_currentMonitor, hotkeyTime);
 }
 
 LRESULT CALLBACK HotkeyManager::WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
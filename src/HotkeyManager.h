@@ -1,29 +1,49 @@
 #pragma once
 
 #include <windows.h>
+#include <vector>
+#include "ActivationPipeline.h"
+#include "ActivationStats.h"
 #include "MonitorManager.h"
 #include "Config.h"
 
-// Hotkey IDs
-#define HOTKEY_CYCLE_MONITOR 1
+// Hotkey IDs: HOTKEY_FIRST_ID + index into the binding table, whose first
+// entry is always the cycle hotkey (see Config::GetHotkeyBindings)
+#define HOTKEY_FIRST_ID 1
+#define HOTKEY_CYCLE_MONITOR HOTKEY_FIRST_ID
 
 class HotkeyManager {
 public:
-    HotkeyManager(MonitorManager* monitorManager, Config* config);
+    HotkeyManager(MonitorManager* monitorManager, Config* config, ActivationStats* stats, ActivationPipeline* pipeline);
     ~HotkeyManager();
     
     bool RegisterHotkeys();
     void UnregisterHotkeys();
+    
+    // Message loop thread, after Config::Reload() published new settings:
+    // re-registers only the slots whose key combination changed
+    void ReloadHotkeys();
+    
     void HandleHotkey(int hotkeyId);
+    
+    // Same path as the hotkeys, for commands from other programs (message
+    // loop thread). Return the monitor switched to, or -1 if there is none.
+    int CycleMonitor();
+    int SelectMonitor(int monitorIndex);
 
 private:
     MonitorManager* m_monitorManager;
     Config* m_config;
+    ActivationStats* m_stats;  // Hotkey-to-focus timings
+    ActivationPipeline* m_pipeline;  // Activates targets off the message loop
     int m_currentMonitor;
     HWND m_messageWindow;  // Hidden window for receiving hotkey messages
+    std::vector<HotkeyBinding> m_bindings;  // Indexed by hotkey id - HOTKEY_FIRST_ID
+    std::vector<bool> m_registered;  // Same indices
     
-    // Helper function to activate a window
-    bool ActivateWindow(HWND hwnd);
+    void ApplyBindings(const std::vector<HotkeyBinding>& bindings);
+    int RunAction(HotkeyAction action, int requestedMonitor);
+    void SwitchToMonitor(int monitorIndex, ActivationStats::Clock::time_point hotkeyTime);
     
     // Create hidden message-only window
     bool CreateMessageWindow();
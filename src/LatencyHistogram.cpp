@@ -0,0 +1,106 @@
+#include "LatencyHistogram.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static int HighestBit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+void LatencyHistogram::Reset() {
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::GetBucketIndex(uint64_t valueNs) {
+    // Values below SUB_BUCKETS get one bucket each
+    if (valueNs < static_cast<uint64_t>(SUB_BUCKETS)) {
+        return static_cast<int>(valueNs);
+    }
+
+    // Above that, keep the top SUB_BUCKET_BITS bits: the leading one picks the
+    // power-of-two range, the rest the linear bucket inside it
+    int shift = HighestBit(valueNs) - SUB_BUCKET_BITS + 1;
+    int subBucket = static_cast<int>(valueNs >> shift) - SUB_BUCKETS / 2;
+    return SUB_BUCKETS + (shift - 1) * (SUB_BUCKETS / 2) + subBucket;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return static_cast<uint64_t>(bucket);
+    }
+
+    int shift = (bucket - SUB_BUCKETS) / (SUB_BUCKETS / 2) + 1;
+    uint64_t subBucket = static_cast<uint64_t>((bucket - SUB_BUCKETS) % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2);
+    uint64_t lowest = subBucket << shift;
+    return lowest + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::Record(uint64_t valueNs) {
+    m_buckets[GetBucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(valueNs, std::memory_order_relaxed);
+
+    uint64_t current = m_min.load(std::memory_order_relaxed);
+    while (valueNs < current && !m_min.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+
+    current = m_max.load(std::memory_order_relaxed);
+    while (valueNs > current && !m_max.compare_exchange_weak(current, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::GetMin() const {
+    uint64_t min = m_min.load(std::memory_order_relaxed);
+    return min == UINT64_MAX ? 0 : min;
+}
+
+uint64_t LatencyHistogram::GetMean() const {
+    uint64_t count = GetCount();
+    return count == 0 ? 0 : m_sum.load(std::memory_order_relaxed) / count;
+}
+
+uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const {
+    uint64_t count = GetCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    // Nearest rank, at least the first sample
+    double exactRank = percentile / 100.0 * static_cast<double>(count);
+    uint64_t rank = static_cast<uint64_t>(exactRank);
+    if (static_cast<double>(rank) < exactRank) {
+        ++rank;
+    }
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t max = GetMax();
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t bound = GetBucketUpperBound(i);
+            return bound < max ? bound : max;
+        }
+    }
+
+    return max;  // Counters raced with a concurrent Record()
+}
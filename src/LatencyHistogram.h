@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Fixed-size log-linear latency histogram (HDR-style), values in nanoseconds.
+//
+// Each power-of-two range is split into SUB_BUCKETS / 2 linear buckets, so
+// any recorded value is reported within 2/SUB_BUCKETS (~3%) of its true value,
+// from 1 ns up to the full 64-bit range. Recording is a bit scan plus one
+// relaxed atomic add: safe from any number of threads, no allocation.
+// Readers see a slightly torn but never corrupt view while writers run.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 6;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int BUCKET_COUNT = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * (SUB_BUCKETS / 2);
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t valueNs);
+    void Reset();
+
+    uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t GetMin() const;  // 0 when empty
+    uint64_t GetMax() const { return m_max.load(std::memory_order_relaxed); }
+    uint64_t GetMean() const;
+
+    // Smallest bucket bound covering `percentile` (0-100) of the samples,
+    // clamped to the recorded max; 0 when empty
+    uint64_t GetValueAtPercentile(double percentile) const;
+
+    // Bucket mapping, exposed for the bench accuracy check
+    static int GetBucketIndex(uint64_t valueNs);
+    static uint64_t GetBucketUpperBound(int bucket);
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_min;
+    std::atomic<uint64_t> m_max;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Byte stream between processes of the same user on the same machine.
+//
+// One listener serves one client at a time; further clients wait in
+// Connect() until it is done. Blocking calls on the listener side can be
+// interrupted from another thread with LocalListener::Wake().
+//
+// Backends: a named pipe on Windows (local clients only, the default DACL
+// keeps other users out), a Unix domain socket with mode 0600 elsewhere.
+
+// Endpoint for baseName that is private to the current session/user:
+// "\\.\pipe\<baseName>-<session>" on Windows, "$XDG_RUNTIME_DIR/<baseName>.sock"
+// (or "/tmp/<baseName>-<uid>.sock") elsewhere
+std::string GetLocalChannelName(const std::string& baseName);
+
+class LocalChannel {
+public:
+    LocalChannel();
+    ~LocalChannel();
+
+    LocalChannel(const LocalChannel&) = delete;
+    LocalChannel& operator=(const LocalChannel&) = delete;
+
+    // Client side; waits up to timeoutMs while the listener serves someone else
+    bool Connect(const std::string& name, int timeoutMs);
+    void Close();
+    bool IsOpen() const { return m_handle != nullptr; }
+
+    // Whatever has arrived, up to capacity. False on close, error, timeout
+    // (timeoutMs < 0 waits forever) or, for accepted channels, Wake().
+    bool Receive(char* buffer, size_t capacity, size_t* received, int timeoutMs);
+    bool Send(const char* data, size_t length);  // All of it or false
+
+    uint32_t GetPeerProcessId() const;  // Process at the other end, 0 if unknown
+
+private:
+    friend class LocalListener;
+    struct Handle;  // Defined by the platform implementation
+
+    Handle* m_handle;
+};
+
+class LocalListener {
+public:
+    LocalListener();
+    ~LocalListener();
+
+    LocalListener(const LocalListener&) = delete;
+    LocalListener& operator=(const LocalListener&) = delete;
+
+    bool Listen(const std::string& name);  // False if another listener owns the name
+    void Close();
+    bool IsOpen() const { return m_handle != nullptr; }
+
+    // Blocks until a client connects; false on error or Wake().
+    // Close the previous channel before accepting the next one.
+    bool Accept(LocalChannel* channel);
+
+    // Any thread. Makes Accept() and Receive() on accepted channels return
+    // false, now and from then on.
+    void Wake();
+
+private:
+    struct Handle;
+
+    Handle* m_handle;
+};
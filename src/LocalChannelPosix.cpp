@@ -0,0 +1,242 @@
+#include "LocalChannel.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// POSIX backend: Unix domain stream socket, woken through a self-pipe
+
+struct LocalChannel::Handle {
+    int fd;
+    int wakeFd;  // Listener's wake pipe for accepted channels, -1 for clients
+};
+
+struct LocalListener::Handle {
+    int fd;
+    int wakePipe[2];
+    std::string path;  // Unlinked on Close()
+};
+
+std::string GetLocalChannelName(const std::string& baseName) {
+    // Per-user and only accessible by that user when the session provides it
+    const char* runtimeDirectory = std::getenv("XDG_RUNTIME_DIR");
+    if (runtimeDirectory != nullptr && runtimeDirectory[0] != '\0') {
+        return std::string(runtimeDirectory) + "/" + baseName + ".sock";
+    }
+    return "/tmp/" + baseName + "-" + std::to_string(getuid()) + ".sock";
+}
+
+static bool MakeAddress(const std::string& name, sockaddr_un* address) {
+    std::memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (name.size() >= sizeof(address->sun_path)) {
+        return false;
+    }
+    std::memcpy(address->sun_path, name.c_str(), name.size() + 1);
+    return true;
+}
+
+// True if fd became readable, false on timeout, error or a wake
+static bool WaitReadable(int fd, int wakeFd, int timeoutMs) {
+    pollfd fds[2] = { { fd, POLLIN, 0 }, { wakeFd, POLLIN, 0 } };
+    nfds_t count = wakeFd >= 0 ? 2 : 1;
+
+    for (;;) {
+        int ready = poll(fds, count, timeoutMs);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0 || (count == 2 && fds[1].revents != 0)) {
+            return false;
+        }
+        return fds[0].revents != 0;
+    }
+}
+
+LocalChannel::LocalChannel()
+    : m_handle(nullptr) {
+}
+
+LocalChannel::~LocalChannel() {
+    Close();
+}
+
+bool LocalChannel::Connect(const std::string& name, int timeoutMs) {
+    Close();
+
+    // A listener busy with another client still completes the connect from
+    // its backlog, so the timeout only matters to Receive()
+    (void)timeoutMs;
+
+    sockaddr_un address;
+    if (!MakeAddress(name, &address)) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->fd = fd;
+    m_handle->wakeFd = -1;
+    return true;
+}
+
+void LocalChannel::Close() {
+    if (m_handle != nullptr) {
+        close(m_handle->fd);
+        delete m_handle;
+        m_handle = nullptr;
+    }
+}
+
+bool LocalChannel::Receive(char* buffer, size_t capacity, size_t* received, int timeoutMs) {
+    *received = 0;
+    if (!WaitReadable(m_handle->fd, m_handle->wakeFd, timeoutMs)) {
+        return false;
+    }
+
+    ssize_t bytes;
+    do {
+        bytes = recv(m_handle->fd, buffer, capacity, 0);
+    } while (bytes < 0 && errno == EINTR);
+
+    if (bytes <= 0) {
+        return false;  // Peer closed or failed
+    }
+    *received = static_cast<size_t>(bytes);
+    return true;
+}
+
+bool LocalChannel::Send(const char* data, size_t length) {
+    while (length > 0) {
+        // No SIGPIPE if the peer went away; the error is reported instead
+        ssize_t bytes = send(m_handle->fd, data, length, MSG_NOSIGNAL);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += bytes;
+        length -= static_cast<size_t>(bytes);
+    }
+    return true;
+}
+
+uint32_t LocalChannel::GetPeerProcessId() const {
+#ifdef SO_PEERCRED
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(m_handle->fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0) {
+        return static_cast<uint32_t>(credentials.pid);
+    }
+#endif
+    return 0;
+}
+
+LocalListener::LocalListener()
+    : m_handle(nullptr) {
+}
+
+LocalListener::~LocalListener() {
+    Close();
+}
+
+bool LocalListener::Listen(const std::string& name) {
+    Close();
+
+    sockaddr_un address;
+    if (!MakeAddress(name, &address)) {
+        return false;
+    }
+
+    // A socket file that still accepts connections belongs to a live
+    // listener; one that refuses them was left by a crash and is replaced
+    LocalChannel probe;
+    if (probe.Connect(name, 0)) {
+        return false;
+    }
+    unlink(name.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->fd = fd;
+    m_handle->wakePipe[0] = -1;
+    m_handle->wakePipe[1] = -1;
+
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        Close();
+        return false;
+    }
+    m_handle->path = name;
+
+    // Other users may be able to traverse /tmp, but not connect
+    if (chmod(name.c_str(), S_IRUSR | S_IWUSR) != 0 || listen(fd, 8) != 0 ||
+        pipe2(m_handle->wakePipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void LocalListener::Close() {
+    if (m_handle == nullptr) {
+        return;
+    }
+
+    close(m_handle->fd);
+    if (!m_handle->path.empty()) {
+        unlink(m_handle->path.c_str());
+    }
+    for (int fd : m_handle->wakePipe) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    delete m_handle;
+    m_handle = nullptr;
+}
+
+bool LocalListener::Accept(LocalChannel* channel) {
+    channel->Close();
+
+    if (!WaitReadable(m_handle->fd, m_handle->wakePipe[0], -1)) {
+        return false;
+    }
+
+    int fd;
+    do {
+        fd = accept4(m_handle->fd, nullptr, nullptr, SOCK_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return false;
+    }
+
+    channel->m_handle = new LocalChannel::Handle();
+    channel->m_handle->fd = fd;
+    channel->m_handle->wakeFd = m_handle->wakePipe[0];
+    return true;
+}
+
+void LocalListener::Wake() {
+    // Never drained: the pipe stays readable, so every later wait returns too
+    char byte = 1;
+    ssize_t written = write(m_handle->wakePipe[1], &byte, 1);
+    (void)written;
+}
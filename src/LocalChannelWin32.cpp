@@ -0,0 +1,233 @@
+#include "LocalChannel.h"
+#include <windows.h>
+
+// Win32 backend: one overlapped named pipe instance, reconnected for every
+// client; waits also watch the listener's manual-reset wake event
+
+struct LocalChannel::Handle {
+    HANDLE pipe;
+    HANDLE ioEvent;
+    HANDLE wakeEvent;  // Listener's, for accepted channels; nullptr for clients
+    bool accepted;     // The pipe belongs to the listener: disconnect, don't close
+};
+
+struct LocalListener::Handle {
+    HANDLE pipe;
+    HANDLE ioEvent;
+    HANDLE wakeEvent;
+};
+
+std::string GetLocalChannelName(const std::string& baseName) {
+    // Pipe names are machine-wide; the session keeps two logged-on users apart
+    DWORD session = 0;
+    ProcessIdToSessionId(GetCurrentProcessId(), &session);
+    return "\\\\.\\pipe\\" + baseName + "-" + std::to_string(session);
+}
+
+// Finishes an overlapped operation started on file. False on failure, on
+// timeout or when wakeEvent is set; the operation is cancelled in that case.
+static bool CompleteIo(HANDLE file, OVERLAPPED* overlapped, HANDLE wakeEvent, int timeoutMs, DWORD* bytes) {
+    HANDLE handles[2] = { overlapped->hEvent, wakeEvent };
+    DWORD count = wakeEvent != nullptr ? 2 : 1;
+    DWORD timeout = timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs);
+
+    // The I/O event comes first, so a completion wins over a simultaneous wake
+    if (WaitForMultipleObjects(count, handles, FALSE, timeout) != WAIT_OBJECT_0) {
+        CancelIoEx(file, overlapped);
+        GetOverlappedResult(file, overlapped, bytes, TRUE);  // The buffer must outlive the I/O
+        return false;
+    }
+    return GetOverlappedResult(file, overlapped, bytes, FALSE) != FALSE;
+}
+
+LocalChannel::LocalChannel()
+    : m_handle(nullptr) {
+}
+
+LocalChannel::~LocalChannel() {
+    Close();
+}
+
+bool LocalChannel::Connect(const std::string& name, int timeoutMs) {
+    Close();
+
+    ULONGLONG deadline = GetTickCount64() + static_cast<ULONGLONG>(timeoutMs > 0 ? timeoutMs : 0);
+    HANDLE pipe;
+    for (;;) {
+        // Identification only: a server squatting on the name cannot act as us
+        pipe = CreateFileA(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_OVERLAPPED | SECURITY_SQOS_PRESENT | SECURITY_IDENTIFICATION, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            break;
+        }
+        if (GetLastError() != ERROR_PIPE_BUSY) {
+            return false;
+        }
+
+        // The listener is serving another client
+        ULONGLONG now = GetTickCount64();
+        if (now >= deadline || !WaitNamedPipeA(name.c_str(), static_cast<DWORD>(deadline - now))) {
+            return false;
+        }
+    }
+
+    HANDLE ioEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (ioEvent == nullptr) {
+        CloseHandle(pipe);
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->pipe = pipe;
+    m_handle->ioEvent = ioEvent;
+    m_handle->wakeEvent = nullptr;
+    m_handle->accepted = false;
+    return true;
+}
+
+void LocalChannel::Close() {
+    if (m_handle == nullptr) {
+        return;
+    }
+
+    if (m_handle->accepted) {
+        DisconnectNamedPipe(m_handle->pipe);  // Ready for the next client
+    } else {
+        CloseHandle(m_handle->pipe);
+    }
+    CloseHandle(m_handle->ioEvent);
+    delete m_handle;
+    m_handle = nullptr;
+}
+
+bool LocalChannel::Receive(char* buffer, size_t capacity, size_t* received, int timeoutMs) {
+    *received = 0;
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = m_handle->ioEvent;
+    ResetEvent(m_handle->ioEvent);
+
+    DWORD bytes = 0;
+    if (!ReadFile(m_handle->pipe, buffer, static_cast<DWORD>(capacity), nullptr, &overlapped) &&
+        GetLastError() != ERROR_IO_PENDING) {
+        return false;  // ERROR_BROKEN_PIPE: the peer closed
+    }
+    if (!CompleteIo(m_handle->pipe, &overlapped, m_handle->wakeEvent, timeoutMs, &bytes) || bytes == 0) {
+        return false;
+    }
+
+    *received = bytes;
+    return true;
+}
+
+bool LocalChannel::Send(const char* data, size_t length) {
+    while (length > 0) {
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = m_handle->ioEvent;
+        ResetEvent(m_handle->ioEvent);
+
+        DWORD bytes = 0;
+        if (!WriteFile(m_handle->pipe, data, static_cast<DWORD>(length), nullptr, &overlapped) &&
+            GetLastError() != ERROR_IO_PENDING) {
+            return false;
+        }
+        if (!CompleteIo(m_handle->pipe, &overlapped, m_handle->wakeEvent, -1, &bytes)) {
+            return false;
+        }
+
+        data += bytes;
+        length -= bytes;
+    }
+    return true;
+}
+
+uint32_t LocalChannel::GetPeerProcessId() const {
+    ULONG processId = 0;
+    BOOL known = m_handle->accepted ? GetNamedPipeClientProcessId(m_handle->pipe, &processId)
+                                    : GetNamedPipeServerProcessId(m_handle->pipe, &processId);
+    return known ? static_cast<uint32_t>(processId) : 0;
+}
+
+LocalListener::LocalListener()
+    : m_handle(nullptr) {
+}
+
+LocalListener::~LocalListener() {
+    Close();
+}
+
+bool LocalListener::Listen(const std::string& name) {
+    Close();
+
+    // First instance only, so nobody can have created the name ahead of us;
+    // the default DACL gives other users no write access
+    HANDLE pipe = CreateNamedPipeA(name.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                   PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1,
+                                   4096, 4096, 0, nullptr);
+    if (pipe == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->pipe = pipe;
+    m_handle->ioEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_handle->wakeEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (m_handle->ioEvent == nullptr || m_handle->wakeEvent == nullptr) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void LocalListener::Close() {
+    if (m_handle == nullptr) {
+        return;
+    }
+
+    CloseHandle(m_handle->pipe);
+    if (m_handle->ioEvent != nullptr) {
+        CloseHandle(m_handle->ioEvent);
+    }
+    if (m_handle->wakeEvent != nullptr) {
+        CloseHandle(m_handle->wakeEvent);
+    }
+    delete m_handle;
+    m_handle = nullptr;
+}
+
+bool LocalListener::Accept(LocalChannel* channel) {
+    channel->Close();
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = m_handle->ioEvent;
+    ResetEvent(m_handle->ioEvent);
+
+    if (!ConnectNamedPipe(m_handle->pipe, &overlapped)) {
+        DWORD error = GetLastError();
+        if (error == ERROR_IO_PENDING) {
+            DWORD bytes = 0;
+            if (!CompleteIo(m_handle->pipe, &overlapped, m_handle->wakeEvent, -1, &bytes)) {
+                return false;
+            }
+        } else if (error != ERROR_PIPE_CONNECTED) {  // Connected before we asked: fine
+            return false;
+        }
+    }
+
+    HANDLE ioEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (ioEvent == nullptr) {
+        DisconnectNamedPipe(m_handle->pipe);
+        return false;
+    }
+
+    channel->m_handle = new LocalChannel::Handle();
+    channel->m_handle->pipe = m_handle->pipe;
+    channel->m_handle->ioEvent = ioEvent;
+    channel->m_handle->wakeEvent = m_handle->wakeEvent;
+    channel->m_handle->accepted = true;
+    return true;
+}
+
+void LocalListener::Wake() {
+    SetEvent(m_handle->wakeEvent);  // Manual reset: stays set
+}
@@ -0,0 +1,114 @@
+#include "LogSink.h"
+#include <ctime>
+
+const char* GetLogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default: return "?";
+    }
+}
+
+void ConsoleLogSink::Write(LogLevel level, int64_t wallClockMs, const std::string& message) {
+    (void)wallClockMs;
+
+    if (level >= LogLevel::Warn) {
+        std::fprintf(stderr, "%s\n", message.c_str());
+    } else {
+        std::fprintf(stdout, "%s\n", message.c_str());
+    }
+}
+
+void ConsoleLogSink::Flush() {
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+RotatingFileLogSink::RotatingFileLogSink(const std::string& path, size_t maxBytes, int maxBackups)
+    : m_path(path)
+    , m_maxBytes(maxBytes)
+    , m_maxBackups(maxBackups)
+    , m_file(nullptr)
+    , m_size(0) {
+    Open();
+}
+
+RotatingFileLogSink::~RotatingFileLogSink() {
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+void RotatingFileLogSink::Open() {
+    m_file = std::fopen(m_path.c_str(), "ab");
+    m_size = 0;
+
+    if (m_file) {
+        std::fseek(m_file, 0, SEEK_END);
+        long pos = std::ftell(m_file);
+        m_size = (pos > 0) ? static_cast<size_t>(pos) : 0;
+    }
+}
+
+void RotatingFileLogSink::Rotate() {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    // Shift backups up by one, dropping the oldest
+    std::string oldest = m_path + "." + std::to_string(m_maxBackups);
+    std::remove(oldest.c_str());
+
+    for (int i = m_maxBackups - 1; i >= 1; --i) {
+        std::string from = m_path + "." + std::to_string(i);
+        std::string to = m_path + "." + std::to_string(i + 1);
+        std::rename(from.c_str(), to.c_str());
+    }
+
+    if (m_maxBackups > 0) {
+        std::string first = m_path + ".1";
+        std::rename(m_path.c_str(), first.c_str());
+    } else {
+        std::remove(m_path.c_str());
+    }
+
+    Open();
+}
+
+void RotatingFileLogSink::Write(LogLevel level, int64_t wallClockMs, const std::string& message) {
+    if (m_file && m_size >= m_maxBytes) {
+        Rotate();
+    }
+
+    if (!m_file) {
+        return;  // Silent failure: logging must never take the tool down
+    }
+
+    // Local time with millisecond precision
+    std::time_t seconds = static_cast<std::time_t>(wallClockMs / 1000);
+    std::tm local = {};
+#ifdef _WIN32
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+
+    int written = std::fprintf(m_file, "%s.%03d %-5s %s\n", stamp, static_cast<int>(wallClockMs % 1000),
+                               GetLogLevelName(level), message.c_str());
+    if (written > 0) {
+        m_size += static_cast<size_t>(written);
+    }
+}
+
+void RotatingFileLogSink::Flush() {
+    if (m_file) {
+        std::fflush(m_file);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+};
+
+const char* GetLogLevelName(LogLevel level);
+
+// Destination for formatted log lines. Called only from the logger thread.
+class LogSink {
+public:
+    virtual ~LogSink() {}
+
+    // wallClockMs: milliseconds since the Unix epoch
+    virtual void Write(LogLevel level, int64_t wallClockMs, const std::string& message) = 0;
+    virtual void Flush() {}
+};
+
+// Plain messages to stdout, warnings and errors to stderr (Debug builds)
+class ConsoleLogSink : public LogSink {
+public:
+    void Write(LogLevel level, int64_t wallClockMs, const std::string& message) override;
+    void Flush() override;
+};
+
+// Timestamped lines to a file that rolls over at a size limit:
+// path -> path.1 -> ... -> path.<maxBackups> (oldest is deleted)
+class RotatingFileLogSink : public LogSink {
+public:
+    RotatingFileLogSink(const std::string& path, size_t maxBytes, int maxBackups);
+    ~RotatingFileLogSink();
+
+    void Write(LogLevel level, int64_t wallClockMs, const std::string& message) override;
+    void Flush() override;
+
+private:
+    std::string m_path;
+    size_t m_maxBytes;
+    int m_maxBackups;
+    FILE* m_file;
+    size_t m_size;
+
+    void Open();
+    void Rotate();
+};
+
+// Discards everything (benchmarks)
+class NullLogSink : public LogSink {
+public:
+    void Write(LogLevel, int64_t, const std::string&) override {}
+};
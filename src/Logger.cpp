@@ -0,0 +1,412 @@
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+
+// 1024 records (128 KB) per logging thread
+typedef SpscQueue<LogRecord, 1024> LogRing;
+
+// A thread's ring; freed by the backend once the thread has exited and it is drained
+struct ThreadRing {
+    LogRing queue;
+    std::atomic<bool> orphaned;
+
+    ThreadRing() : orphaned(false) {}
+};
+
+// Records drained from one ring per pass
+static const size_t DRAIN_BATCH = 64;
+
+struct LoggerState {
+    std::mutex mutex;  // Guards everything below except the atomics
+    std::condition_variable wakeCondition;
+    std::vector<std::unique_ptr<ThreadRing>> rings;  // One per live thread that logged
+    uint64_t retiredDrops;  // Drop counts of rings already freed
+    std::vector<std::unique_ptr<LogSink>> sinks;
+    std::thread thread;
+    bool running;
+    bool stopping;
+    bool wakeRequested;
+    std::atomic<bool> sleeping;  // Backend is (about to be) waiting for work
+
+    // Anchors for turning monotonic timestamps into wall-clock time
+    int64_t epochSteadyNs;
+    int64_t epochWallMs;
+
+    LoggerState()
+        : retiredDrops(0)
+        , running(false)
+        , stopping(false)
+        , wakeRequested(false)
+        , sleeping(false) {
+        epochSteadyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        epochWallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+};
+
+static LoggerState g_logger;
+static thread_local LogRing* t_ring = nullptr;
+static thread_local bool t_exited = false;  // Ring handed back; later records are dropped
+
+// Everything that was compiled in is enabled until SetLevel() says otherwise
+std::atomic<int> Logger::s_level(TR_LOG_COMPILED_LEVEL);
+
+// --- LogRecord encoding ---
+
+void LogRecord::PutScalar(ArgType type, const void* data, size_t size) {
+    if (argCount >= MAX_ARGS || payloadSize + size > PAYLOAD_SIZE) {
+        return;  // Out of room: argument is dropped and printed as "?"
+    }
+
+    std::memcpy(payload + payloadSize, data, size);
+    payloadSize = static_cast<uint8_t>(payloadSize + size);
+    argTypes[argCount++] = type;
+}
+
+void LogRecord::PutChars(ArgType type, const void* chars, size_t count, size_t unitSize) {
+    if (argCount >= MAX_ARGS || payloadSize + 1u > PAYLOAD_SIZE) {
+        return;
+    }
+
+    // Truncate to whatever still fits in the record
+    size_t room = (PAYLOAD_SIZE - payloadSize - 1) / unitSize;
+    if (count > room) count = room;
+    if (count > 255) count = 255;
+
+    payload[payloadSize] = static_cast<uint8_t>(count);
+    std::memcpy(payload + payloadSize + 1, chars, count * unitSize);
+    payloadSize = static_cast<uint8_t>(payloadSize + 1 + count * unitSize);
+    argTypes[argCount++] = type;
+}
+
+// --- Formatting (logger thread) ---
+
+static void AppendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+static void AppendWide(std::string& out, const wchar_t* units, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t cp = static_cast<uint32_t>(units[i]);
+
+        // UTF-16 surrogate pair (Windows); a pair split by truncation is dropped
+        if (sizeof(wchar_t) == 2 && cp >= 0xD800 && cp <= 0xDBFF) {
+            if (i + 1 >= count) {
+                break;
+            }
+            uint32_t low = static_cast<uint32_t>(units[++i]);
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        AppendUtf8(out, cp);
+    }
+}
+
+std::string Logger::Format(const LogRecord& record) {
+    std::string out;
+    const char* format = record.site->format;
+    out.reserve(std::strlen(format) + 32);
+
+    size_t offset = 0;
+    uint8_t arg = 0;
+    char buffer[32];
+
+    for (const char* p = format; *p; ++p) {
+        if (p[0] != '{' || p[1] != '}') {
+            out += *p;
+            continue;
+        }
+        ++p;  // Consume the placeholder
+
+        if (arg >= record.argCount) {
+            out += '?';
+            continue;
+        }
+
+        const uint8_t* data = record.payload + offset;
+        switch (record.argTypes[arg++]) {
+            case LogRecord::ARG_INT: {
+                int64_t v;
+                std::memcpy(&v, data, sizeof(v));
+                std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(v));
+                out += buffer;
+                offset += sizeof(v);
+                break;
+            }
+            case LogRecord::ARG_UINT: {
+                uint64_t v;
+                std::memcpy(&v, data, sizeof(v));
+                std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(v));
+                out += buffer;
+                offset += sizeof(v);
+                break;
+            }
+            case LogRecord::ARG_DOUBLE: {
+                double v;
+                std::memcpy(&v, data, sizeof(v));
+                std::snprintf(buffer, sizeof(buffer), "%g", v);
+                out += buffer;
+                offset += sizeof(v);
+                break;
+            }
+            case LogRecord::ARG_BOOL:
+                out += data[0] ? "true" : "false";
+                offset += 1;
+                break;
+            case LogRecord::ARG_CHAR:
+                out += static_cast<char>(data[0]);
+                offset += 1;
+                break;
+            case LogRecord::ARG_POINTER: {
+                const void* v;
+                std::memcpy(&v, data, sizeof(v));
+                std::snprintf(buffer, sizeof(buffer), "0x%llx",
+                              static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(v)));
+                out += buffer;
+                offset += sizeof(v);
+                break;
+            }
+            case LogRecord::ARG_STRING:
+                out.append(reinterpret_cast<const char*>(data + 1), data[0]);
+                offset += 1 + data[0];
+                break;
+            case LogRecord::ARG_WSTRING: {
+                wchar_t units[LogRecord::PAYLOAD_SIZE / sizeof(wchar_t)];
+                std::memcpy(units, data + 1, data[0] * sizeof(wchar_t));
+                AppendWide(out, units, data[0]);
+                offset += 1 + data[0] * sizeof(wchar_t);
+                break;
+            }
+        }
+    }
+
+    return out;
+}
+
+// --- Producer side ---
+
+int64_t Logger::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Marks the thread's ring orphaned when the thread exits
+struct ThreadRingOwner {
+    ThreadRing* ring;
+
+    ThreadRingOwner() : ring(nullptr) {}
+    ~ThreadRingOwner() {
+        t_ring = nullptr;
+        t_exited = true;
+        if (ring) {
+            ring->orphaned.store(true, std::memory_order_release);
+        }
+    }
+};
+
+static LogRing* RegisterThreadRing() {
+    // Only reached once per thread, so the fast path never touches a destructor-bearing thread_local
+    static thread_local ThreadRingOwner owner;
+
+    std::unique_ptr<ThreadRing> ring(new ThreadRing());
+    owner.ring = ring.get();
+    t_ring = &ring->queue;
+
+    std::lock_guard<std::mutex> lock(g_logger.mutex);
+    g_logger.rings.push_back(std::move(ring));
+    return t_ring;
+}
+
+static void WakeBackend() {
+    {
+        std::lock_guard<std::mutex> lock(g_logger.mutex);
+        g_logger.wakeRequested = true;
+    }
+    g_logger.wakeCondition.notify_one();
+}
+
+void Logger::Submit(const LogRecord& record) {
+    LogRing* ring = t_ring;
+    if (!ring) {
+        if (t_exited) {
+            return;  // Logging from a thread_local destructor after the ring was released
+        }
+        ring = RegisterThreadRing();
+    }
+
+    if (!ring->TryPush(record)) {
+        return;  // Counted by the ring
+    }
+
+    // Pairs with the fence in BackendLoop: either we see the backend going to
+    // sleep, or it sees our record. Only the first producer after that pays for the wake.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (g_logger.sleeping.load(std::memory_order_relaxed) && g_logger.sleeping.exchange(false)) {
+        WakeBackend();
+    }
+}
+
+// --- Backend thread ---
+
+static bool AnyRingHasRecords() {
+    for (const std::unique_ptr<ThreadRing>& ring : g_logger.rings) {
+        if (!ring->queue.IsEmpty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Free rings of exited threads once drained (caller holds the mutex). The
+// orphaned flag is set after the thread's last push, so empty means done.
+static void ReclaimOrphanedRings() {
+    std::vector<std::unique_ptr<ThreadRing>>& rings = g_logger.rings;
+    for (size_t i = 0; i < rings.size();) {
+        if (rings[i]->orphaned.load(std::memory_order_acquire) && rings[i]->queue.IsEmpty()) {
+            g_logger.retiredDrops += rings[i]->queue.GetDroppedCount();
+            rings[i] = std::move(rings.back());
+            rings.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+static void BackendLoop() {
+    std::vector<LogRing*> rings;
+    std::vector<LogRecord> pending;
+    LogRecord batch[DRAIN_BATCH];
+    uint64_t reportedDrops = 0;
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(g_logger.mutex);
+            ReclaimOrphanedRings();
+            rings.clear();
+            for (const std::unique_ptr<ThreadRing>& ring : g_logger.rings) {
+                rings.push_back(&ring->queue);
+            }
+        }
+
+        pending.clear();
+        for (LogRing* ring : rings) {
+            size_t n;
+            while ((n = ring->PopBatch(batch, DRAIN_BATCH)) > 0) {
+                pending.insert(pending.end(), batch, batch + n);
+            }
+        }
+
+        if (!pending.empty()) {
+            // Merge the per-thread streams back into time order
+            std::stable_sort(pending.begin(), pending.end(), [](const LogRecord& a, const LogRecord& b) {
+                return a.timestamp < b.timestamp;
+            });
+
+            for (const LogRecord& record : pending) {
+                std::string message = Logger::Format(record);
+                int64_t wallMs = g_logger.epochWallMs + (record.timestamp - g_logger.epochSteadyNs) / 1000000;
+                for (const std::unique_ptr<LogSink>& sink : g_logger.sinks) {
+                    sink->Write(record.site->level, wallMs, message);
+                }
+            }
+
+            uint64_t dropped = Logger::GetDroppedCount();
+            if (dropped != reportedDrops) {
+                std::string message = std::to_string(dropped - reportedDrops) + " log record(s) dropped, ring full";
+                int64_t wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                for (const std::unique_ptr<LogSink>& sink : g_logger.sinks) {
+                    sink->Write(LogLevel::Warn, wallMs, message);
+                }
+                reportedDrops = dropped;
+            }
+
+            for (const std::unique_ptr<LogSink>& sink : g_logger.sinks) {
+                sink->Flush();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(g_logger.mutex);
+        if (g_logger.stopping) {
+            break;  // Only after a pass that found nothing left
+        }
+
+        g_logger.sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (AnyRingHasRecords()) {
+            g_logger.sleeping.store(false);
+            continue;
+        }
+
+        g_logger.wakeCondition.wait(lock, [] { return g_logger.wakeRequested || g_logger.stopping; });
+        g_logger.wakeRequested = false;
+        g_logger.sleeping.store(false);
+    }
+}
+
+// --- Control ---
+
+void Logger::AddSink(std::unique_ptr<LogSink> sink) {
+    std::lock_guard<std::mutex> lock(g_logger.mutex);
+    if (!g_logger.running) {
+        g_logger.sinks.push_back(std::move(sink));
+    }
+}
+
+bool Logger::Start() {
+    std::lock_guard<std::mutex> lock(g_logger.mutex);
+    if (g_logger.running) {
+        return false;
+    }
+
+    g_logger.stopping = false;
+    g_logger.running = true;
+    g_logger.thread = std::thread(BackendLoop);
+    return true;
+}
+
+void Logger::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(g_logger.mutex);
+        if (!g_logger.running) {
+            return;
+        }
+        g_logger.stopping = true;
+    }
+    g_logger.wakeCondition.notify_one();
+    g_logger.thread.join();
+
+    std::lock_guard<std::mutex> lock(g_logger.mutex);
+    g_logger.sinks.clear();  // Flushes and closes files
+    g_logger.running = false;
+}
+
+uint64_t Logger::GetDroppedCount() {
+    std::lock_guard<std::mutex> lock(g_logger.mutex);
+
+    uint64_t total = g_logger.retiredDrops;
+    for (const std::unique_ptr<ThreadRing>& ring : g_logger.rings) {
+        total += ring->queue.GetDroppedCount();
+    }
+    return total;
+}
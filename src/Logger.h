@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "LogSink.h"
+
+// Asynchronous logger with deferred formatting.
+//
+// A log call stores only a pointer to its static call site (level, format
+// string, file, line) plus the raw argument bytes into a per-thread
+// lock-free ring. A background thread merges the rings, formats the text
+// and hands it to the sinks. Format strings use "{}" placeholders.
+//
+// Levels below TR_LOG_COMPILED_LEVEL are compiled out entirely; levels
+// below the runtime level cost one relaxed load.
+
+#define TR_LOG_LEVEL_TRACE 0
+#define TR_LOG_LEVEL_DEBUG 1
+#define TR_LOG_LEVEL_INFO  2
+#define TR_LOG_LEVEL_WARN  3
+#define TR_LOG_LEVEL_ERROR 4
+
+// Release builds keep Info and above unless overridden on the command line
+#ifndef TR_LOG_COMPILED_LEVEL
+    #if defined(_DEBUG) || !defined(NDEBUG)
+        #define TR_LOG_COMPILED_LEVEL TR_LOG_LEVEL_TRACE
+    #else
+        #define TR_LOG_COMPILED_LEVEL TR_LOG_LEVEL_INFO
+    #endif
+#endif
+
+// Static description of one log statement; its address is the format id
+struct LogSite {
+    LogLevel level;
+    const char* format;
+    const char* file;
+    int line;
+};
+
+// Fixed-size binary record as stored in the per-thread rings
+struct LogRecord {
+    static const size_t MAX_ARGS = 8;
+    static const size_t PAYLOAD_SIZE = 96;
+
+    enum ArgType : uint8_t {
+        ARG_INT,
+        ARG_UINT,
+        ARG_DOUBLE,
+        ARG_BOOL,
+        ARG_CHAR,
+        ARG_POINTER,
+        ARG_STRING,   // Length byte + narrow chars (truncated to fit)
+        ARG_WSTRING,  // Length byte + raw wchar_t units (truncated to fit)
+    };
+
+    const LogSite* site;
+    int64_t timestamp;  // Nanoseconds on the logger's monotonic clock
+    uint8_t argCount;
+    uint8_t payloadSize;
+    uint8_t argTypes[MAX_ARGS];
+    uint8_t payload[PAYLOAD_SIZE];
+
+    void Put(int64_t value) { PutScalar(ARG_INT, &value, sizeof(value)); }
+    void Put(uint64_t value) { PutScalar(ARG_UINT, &value, sizeof(value)); }
+    void Put(double value) { PutScalar(ARG_DOUBLE, &value, sizeof(value)); }
+    void Put(bool value) { uint8_t b = value ? 1 : 0; PutScalar(ARG_BOOL, &b, sizeof(b)); }
+    void Put(char value) { PutScalar(ARG_CHAR, &value, sizeof(value)); }
+    void Put(const void* value) { PutScalar(ARG_POINTER, &value, sizeof(value)); }
+    void Put(const char* value) { PutChars(ARG_STRING, value, value ? std::strlen(value) : 0, sizeof(char)); }
+    void Put(const std::string& value) { PutChars(ARG_STRING, value.data(), value.size(), sizeof(char)); }
+    void Put(const wchar_t* value) { PutChars(ARG_WSTRING, value, value ? std::wcslen(value) : 0, sizeof(wchar_t)); }
+    void Put(const std::wstring& value) { PutChars(ARG_WSTRING, value.data(), value.size(), sizeof(wchar_t)); }
+
+private:
+    void PutScalar(ArgType type, const void* data, size_t size);
+    void PutChars(ArgType type, const void* chars, size_t count, size_t unitSize);
+};
+
+class Logger {
+public:
+    // Start the background thread. Sinks must be added before Start().
+    static void AddSink(std::unique_ptr<LogSink> sink);
+    static bool Start();
+    static void Stop();  // Drain everything queued so far, flush and join
+
+    static void SetLevel(LogLevel level) { s_level.store(static_cast<int>(level), std::memory_order_relaxed); }
+    static LogLevel GetLevel() { return static_cast<LogLevel>(s_level.load(std::memory_order_relaxed)); }
+    static bool IsEnabled(LogLevel level) {
+        return static_cast<int>(level) >= s_level.load(std::memory_order_relaxed);
+    }
+
+    static uint64_t GetDroppedCount();  // Records lost to full per-thread rings
+
+    // Hot path: copy the call site and raw arguments into this thread's ring
+    template <typename... Args>
+    static void Write(const LogSite& site, const Args&... args) {
+        LogRecord record;
+        record.site = &site;
+        record.timestamp = Now();
+        record.argCount = 0;
+        record.payloadSize = 0;
+        int expand[] = { 0, (PutArg(record, args), 0)... };
+        (void)expand;
+        Submit(record);
+    }
+
+    // Format a record's text (used by the backend, exposed for benchmarks)
+    static std::string Format(const LogRecord& record);
+
+private:
+    static std::atomic<int> s_level;
+
+    static int64_t Now();
+    static void Submit(const LogRecord& record);
+
+    // Map argument types onto the handful of encodings LogRecord knows
+    static void PutArg(LogRecord& r, bool v) { r.Put(v); }
+    static void PutArg(LogRecord& r, char v) { r.Put(v); }
+    static void PutArg(LogRecord& r, int v) { r.Put(static_cast<int64_t>(v)); }
+    static void PutArg(LogRecord& r, long v) { r.Put(static_cast<int64_t>(v)); }
+    static void PutArg(LogRecord& r, long long v) { r.Put(static_cast<int64_t>(v)); }
+    static void PutArg(LogRecord& r, unsigned v) { r.Put(static_cast<uint64_t>(v)); }
+    static void PutArg(LogRecord& r, unsigned long v) { r.Put(static_cast<uint64_t>(v)); }
+    static void PutArg(LogRecord& r, unsigned long long v) { r.Put(static_cast<uint64_t>(v)); }
+    static void PutArg(LogRecord& r, double v) { r.Put(v); }
+    static void PutArg(LogRecord& r, const char* v) { r.Put(v); }
+    static void PutArg(LogRecord& r, char* v) { r.Put(static_cast<const char*>(v)); }
+    static void PutArg(LogRecord& r, const wchar_t* v) { r.Put(v); }
+    static void PutArg(LogRecord& r, wchar_t* v) { r.Put(static_cast<const wchar_t*>(v)); }
+    static void PutArg(LogRecord& r, const std::string& v) { r.Put(v); }
+    static void PutArg(LogRecord& r, const std::wstring& v) { r.Put(v); }
+    template <typename T>
+    static void PutArg(LogRecord& r, T* v) { r.Put(static_cast<const void*>(v)); }  // Handles, printed as hex
+};
+
+// True if statements at this level survive compilation and the runtime filter.
+// Use it to skip expensive argument preparation.
+#define TR_LOG_ENABLED(level) \
+    (static_cast<int>(level) >= TR_LOG_COMPILED_LEVEL && Logger::IsEnabled(level))
+
+#define TR_LOG(level, format, ...) \
+    do { \
+        if (TR_LOG_ENABLED(level)) { \
+            static const LogSite trLogSite = { level, format, __FILE__, __LINE__ }; \
+            Logger::Write(trLogSite, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define TR_LOG_TRACE(format, ...) TR_LOG(LogLevel::Trace, format, ##__VA_ARGS__)
+#define TR_LOG_DEBUG(format, ...) TR_LOG(LogLevel::Debug, format, ##__VA_ARGS__)
+#define TR_LOG_INFO(format, ...)  TR_LOG(LogLevel::Info, format, ##__VA_ARGS__)
+#define TR_LOG_WARN(format, ...)  TR_LOG(LogLevel::Warn, format, ##__VA_ARGS__)
+#define TR_LOG_ERROR(format, ...) TR_LOG(LogLevel::Error, format, ##__VA_ARGS__)
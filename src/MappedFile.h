@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A file mapped into memory, read-only or read-write.
+//
+// Read-write mappings can be resized; the data pointer changes when they
+// are. Writes land in the page cache and reach disk when the OS flushes
+// them, or on Flush().
+//
+// Backends: CreateFileMapping/MapViewOfFile on Windows, mmap elsewhere.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool OpenRead(const std::string& path);  // Maps the whole file
+    bool OpenReadWrite(const std::string& path, size_t size);  // Creates or opens, then sizes to `size`
+    bool Resize(size_t size);  // Read-write only; remaps
+    bool Flush();  // Read-write only; synchronous
+    void Close();
+
+    bool IsOpen() const { return m_handle != nullptr; }
+    uint8_t* GetData() { return m_data; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    struct Handle;  // Defined by the platform implementation
+
+    Handle* m_handle;
+    uint8_t* m_data;
+    size_t m_size;
+    bool m_writable;
+
+    bool Map(size_t size);  // (Re)map m_handle's file at `size` bytes
+    void Unmap();
+};
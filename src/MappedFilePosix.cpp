@@ -0,0 +1,119 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// POSIX backend: open + ftruncate + mmap(MAP_SHARED)
+
+struct MappedFile::Handle {
+    int fd;
+};
+
+MappedFile::MappedFile()
+    : m_handle(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_writable(false) {
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::OpenRead(const std::string& path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->fd = fd;
+    m_writable = false;
+
+    if (!Map(static_cast<size_t>(info.st_size))) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::OpenReadWrite(const std::string& path, size_t size) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->fd = fd;
+    m_writable = true;
+
+    if (!Resize(size)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::Resize(size_t size) {
+    if (m_handle == nullptr || !m_writable) {
+        return false;
+    }
+
+    Unmap();
+    if (ftruncate(m_handle->fd, static_cast<off_t>(size)) != 0) {
+        return false;
+    }
+    return Map(size);
+}
+
+bool MappedFile::Flush() {
+    if (m_data == nullptr || !m_writable) {
+        return false;
+    }
+    return msync(m_data, m_size, MS_SYNC) == 0;
+}
+
+void MappedFile::Close() {
+    Unmap();
+    if (m_handle != nullptr) {
+        close(m_handle->fd);
+        delete m_handle;
+        m_handle = nullptr;
+    }
+}
+
+bool MappedFile::Map(size_t size) {
+    // mmap rejects zero-length mappings; an empty file is simply open with no data
+    if (size == 0) {
+        return true;
+    }
+
+    int protection = m_writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* data = mmap(nullptr, size, protection, MAP_SHARED, m_handle->fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = static_cast<uint8_t*>(data);
+    m_size = size;
+    return true;
+}
+
+void MappedFile::Unmap() {
+    if (m_data != nullptr) {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    m_size = 0;
+}
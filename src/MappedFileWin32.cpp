@@ -0,0 +1,138 @@
+#include "MappedFile.h"
+#include <windows.h>
+
+// Win32 backend: CreateFile + CreateFileMapping + MapViewOfFile. The mapping
+// object fixes the size, so a resize closes and recreates it.
+
+struct MappedFile::Handle {
+    HANDLE file;
+    HANDLE mapping;
+};
+
+MappedFile::MappedFile()
+    : m_handle(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_writable(false) {
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::OpenRead(const std::string& path) {
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->file = file;
+    m_handle->mapping = nullptr;
+    m_writable = false;
+
+    if (!Map(static_cast<size_t>(fileSize.QuadPart))) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::OpenReadWrite(const std::string& path, size_t size) {
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                              nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->file = file;
+    m_handle->mapping = nullptr;
+    m_writable = true;
+
+    if (!Resize(size)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::Resize(size_t size) {
+    if (m_handle == nullptr || !m_writable) {
+        return false;
+    }
+
+    Unmap();
+
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(m_handle->file, position, nullptr, FILE_BEGIN) || !SetEndOfFile(m_handle->file)) {
+        return false;
+    }
+    return Map(size);
+}
+
+bool MappedFile::Flush() {
+    if (m_data == nullptr || !m_writable) {
+        return false;
+    }
+    return FlushViewOfFile(m_data, m_size) && FlushFileBuffers(m_handle->file);
+}
+
+void MappedFile::Close() {
+    Unmap();
+    if (m_handle != nullptr) {
+        CloseHandle(m_handle->file);
+        delete m_handle;
+        m_handle = nullptr;
+    }
+}
+
+bool MappedFile::Map(size_t size) {
+    // Zero-length mappings are not allowed; an empty file is simply open with no data
+    if (size == 0) {
+        return true;
+    }
+
+    ULARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = static_cast<ULONGLONG>(size);
+    HANDLE mapping = CreateFileMappingA(m_handle->file, nullptr, m_writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        mappingSize.HighPart, mappingSize.LowPart, nullptr);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+    if (data == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_handle->mapping = mapping;
+    m_data = static_cast<uint8_t*>(data);
+    m_size = size;
+    return true;
+}
+
+void MappedFile::Unmap() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_handle != nullptr && m_handle->mapping != nullptr) {
+        CloseHandle(m_handle->mapping);
+        m_handle->mapping = nullptr;
+    }
+    m_size = 0;
+}
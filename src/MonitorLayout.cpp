@@ -0,0 +1,88 @@
+#include "MonitorLayout.h"
+
+void MonitorLayout::Clear() {
+    m_monitors.clear();
+    m_left.clear();
+    m_top.clear();
+    m_right.clear();
+    m_bottom.clear();
+}
+
+int MonitorLayout::Add(const MonitorRect& bounds, const MonitorRect& workArea, bool primary) {
+    MonitorGeometry geometry;
+    geometry.bounds = bounds;
+    geometry.workArea = workArea;
+    geometry.centerX = bounds.left + (bounds.right - bounds.left) / 2;
+    geometry.centerY = bounds.top + (bounds.bottom - bounds.top) / 2;
+    geometry.primary = primary;
+
+    m_monitors.push_back(geometry);
+    m_left.push_back(bounds.left);
+    m_top.push_back(bounds.top);
+    m_right.push_back(bounds.right);
+    m_bottom.push_back(bounds.bottom);
+
+    return static_cast<int>(m_monitors.size()) - 1;
+}
+
+int MonitorLayout::FromPoint(int32_t x, int32_t y) const {
+    const int count = GetCount();
+
+    for (int i = 0; i < count; ++i) {
+        if (x >= m_left[i] && x < m_right[i] && y >= m_top[i] && y < m_bottom[i]) {
+            return i;
+        }
+    }
+
+    return FindNearest(x, y);
+}
+
+int MonitorLayout::FindLargestOverlap(const MonitorRect& rect) const {
+    const int count = GetCount();
+    int best = -1;
+    int64_t bestArea = 0;
+
+    for (int i = 0; i < count; ++i) {
+        int64_t w = static_cast<int64_t>(rect.right < m_right[i] ? rect.right : m_right[i])
+                  - (rect.left > m_left[i] ? rect.left : m_left[i]);
+        int64_t h = static_cast<int64_t>(rect.bottom < m_bottom[i] ? rect.bottom : m_bottom[i])
+                  - (rect.top > m_top[i] ? rect.top : m_top[i]);
+
+        if (w > 0 && h > 0 && w * h > bestArea) {
+            bestArea = w * h;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+int MonitorLayout::FromRect(const MonitorRect& rect) const {
+    int index = FindLargestOverlap(rect);
+    if (index >= 0) {
+        return index;
+    }
+
+    // Entirely off-screen: pick the monitor nearest to the rect's center
+    return FindNearest(rect.left + (rect.right - rect.left) / 2, rect.top + (rect.bottom - rect.top) / 2);
+}
+
+int MonitorLayout::FindNearest(int32_t x, int32_t y) const {
+    const int count = GetCount();
+    int best = -1;
+    int64_t bestDistance = 0;
+
+    for (int i = 0; i < count; ++i) {
+        // Distance from the point to the rectangle (zero inside)
+        int64_t dx = (x < m_left[i]) ? m_left[i] - x : (x >= m_right[i] ? x - m_right[i] + 1 : 0);
+        int64_t dy = (y < m_top[i]) ? m_top[i] - y : (y >= m_bottom[i] ? y - m_bottom[i] + 1 : 0);
+        int64_t distance = dx * dx + dy * dy;
+
+        if (best < 0 || distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Screen rectangle in virtual-desktop pixels (right/bottom exclusive, like RECT)
+struct MonitorRect {
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+struct MonitorPoint {
+    int32_t x;
+    int32_t y;
+};
+
+struct MonitorGeometry {
+    MonitorRect bounds;
+    MonitorRect workArea;  // Bounds minus taskbar/appbars
+    int32_t centerX;
+    int32_t centerY;
+    bool primary;
+};
+
+// Cached monitor table with point/rect -> monitor lookups.
+//
+// Bounds are also kept as separate arrays so a lookup is a tight scan over
+// a few cache lines; with the handful of monitors a desk has, that beats any
+// spatial index. Indices match the order monitors were added.
+class MonitorLayout {
+public:
+    void Clear();
+    int Add(const MonitorRect& bounds, const MonitorRect& workArea, bool primary);  // Returns the new index
+
+    int GetCount() const { return static_cast<int>(m_monitors.size()); }
+    const MonitorGeometry& Get(int monitorIndex) const { return m_monitors[monitorIndex]; }
+
+    int FromPoint(int32_t x, int32_t y) const;  // Containing monitor, else nearest; -1 if empty
+    int FindLargestOverlap(const MonitorRect& rect) const;  // -1 if rect touches no monitor
+    int FromRect(const MonitorRect& rect) const;  // Largest overlap, else nearest; -1 if empty
+
+private:
+    std::vector<MonitorGeometry> m_monitors;
+    std::vector<int32_t> m_left;
+    std::vector<int32_t> m_top;
+    std::vector<int32_t> m_right;
+    std::vector<int32_t> m_bottom;
+
+    int FindNearest(int32_t x, int32_t y) const;
+};
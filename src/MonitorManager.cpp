@@ -1,228 +1,625 @@
 #include "MonitorManager.h"
-#include <iostream>
 #include <algorithm>
+#include <chrono>
+#include "Logger.h"
+#include "WindowCandidate.h"
 
-MonitorManager::MonitorManager() {
+// WM_GETTEXT budget on a title cache miss; a busy owner costs at most this, once
+static const int TITLE_FETCH_TIMEOUT_MS = 50;
+
+// Window handles print as hex, the way HWNDs do
+static const void* AsHandle(WindowKey window) {
+    return reinterpret_cast<const void*>(window);
+}
+
+MonitorManager::MonitorManager(WindowSystem* windowSystem, DisplaySystem* displaySystem,
+                               DesktopProvider* desktopProvider)
+    : m_windowSystem(windowSystem)
+    , m_displaySystem(displaySystem)
+    , m_focusStacks(MAX_DESKTOPS, MAX_MONITORS, MAX_STACK_SIZE)
+    , m_desktopProvider(desktopProvider)
+    , m_currentMonitor(-1)
+    , m_publishedMonitorCount(0) {
+    for (std::atomic<WindowHandle>& target : m_readyTargets) {
+        target.store(0, std::memory_order_relaxed);
+    }
 }
 
 void MonitorManager::EnumerateMonitors() {
-    m_monitors.clear();
+    // Snapshot geometry once so lookups never need the display system
+    MonitorLayout layout;
+    m_displaySystem->GetMonitors(&layout);
+    
+    {
+        std::lock_guard<std::mutex> lock(m_monitorMutex);
+        m_layout = layout;
+    }
     
-    // Use EnumDisplayMonitors to detect all monitors
-    EnumDisplayMonitors(nullptr, nullptr, MonitorEnumProc, reinterpret_cast<LPARAM>(this));
+    {
+        std::lock_guard<std::mutex> lock(m_stackMutex);
+        m_publishedMonitorCount = layout.GetCount();
+        PublishStateLocked();
+    }
     
-    std::cout << "Detected " << m_monitors.size() << " monitor(s)" << std::endl;
+    TR_LOG_INFO("Detected {} monitor(s)", layout.GetCount());
 }
 
 int MonitorManager::GetMonitorCount() const {
-    return static_cast<int>(m_monitors.size());
+    std::lock_guard<std::mutex> lock(m_monitorMutex);
+    return m_layout.GetCount();
 }
 
-int MonitorManager::GetMonitorIndexForWindow(HWND hwnd) const {
-    if (hwnd == nullptr || !IsWindow(hwnd)) {
+int MonitorManager::GetMonitorIndexForWindow(WindowKey window) const {
+    // Also fails for windows that no longer exist
+    MonitorRect windowRect;
+    if (!m_windowSystem->GetWindowRect(window, &windowRect)) {
         return -1;
     }
     
-    // Get the monitor this window is on
-    HMONITOR hMonitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
-    
-    // Find the index of this monitor in our list
-    for (size_t i = 0; i < m_monitors.size(); ++i) {
-        if (m_monitors[i] == hMonitor) {
-            return static_cast<int>(i);
+    {
+        std::lock_guard<std::mutex> lock(m_monitorMutex);
+        int monitorIndex = m_layout.FindLargestOverlap(windowRect);
+        if (monitorIndex >= 0) {
+            return monitorIndex;
         }
     }
     
-    return -1;  // Not found (shouldn't happen with MONITOR_DEFAULTTONEAREST)
+    // Off-screen (e.g. minimized windows are parked at -32000): let the
+    // system resolve the restored position
+    int monitorIndex = m_displaySystem->GetWindowMonitor(window);
+    
+    std::lock_guard<std::mutex> lock(m_monitorMutex);
+    return monitorIndex < m_layout.GetCount() ? monitorIndex : -1;  // Display configuration changed underneath us
 }
 
-HMONITOR MonitorManager::GetMonitorHandle(int monitorIndex) const {
-    if (monitorIndex < 0 || monitorIndex >= static_cast<int>(m_monitors.size())) {
-        return nullptr;
+bool MonitorManager::GetMonitorCenter(int monitorIndex, MonitorPoint* center) const {
+    std::lock_guard<std::mutex> lock(m_monitorMutex);
+    if (monitorIndex < 0 || monitorIndex >= m_layout.GetCount()) {
+        return false;
     }
-    return m_monitors[monitorIndex];
+    
+    center->x = m_layout.Get(monitorIndex).centerX;
+    center->y = m_layout.Get(monitorIndex).centerY;
+    return true;
+}
+
+MonitorLayout MonitorManager::GetLayout() const {
+    std::lock_guard<std::mutex> lock(m_monitorMutex);
+    return m_layout;
 }
 
 void MonitorManager::PrintMonitorInfo() const {
-    for (size_t i = 0; i < m_monitors.size(); ++i) {
-        MONITORINFO info = {};
-        info.cbSize = sizeof(MONITORINFO);
+    std::lock_guard<std::mutex> lock(m_monitorMutex);
+    for (int i = 0; i < m_layout.GetCount(); ++i) {
+        const MonitorGeometry& geometry = m_layout.Get(i);
+        TR_LOG_INFO("Monitor {}: Rect=[{},{},{},{}]{}", i,
+                    geometry.bounds.left, geometry.bounds.top, geometry.bounds.right, geometry.bounds.bottom,
+                    geometry.primary ? " (Primary)" : "");
+    }
+}
+
+size_t MonitorManager::GetTrackedCount() const {
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    return m_focusStacks.GetTrackedCount();
+}
+
+size_t MonitorManager::GetDesktopCount() const {
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    return m_focusStacks.GetDesktopCount();
+}
+
+size_t MonitorManager::GetCachedTitleCount() const {
+    return m_titleCache.GetSize();
+}
+
+void MonitorManager::OnWindowFocused(WindowKey window, int monitorIndex) {
+    if (window == 0 || monitorIndex < 0) {
+        return;  // Invalid window or monitor
+    }
+    
+    bool tracked;
+    DesktopId desktop;
+    DesktopId current;
+    {
+        std::lock_guard<std::mutex> lock(m_stackMutex);
+        tracked = m_focusStacks.Contains(window);
+        desktop = m_focusStacks.GetDesktopOf(window);
+        current = m_focusStacks.GetCurrentDesktop();
+    }
+    
+    // A tracked window's desktop is cached; only a new window costs a query.
+    // Asked without a current desktop: ours may be stale, and a window on it is not pinned anyway.
+    if (!tracked) {
+        desktop = m_desktopProvider->GetWindowDesktop(window, 0);
+    }
+    
+    // Focus on another desktop than the current one: a switch whose cloak
+    // events are still queued, windows moved between desktops, or a new pinned window
+    if (desktop != 0 && desktop != current) {
+        RefreshDesktops();
         
-        if (GetMonitorInfo(m_monitors[i], &info)) {
-            std::cout << "Monitor " << i << ": "
-                      << "Rect=[" << info.rcMonitor.left << "," << info.rcMonitor.top << ","
-                      << info.rcMonitor.right << "," << info.rcMonitor.bottom << "]";
-            
-            if (info.dwFlags & MONITORINFOF_PRIMARY) {
-                std::cout << " (Primary)";
+        // The refresh read the real current desktop, which tells a new pinned window apart
+        if (!tracked) {
+            {
+                std::lock_guard<std::mutex> lock(m_stackMutex);
+                current = m_focusStacks.GetCurrentDesktop();
             }
-            
-            std::cout << std::endl;
+            desktop = m_desktopProvider->GetWindowDesktop(window, current);
         }
     }
+    
+    // Move window to the front (most recent) of the current desktop's stack; the
+    // engine drops duplicates and trims the stack to MAX_STACK_SIZE
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    if (tracked) {
+        desktop = m_focusStacks.GetDesktopOf(window);  // The refresh may have re-homed it
+    }
+    
+    // Whatever the provider says is current, the focused window's desktop is
+    bool switched = m_focusStacks.SetCurrentDesktop(desktop);
+    
+    // Already on top: readers see no new sequence for nothing
+    bool promoted = m_focusStacks.GetTop(monitorIndex) != window && m_focusStacks.Promote(window, monitorIndex, 0);
+    
+    // Foreground means shown, restored and on this desktop, whatever earlier events said
+    m_focusStacks.SetState(window, WINDOW_STATE_VISIBLE);
+    
+    if (promoted || switched) {
+        PublishStateLocked();
+    }
+}
+
+bool MonitorManager::RefreshDesktops() {
+    std::vector<WindowKey> windows;
+    {
+        std::lock_guard<std::mutex> lock(m_stackMutex);
+        m_focusStacks.CopyWindows(&windows);
+    }
+    
+    // Queried without the lock: these are cross-process calls, and only the
+    // focus worker changes desktops
+    DesktopId current = m_desktopProvider->GetCurrentDesktop();
+    std::vector<DesktopId> desktops(windows.size());
+    for (size_t i = 0; i < windows.size(); ++i) {
+        desktops[i] = m_desktopProvider->GetWindowDesktop(windows[i], current);
+    }
+    
+    // Current desktop first, so windows of unknown desktop (pinned) follow it
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    bool changed = m_focusStacks.SetCurrentDesktop(current);
+    for (size_t i = 0; i < windows.size(); ++i) {
+        changed |= m_focusStacks.SetWindowDesktop(windows[i], desktops[i]);
+    }
+    
+    if (changed) {
+        PublishStateLocked();
+    }
+    return changed;
 }
 
-BOOL CALLBACK MonitorManager::MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData) {
-    MonitorManager* pThis = reinterpret_cast<MonitorManager*>(dwData);
-    pThis->m_monitors.push_back(hMonitor);
-    return TRUE;  // Continue enumeration
+WindowKey MonitorManager::GetLastFocusedWindow(int monitorIndex) const {
+    // Return the first (most recent) window
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    return m_focusStacks.GetTop(monitorIndex);
 }
 
-void MonitorManager::OnWindowFocused(HWND hwnd) {
-    if (hwnd == nullptr || !IsWindow(hwnd)) {
-        return;
+void MonitorManager::RemoveWindowFromStack(int monitorIndex, WindowKey window) {
+    bool removed;
+    {
+        std::lock_guard<std::mutex> lock(m_stackMutex);
+        removed = m_focusStacks.RemoveFromMonitor(monitorIndex, window);
+        if (removed) {
+            PublishStateLocked();
+        }
     }
     
-    // Determine which monitor this window is on
-    int monitorIndex = GetMonitorIndexForWindow(hwnd);
-    if (monitorIndex < 0) {
-        return;  // Invalid monitor
+    if (removed) {
+        TR_LOG_DEBUG("  Removed window {} from Monitor {} stack", AsHandle(window), monitorIndex);
+    }
+}
+
+void MonitorManager::RemoveWindowFromAllStacks(WindowKey window) {
+    // A window lives in at most one stack, so a single index probe finds it
+    int monitorIndex;
+    {
+        std::lock_guard<std::mutex> lock(m_stackMutex);
+        monitorIndex = m_focusStacks.Remove(window);
+        if (monitorIndex >= 0) {
+            PublishStateLocked();
+        }
     }
     
-    // Get or create the focus stack for this monitor
-    std::vector<HWND>& stack = m_focusStacks[monitorIndex];
+    if (monitorIndex >= 0) {
+        TR_LOG_DEBUG("  Removed destroyed window {} from Monitor {} stack", AsHandle(window), monitorIndex);
+    }
+}
+
+bool MonitorManager::MoveWindowToMonitor(WindowKey window, int monitorIndex, bool toFront) {
+    int fromIndex;
+    WindowHandle handle;
+    bool moved;
+    {
+        std::lock_guard<std::mutex> lock(m_stackMutex);
+        fromIndex = m_focusStacks.GetMonitorOf(window);
+        handle = m_focusStacks.GetHandle(window);
+        moved = m_focusStacks.MoveToMonitor(window, monitorIndex, toFront);
+        if (moved) {
+            PublishStateLocked();
+        }
+    }
     
-    // Remove hwnd if it's already in the stack (avoid duplicates)
-    auto it = std::find(stack.begin(), stack.end(), hwnd);
-    if (it != stack.end()) {
-        stack.erase(it);
+    if (moved) {
+        ClearReadyTarget(handle);  // No longer the old monitor's target
+        TR_LOG_DEBUG("  Moved window {} from Monitor {} to Monitor {} stack", AsHandle(window), fromIndex, monitorIndex);
     }
+    return moved;
+}
+
+bool MonitorManager::IsWindowTracked(WindowKey window) const {
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    return m_focusStacks.Contains(window);
+}
+
+bool MonitorManager::IsWindowAlive(WindowHandle handle) const {
+    return m_focusStacks.GetRegistry().IsAlive(handle);
+}
+
+uint32_t MonitorManager::GetWindowState(WindowHandle handle) const {
+    return m_focusStacks.GetRegistry().GetState(handle);
+}
+
+bool MonitorManager::SetWindowStateFlag(WindowKey window, uint32_t flag, bool on) {
     
-    // Add hwnd to the front (most recent)
-    stack.insert(stack.begin(), hwnd);
+    // Untracked windows (tooltips, menus, children) fail the first probe
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    uint32_t state = m_focusStacks.GetState(window);
+    return m_focusStacks.SetState(window, on ? (state | flag) : (state & ~flag));
+}
+
+size_t MonitorManager::ReconcileWindowStates() {
+    size_t corrected = 0;
+    std::vector<WindowKey> stack;
     
-    // Limit stack size
-    if (stack.size() > MAX_STACK_SIZE) {
-        stack.resize(MAX_STACK_SIZE);
+    for (int monitorIndex = 0; monitorIndex < GetMonitorCount(); ++monitorIndex) {
+        CopyFocusStack(monitorIndex, &stack);
+        for (WindowKey window : stack) {
+            if (!m_windowSystem->IsWindow(window)) {
+                RemoveWindowFromStack(monitorIndex, window);  // Its destroy event was missed
+                ++corrected;
+                continue;
+            }
+            
+            // Queried without the lock; only the focus worker applies state events
+            uint32_t state = m_windowSystem->GetWindowState(window, WINDOW_STATE_ALL);
+            std::lock_guard<std::mutex> lock(m_stackMutex);
+            if (m_focusStacks.SetState(window, state)) {
+                ++corrected;
+            }
+        }
     }
+    
+    return corrected;
 }
 
-HWND MonitorManager::GetLastFocusedWindow(int monitorIndex) const {
-    auto it = m_focusStacks.find(monitorIndex);
-    if (it == m_focusStacks.end() || it->second.empty()) {
-        return nullptr;
+void MonitorManager::CopyFocusStack(int monitorIndex, std::vector<WindowKey>* stack,
+                                    std::vector<WindowHandle>* handles) const {
+    stack->clear();
+    if (handles != nullptr) {
+        handles->clear();
     }
     
-    // Return the first (most recent) window
-    return it->second[0];
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    m_focusStacks.ForEachHandleInStack(monitorIndex, [stack, handles](WindowKey key, WindowHandle handle) {
+        stack->push_back(key);
+        if (handles != nullptr) {
+            handles->push_back(handle);
+        }
+    });
 }
 
-void MonitorManager::RemoveWindowFromStack(int monitorIndex, HWND hwnd) {
-    auto it = m_focusStacks.find(monitorIndex);
-    if (it == m_focusStacks.end()) {
-        return;
+size_t MonitorManager::SeedFocusStack(int monitorIndex, const std::vector<WindowKey>& windows) {
+    size_t added = 0;
+    
+    DesktopId current;
+    {
+        std::lock_guard<std::mutex> lock(m_stackMutex);
+        current = m_focusStacks.GetCurrentDesktop();
+    }
+    
+    // A handful of windows per monitor; queried before taking the lock
+    std::vector<uint32_t> states(windows.size());
+    std::vector<DesktopId> desktops(windows.size());
+    for (size_t i = 0; i < windows.size(); ++i) {
+        states[i] = m_windowSystem->GetWindowState(windows[i], WINDOW_STATE_ALL);
+        desktops[i] = m_desktopProvider->GetWindowDesktop(windows[i], current);
     }
     
-    std::vector<HWND>& stack = it->second;
-    auto windowIt = std::find(stack.begin(), stack.end(), hwnd);
+    // Windows focused since startup stay on top; seeds only fill the space below
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    for (size_t i = 0; i < windows.size(); ++i) {
+        if (m_focusStacks.Append(windows[i], monitorIndex, desktops[i])) {
+            m_focusStacks.SetState(windows[i], states[i]);
+            ++added;
+        }
+    }
     
-    if (windowIt != stack.end()) {
-        stack.erase(windowIt);
-        std::cout << "  Removed window 0x" << std::hex << hwnd << std::dec 
-                  << " from Monitor " << monitorIndex << " stack" << std::endl;
+    if (added > 0) {
+        PublishStateLocked();
     }
+    
+    return added;
+}
+
+WindowKey MonitorManager::GetReadyTarget(int monitorIndex, WindowHandle* handle) const {
+    if (handle != nullptr) {
+        *handle = 0;
+    }
+    if (monitorIndex < 0 || monitorIndex >= MAX_MONITORS) {
+        return 0;
+    }
+    
+    // Resolves to nothing once the window left the stacks, even if its handle was reused since
+    WindowHandle ready = m_readyTargets[monitorIndex].load(std::memory_order_acquire);
+    WindowKey key = m_focusStacks.GetRegistry().Resolve(ready);
+    if (handle != nullptr && key != 0) {
+        *handle = ready;
+    }
+    return key;
 }
 
-void MonitorManager::RemoveWindowFromAllStacks(HWND hwnd) {
-    for (auto& pair : m_focusStacks) {
-        std::vector<HWND>& stack = pair.second;
-        auto it = std::find(stack.begin(), stack.end(), hwnd);
+bool MonitorManager::RefreshReadyTargets() {
+    bool changed = false;
+    int monitorCount = GetMonitorCount();
+    
+    // Cached states only, no syscalls: events keep them current and
+    // ReconcileWindowStates() fixes whatever the events missed
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    const WindowRegistry& registry = m_focusStacks.GetRegistry();
+    
+    for (int monitorIndex = 0; monitorIndex < MAX_MONITORS; ++monitorIndex) {
+        WindowHandle ready = 0;
+        
+        // Minimized, hidden and cloaked windows keep their place for when they come back
+        if (monitorIndex < monitorCount) {
+            m_focusStacks.ForEachHandleInStack(monitorIndex, [&registry, &ready](WindowKey, WindowHandle handle) {
+                if (ready == 0 && IsWindowStateActivatable(registry.GetState(handle))) {
+                    ready = handle;
+                }
+            });
+        }
         
-        if (it != stack.end()) {
-            stack.erase(it);
-            std::cout << "  Removed destroyed window 0x" << std::hex << hwnd << std::dec 
-                      << " from Monitor " << pair.first << " stack" << std::endl;
+        if (m_readyTargets[monitorIndex].exchange(ready, std::memory_order_acq_rel) != ready) {
+            changed = true;
         }
     }
+    
+    return changed;
 }
 
-// Helper struct for EnumWindows callback
-struct FindWindowData {
-    HMONITOR targetMonitor;
-    HWND foundWindow;
-};
+void MonitorManager::ClearReadyTarget(WindowHandle handle) {
+    for (std::atomic<WindowHandle>& target : m_readyTargets) {
+        WindowHandle expected = handle;
+        target.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+    }
+}
 
-static BOOL CALLBACK FindWindowOnMonitorProc(HWND hwnd, LPARAM lParam) {
-    FindWindowData* data = reinterpret_cast<FindWindowData*>(lParam);
-    
-    // Check if window is visible and not minimized
-    if (!IsWindowVisible(hwnd) || IsIconic(hwnd)) {
-        return TRUE;  // Continue enumeration
+void MonitorManager::FillCandidateGeometry(WindowCandidate* candidate) const {
+    // Only windows that could qualify pay for the title and rect
+    candidate->hasTitle = HasWindowTitle(candidate->window);
+    if (candidate->hasTitle) {
+        if (m_windowSystem->GetWindowRect(candidate->window, &candidate->rect)) {
+            candidate->cloaked = m_windowSystem->GetWindowState(candidate->window, WINDOW_STATE_CLOAKED) != 0;
+        } else {
+            candidate->visible = false;  // Destroyed mid-enumeration
+        }
     }
+}
+
+size_t MonitorManager::SeedFocusStacksFromZOrder() {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     
-    // Check if window has a title (skip invisible/system windows)
-    wchar_t title[256];
-    if (GetWindowTextW(hwnd, title, sizeof(title) / sizeof(title[0])) == 0) {
-        return TRUE;  // Continue enumeration
+    // Top-level windows in z-order, topmost first
+    std::vector<WindowKey> windows;
+    m_windowSystem->EnumerateWindows(&windows);
+    
+    std::vector<WindowCandidate> candidates;
+    candidates.reserve(windows.size());
+    for (WindowKey window : windows) {
+        // Hidden windows are the bulk of the list; don't even record them
+        if (m_windowSystem->GetWindowState(window, WINDOW_STATE_VISIBLE) == 0) {
+            continue;
+        }
+        
+        WindowCandidate candidate = {};
+        candidate.window = window;
+        candidate.visible = true;
+        candidate.minimized = m_windowSystem->GetWindowState(window, WINDOW_STATE_MINIMIZED) != 0;
+        candidate.toolWindow = m_windowSystem->IsToolWindow(window);
+        if (!candidate.minimized && !candidate.toolWindow) {
+            FillCandidateGeometry(&candidate);
+        }
+        candidates.push_back(candidate);
     }
     
-    // Check if window is on the target monitor
-    HMONITOR hMonitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
-    if (hMonitor == data->targetMonitor) {
-        data->foundWindow = hwnd;
-        return FALSE;  // Stop enumeration, found a window
+    MonitorLayout layout = GetLayout();
+    std::vector<std::vector<WindowKey>> buckets;
+    BucketByZOrder(candidates.data(), candidates.size(), layout, MAX_STACK_SIZE, &buckets);
+    
+    size_t seeded = 0;
+    for (size_t monitorIndex = 0; monitorIndex < buckets.size(); ++monitorIndex) {
+        seeded += SeedFocusStack(static_cast<int>(monitorIndex), buckets[monitorIndex]);
     }
     
-    return TRUE;  // Continue enumeration
+    int64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    TR_LOG_INFO("Seeded {} window(s) from z-order ({} visible scanned) in {} us", seeded, candidates.size(), elapsedUs);
+    return seeded;
 }
 
 void MonitorManager::TryFindWindowOnMonitor(int monitorIndex) {
-    if (monitorIndex < 0 || monitorIndex >= static_cast<int>(m_monitors.size())) {
+    // Private copy: the window checks run without our lock
+    MonitorLayout layout = GetLayout();
+    if (monitorIndex < 0 || monitorIndex >= layout.GetCount()) {
         return;
     }
     
-    FindWindowData data;
-    data.targetMonitor = m_monitors[monitorIndex];
-    data.foundWindow = nullptr;
+    std::vector<WindowKey> windows;
+    m_windowSystem->EnumerateWindows(&windows);
     
-    // Enumerate all top-level windows
-    EnumWindows(FindWindowOnMonitorProc, reinterpret_cast<LPARAM>(&data));
-    
-    if (data.foundWindow) {
-        std::cout << "  Found window on monitor, attempting to focus..." << std::endl;
-        SetForegroundWindow(data.foundWindow);
+    for (WindowKey window : windows) {
+        // Gather only what the rule needs, cheapest checks first
+        WindowCandidate candidate = {};
+        candidate.window = window;
+        candidate.visible = m_windowSystem->GetWindowState(window, WINDOW_STATE_VISIBLE) != 0;
+        candidate.minimized = candidate.visible && m_windowSystem->GetWindowState(window, WINDOW_STATE_MINIMIZED) != 0;
+        if (candidate.visible && !candidate.minimized) {
+            FillCandidateGeometry(&candidate);
+        }
+        
+        if (IsFallbackCandidate(candidate, layout, monitorIndex)) {
+            TR_LOG_DEBUG("  Found window on monitor, attempting to focus...");
+            m_windowSystem->SetForeground(window);
+            return;
+        }
     }
 }
 
 void MonitorManager::PrintFocusStacks() const {
-    std::cout << "\n--- Focus Stacks ---" << std::endl;
+    // Titles of new windows still cost a fetch each; skip unless it will be seen
+    if (!TR_LOG_ENABLED(LogLevel::Trace)) {
+        return;
+    }
     
-    for (const auto& pair : m_focusStacks) {
-        int monitorIndex = pair.first;
-        const std::vector<HWND>& stack = pair.second;
-        
-        std::cout << "Monitor " << monitorIndex << ": ";
+    TR_LOG_TRACE("--- Focus Stacks ---");
+    
+    for (int monitorIndex = 0; monitorIndex < GetMonitorCount(); ++monitorIndex) {
+        // Copy the stack so titles are fetched without holding the lock
+        std::vector<WindowKey> stack;
+        std::vector<WindowHandle> handles;
+        CopyFocusStack(monitorIndex, &stack, &handles);
         
         if (stack.empty()) {
-            std::cout << "(empty)";
-        } else {
-            for (size_t i = 0; i < stack.size(); ++i) {
-                HWND hwnd = stack[i];
-                
-                // Verify window is still valid
-                if (!IsWindow(hwnd)) {
-                    continue;  // Skip invalid windows
-                }
-                
-                // Get window title
-                wchar_t title[256] = L"";
-                int titleLength = GetWindowTextW(hwnd, title, sizeof(title) / sizeof(title[0]));
-                
-                if (i > 0) std::cout << " ";
-                
-                // Always show HWND, optionally show title if available
-                std::cout << "[0x" << std::hex << reinterpret_cast<uintptr_t>(hwnd) << std::dec;
-                
-                if (titleLength > 0) {
-                    std::wcout << L": " << title << L"]";
-                } else {
-                    std::cout << "]";
-                }
-            }
+            TR_LOG_TRACE("Monitor {}: (empty)", monitorIndex);
+            continue;
         }
         
-        std::cout << std::endl;
+        TR_LOG_TRACE("Monitor {}:", monitorIndex);
+        
+        for (size_t i = 0; i < stack.size(); ++i) {
+            WindowKey window = stack[i];
+            
+            // Removed since the copy; its handle may already belong to another window
+            if (!IsWindowAlive(handles[i])) {
+                continue;
+            }
+            
+            // Cached after the first dump, so repeated dumps cost no cross-process calls
+            std::wstring title;
+            
+            // Always show the handle, optionally show title if available
+            if (GetWindowTitle(window, &title)) {
+                TR_LOG_TRACE("  [{}: {}]", AsHandle(window), title);
+            } else {
+                TR_LOG_TRACE("  [{}]", AsHandle(window));
+            }
+        }
+    }
+    
+    TR_LOG_TRACE("--------------------");
+}
+
+bool MonitorManager::GetWindowTitle(WindowKey window, std::wstring* title) const {
+    uint32_t generation = 0;
+    TitleState state = m_titleCache.Lookup(window, title, &generation);
+    if (state != TitleState::Unknown) {
+        return state == TitleState::Titled;
+    }
+    
+    // Bounded: a busy or hung owner cannot hold up the caller
+    wchar_t buffer[WindowTitleCache::MAX_TITLE_LENGTH + 1];
+    size_t length = m_windowSystem->GetWindowTitle(window, TITLE_FETCH_TIMEOUT_MS, buffer, WindowTitleCache::MAX_TITLE_LENGTH + 1);
+    
+    m_titleCache.Store(window, buffer, length, generation);
+    title->assign(buffer, length);
+    return length > 0;
+}
+
+bool MonitorManager::HasWindowTitle(WindowKey window) const {
+    uint32_t generation = 0;
+    TitleState state = m_titleCache.Lookup(window, nullptr, &generation);
+    if (state != TitleState::Unknown) {
+        return state == TitleState::Titled;
+    }
+    
+    // The caption the system keeps for the window: read directly, the owner
+    // is never asked. It is the title for a top-level window, so cache it.
+    wchar_t buffer[WindowTitleCache::MAX_TITLE_LENGTH + 1];
+    size_t length = m_windowSystem->GetWindowTitle(window, 0, buffer, WindowTitleCache::MAX_TITLE_LENGTH + 1);
+    
+    m_titleCache.Store(window, buffer, length, generation);
+    return length > 0;
+}
+
+void MonitorManager::InvalidateWindowTitle(WindowKey window) {
+    m_titleCache.Invalidate(window);
+}
+
+void MonitorManager::ForgetWindowTitle(WindowKey window) {
+    m_titleCache.Remove(window);
+}
+
+bool MonitorManager::EnableStatePublishing(const std::string& regionName) {
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    if (!m_statePublisher.Create(regionName)) {
+        TR_LOG_WARN("Warning: Could not create shared focus state {}", regionName);
+        return false;
+    }
+    
+    PublishStateLocked();
+    TR_LOG_INFO("Publishing focus state to {}", regionName);
+    return true;
+}
+
+void MonitorManager::SetCurrentMonitor(int monitorIndex) {
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    if (m_currentMonitor != monitorIndex) {
+        m_currentMonitor = monitorIndex;
+        PublishStateLocked();
+    }
+}
+
+void MonitorManager::CopyFocusState(FocusState* state) const {
+    std::lock_guard<std::mutex> lock(m_stackMutex);
+    FillStateLocked(state);
+}
+
+void MonitorManager::FillStateLocked(FocusState* state) const {
+    static_assert(MAX_MONITORS <= FOCUS_STATE_MAX_MONITORS && MAX_STACK_SIZE <= FOCUS_STATE_MAX_STACK,
+                  "Shared focus state must hold every stack entry");
+    
+    state->currentMonitor = m_currentMonitor;
+    state->monitorCount = static_cast<uint32_t>(std::min(m_publishedMonitorCount, FOCUS_STATE_MAX_MONITORS));
+    
+    for (int monitorIndex = 0; monitorIndex < FOCUS_STATE_MAX_MONITORS; ++monitorIndex) {
+        FocusStateMonitor& monitor = state->monitors[monitorIndex];
+        uint32_t depth = 0;
+        if (monitorIndex < static_cast<int>(state->monitorCount)) {
+            m_focusStacks.ForEachInStack(monitorIndex, [&monitor, &depth](WindowKey window) {
+                if (depth < FOCUS_STATE_MAX_STACK) {
+                    monitor.windows[depth++] = window;
+                }
+            });
+        }
+        monitor.depth = depth;
+    }
+}
+
+void MonitorManager::PublishStateLocked() {
+    if (!m_statePublisher.IsOpen()) {
+        return;
     }
     
-    std::cout << "--------------------\n" << std::endl;
+    // Written in place under the seqlock; readers retry rather than wait
+    FillStateLocked(m_statePublisher.BeginWrite());
+    m_statePublisher.EndWrite();
 }
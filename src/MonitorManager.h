@@ -1,37 +1,111 @@
 #pragma once
 
-#include <windows.h>
+#include <atomic>
+#include <mutex>
+#include <string>
 #include <vector>
-#include <map>
+#include "DesktopFocusStacks.h"
+#include "DesktopProvider.h"
+#include "FocusState.h"
+#include "MonitorLayout.h"
+#include "WindowSystem.h"
+#include "WindowTitleCache.h"
+
+struct WindowCandidate;
 
 class MonitorManager {
 public:
-    MonitorManager();
+    // The systems are borrowed and must outlive the manager
+    MonitorManager(WindowSystem* windowSystem, DisplaySystem* displaySystem, DesktopProvider* desktopProvider);
     
-    void EnumerateMonitors();  // Detect connected monitors
+    void EnumerateMonitors();  // Detect monitors and refresh the geometry cache (call on display changes)
     int GetMonitorCount() const;
-    int GetMonitorIndexForWindow(HWND hwnd) const;  // Which monitor is this window on?
-    HMONITOR GetMonitorHandle(int monitorIndex) const;  // Get monitor handle by index
-    
-    // Focus stack management
-    void OnWindowFocused(HWND hwnd);  // Called when window gets focus
-    HWND GetLastFocusedWindow(int monitorIndex) const;  // Top of stack
-    void RemoveWindowFromStack(int monitorIndex, HWND hwnd);  // Remove invalid window
-    void RemoveWindowFromAllStacks(HWND hwnd);  // Remove from all monitors
+    int GetMonitorIndexForWindow(WindowKey window) const;  // Which monitor is this window on?
+    bool GetMonitorCenter(int monitorIndex, MonitorPoint* center) const;  // From cache, no syscall
+    MonitorLayout GetLayout() const;  // Copy of the cached geometry
+    
+    static int GetMaxMonitors() { return MAX_MONITORS; }
+    static size_t GetMaxStackSize() { return MAX_STACK_SIZE; }
+    
+    // Focus stack management (thread-safe). Per-monitor stacks are those of
+    // the current virtual desktop; windows on other desktops are not visited.
+    void OnWindowFocused(WindowKey window, int monitorIndex);  // Called when window gets focus, monitor already resolved
+    bool RefreshDesktops();  // Focus worker, on desktop switches: re-query every window's desktop; true if anything moved
+    WindowKey GetLastFocusedWindow(int monitorIndex) const;  // Top of stack
+    void RemoveWindowFromStack(int monitorIndex, WindowKey window);  // Remove invalid window
+    void RemoveWindowFromAllStacks(WindowKey window);  // Remove from all monitors
+    bool MoveWindowToMonitor(WindowKey window, int monitorIndex, bool toFront);  // Migrate a tracked window; false if unchanged
+    bool IsWindowTracked(WindowKey window) const;  // O(1), safe to call for every destroy event
+    bool IsWindowAlive(WindowHandle handle) const;  // Still tracked since the handle was taken; lock-free, no syscall
+    uint32_t GetWindowState(WindowHandle handle) const;  // Cached WINDOW_STATE_* bits; lock-free, 0 once the handle died
+    bool SetWindowStateFlag(WindowKey window, uint32_t flag, bool on);  // From window events; true if a tracked window changed
+    size_t ReconcileWindowStates();  // Re-query every stacked window; returns states fixed and dead windows removed
+    void CopyFocusStack(int monitorIndex, std::vector<WindowKey>* stack,
+                        std::vector<WindowHandle>* handles = nullptr) const;  // Most recent first
+    size_t SeedFocusStack(int monitorIndex, const std::vector<WindowKey>& windows);  // Append below live entries, returns count added
+    size_t SeedFocusStacksFromZOrder();  // Startup inventory: one EnumWindows pass, z-order as MRU; returns count added
     void TryFindWindowOnMonitor(int monitorIndex);  // Fallback: find any window
     void PrintFocusStacks() const;  // Debug output
     
+    // Stacks and current monitor, mirrored into shared memory for other processes
+    bool EnableStatePublishing(const std::string& regionName);  // Not fatal if it fails
+    void SetCurrentMonitor(int monitorIndex);  // Hotkey thread, after every switch
+    void CopyFocusState(FocusState* state) const;  // Same content, whether or not publishing is enabled
+    
+    // Per-monitor activation target, validated ahead of the hotkey by the focus worker
+    WindowKey GetReadyTarget(int monitorIndex, WindowHandle* handle = nullptr) const;  // Lock-free, no syscalls; 0 if none is known
+    bool RefreshReadyTargets();  // Focus worker: first activatable window per stack, from cached states; true if any changed
+    
+    // Window titles (thread-safe), cached until the window is renamed or destroyed
+    bool GetWindowTitle(WindowKey window, std::wstring* title) const;  // Fetches with a timeout on a miss; false if untitled
+    bool HasWindowTitle(WindowKey window) const;  // Never sends a message to the window's owner
+    void InvalidateWindowTitle(WindowKey window);  // EVENT_OBJECT_NAMECHANGE
+    void ForgetWindowTitle(WindowKey window);  // EVENT_OBJECT_DESTROY
+    
     // For debugging
     void PrintMonitorInfo() const;
+    size_t GetTrackedCount() const;  // Windows in any stack, on any desktop
+    size_t GetDesktopCount() const;  // Desktops with stacks
+    size_t GetCachedTitleCount() const;
 
 private:
-    std::vector<HMONITOR> m_monitors;
+    // Every window and monitor query goes through these
+    WindowSystem* m_windowSystem;
+    DisplaySystem* m_displaySystem;
     
-    // Per-monitor focus stacks (monitor index -> vector of HWNDs, most recent first)
-    std::map<int, std::vector<HWND>> m_focusStacks;
+    // Cached geometry; replaced wholesale on refresh
+    MonitorLayout m_layout;
+    mutable std::mutex m_monitorMutex;
     
+    static const int MAX_MONITORS = 32;  // Monitors beyond this are not tracked
     static const size_t MAX_STACK_SIZE = 10;  // Limit stack size per monitor
+    static const int MAX_DESKTOPS = 8;  // Desktops with stacks; the least recently used one gives way
+    
+    // Per-(desktop, monitor) focus stacks (most recent first) with a global
+    // window index and each window's desktop cached. Written by the focus
+    // worker, read by the hotkey thread. Handle checks through its registry
+    // need no lock.
+    DesktopFocusStacks m_focusStacks;
+    mutable std::mutex m_stackMutex;
+    
+    // Queried by the focus worker only, never under m_stackMutex
+    DesktopProvider* m_desktopProvider;
+    
+    // Republished after every stack change; guarded by m_stackMutex
+    FocusStatePublisher m_statePublisher;
+    int m_currentMonitor;  // -1 until the first hotkey press
+    int m_publishedMonitorCount;
+    
+    // First visible, non-minimized window of each stack (0 if none), same indices.
+    // Written by the focus worker. Its handle dies when the window leaves the
+    // stacks, so removals don't need to clear it.
+    std::atomic<WindowHandle> m_readyTargets[MAX_MONITORS];
+    
+    // Filled lazily by whoever asks first; has its own lock
+    mutable WindowTitleCache m_titleCache;
     
-    // Callback for EnumDisplayMonitors
-    static BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData);
+    void ClearReadyTarget(WindowHandle handle);
+    void FillStateLocked(FocusState* state) const;  // Caller holds m_stackMutex
+    void PublishStateLocked();  // Caller holds m_stackMutex
+    void FillCandidateGeometry(WindowCandidate* candidate) const;  // Title, rect and cloaking of a visible, restored window
 };
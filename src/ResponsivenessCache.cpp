@@ -0,0 +1,91 @@
+#include "ResponsivenessCache.h"
+
+ResponsivenessCache::ResponsivenessCache()
+    : m_hungCount(0) {
+}
+
+Responsiveness ResponsivenessCache::Update(WindowKey window, bool hung, Clock::time_point now) {
+    if (window == 0) {
+        return Responsiveness::Unknown;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<WindowKey, Entry>::iterator it = m_entries.find(window);
+    if (it == m_entries.end()) {
+        if (m_entries.size() >= MAX_ENTRIES) {
+            EvictStalest();
+        }
+        Entry entry = { hung, now };
+        m_entries.insert(std::make_pair(window, entry));
+        m_hungCount += hung ? 1 : 0;
+        return Responsiveness::Unknown;
+    }
+
+    Responsiveness previous = it->second.hung ? Responsiveness::Hung : Responsiveness::Responsive;
+
+    if (it->second.hung && !hung) {
+        --m_hungCount;
+    } else if (!it->second.hung && hung) {
+        ++m_hungCount;
+    }
+    it->second.hung = hung;
+    it->second.checkedAt = now;
+    return previous;
+}
+
+void ResponsivenessCache::Remove(WindowKey window) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<WindowKey, Entry>::iterator it = m_entries.find(window);
+    if (it != m_entries.end()) {
+        m_hungCount -= it->second.hung ? 1 : 0;
+        m_entries.erase(it);
+    }
+}
+
+Responsiveness ResponsivenessCache::Lookup(WindowKey window, Clock::time_point now, Clock::duration maxAge) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<WindowKey, Entry>::const_iterator it = m_entries.find(window);
+    if (it == m_entries.end() || now - it->second.checkedAt > maxAge) {
+        return Responsiveness::Unknown;
+    }
+    return it->second.hung ? Responsiveness::Hung : Responsiveness::Responsive;
+}
+
+void ResponsivenessCache::GetHungWindows(std::vector<WindowKey>* windows) const {
+    windows->clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : m_entries) {
+        if (entry.second.hung) {
+            windows->push_back(entry.first);
+        }
+    }
+}
+
+size_t ResponsivenessCache::GetHungCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hungCount;
+}
+
+size_t ResponsivenessCache::GetSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void ResponsivenessCache::EvictStalest() {
+    // Rare (only past MAX_ENTRIES distinct windows), so a linear scan is fine
+    std::unordered_map<WindowKey, Entry>::iterator stalest = m_entries.begin();
+    for (std::unordered_map<WindowKey, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->second.checkedAt < stalest->second.checkedAt) {
+            stalest = it;
+        }
+    }
+
+    if (stalest != m_entries.end()) {
+        m_hungCount -= stalest->second.hung ? 1 : 0;
+        m_entries.erase(stalest);
+    }
+}
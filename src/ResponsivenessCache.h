@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "FocusStackEngine.h"
+
+enum class Responsiveness {
+    Unknown,     // Never checked, or the last check is too old to trust
+    Responsive,
+    Hung,
+};
+
+// Last known responsiveness of each window, with the time it was checked.
+// Written by the background prober (and by anyone who just saw a window
+// respond), read before every activation attempt. Thread-safe; one short
+// lock per call.
+class ResponsivenessCache {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Windows beyond this are forgotten, stalest first
+    static const size_t MAX_ENTRIES = 1024;
+
+    ResponsivenessCache();
+
+    Responsiveness Update(WindowKey window, bool hung, Clock::time_point now);  // Returns the previous state, age ignored
+    void Remove(WindowKey window);
+
+    // Unknown if never checked or checked longer than maxAge ago
+    Responsiveness Lookup(WindowKey window, Clock::time_point now, Clock::duration maxAge) const;
+
+    void GetHungWindows(std::vector<WindowKey>* windows) const;
+    size_t GetHungCount() const;
+    size_t GetSize() const;  // Windows with a verdict, hung or not
+
+private:
+    struct Entry {
+        bool hung;
+        Clock::time_point checkedAt;
+    };
+
+    std::unordered_map<WindowKey, Entry> m_entries;
+    size_t m_hungCount;
+    mutable std::mutex m_mutex;
+
+    void EvictStalest();
+};
@@ -0,0 +1,118 @@
+#include "ResponsivenessProber.h"
+#include <algorithm>
+#include "Logger.h"
+
+ResponsivenessProber::ResponsivenessProber()
+    : m_probeSignal(-1)
+    , m_recheckTimer(-1)
+{
+}
+
+ResponsivenessProber::~ResponsivenessProber() {
+    Stop();
+}
+
+bool ResponsivenessProber::Start() {
+    if (m_worker.joinable()) {
+        TR_LOG_ERROR("ResponsivenessProber already started");
+        return false;
+    }
+
+    m_loop.reset(new EventLoop());
+    if (!m_loop->IsValid()) {
+        TR_LOG_ERROR("Failed to create responsiveness prober event loop");
+        m_loop.reset();
+        return false;
+    }
+
+    m_probeSignal = m_loop->AddSignal([this]() { HandleRequests(); });
+    m_worker = std::thread([this]() { m_loop->Run(); });
+    return true;
+}
+
+void ResponsivenessProber::Stop() {
+    if (m_worker.joinable()) {
+        m_loop->RequestStop();
+        m_worker.join();
+    }
+    m_loop.reset();
+    m_recheckTimer = -1;
+}
+
+void ResponsivenessProber::ProbeSoon(const std::vector<HWND>& windows) {
+    if (!m_loop || windows.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        for (HWND hwnd : windows) {
+            if (std::find(m_requests.begin(), m_requests.end(), hwnd) == m_requests.end()) {
+                m_requests.push_back(hwnd);
+            }
+        }
+    }
+
+    m_loop->Notify(m_probeSignal);
+}
+
+void ResponsivenessProber::HandleRequests() {
+    std::vector<HWND> windows;
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        windows.swap(m_requests);
+    }
+
+    for (HWND hwnd : windows) {
+        Probe(hwnd);
+    }
+
+    UpdateRecheckTimer();
+}
+
+void ResponsivenessProber::RecheckHung() {
+    std::vector<WindowKey> hung;
+    m_cache.GetHungWindows(&hung);
+
+    for (WindowKey key : hung) {
+        Probe(reinterpret_cast<HWND>(key));
+    }
+
+    UpdateRecheckTimer();
+}
+
+void ResponsivenessProber::Probe(HWND hwnd) {
+    WindowKey key = reinterpret_cast<WindowKey>(hwnd);
+    if (!IsWindow(hwnd)) {
+        m_cache.Remove(key);
+        return;
+    }
+
+    // IsHungAppWindow only reads a flag (no input pulled for 5 s); the
+    // round trip catches windows that are busy but not yet flagged
+    bool hung = (IsHungAppWindow(hwnd) != FALSE);
+    if (!hung) {
+        DWORD_PTR result = 0;
+        if (!SendMessageTimeoutW(hwnd, WM_NULL, 0, 0, SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT, PROBE_TIMEOUT_MS, &result)) {
+            // Other failures (e.g. UIPI) say nothing about responsiveness
+            hung = (GetLastError() == ERROR_TIMEOUT);
+        }
+    }
+
+    Responsiveness previous = m_cache.Update(key, hung, ResponsivenessCache::Clock::now());
+    if (hung != (previous == Responsiveness::Hung)) {
+        TR_LOG_DEBUG("  Window {} {}", hwnd, hung ? "stopped responding" : "is responding again");
+    }
+}
+
+void ResponsivenessProber::UpdateRecheckTimer() {
+    // Only known-hung windows are watched, so a healthy desktop costs no wakeups
+    if (m_cache.GetHungCount() == 0 || m_recheckTimer >= 0) {
+        return;
+    }
+
+    m_recheckTimer = m_loop->AddTimer(std::chrono::milliseconds(RECHECK_MS), false, [this]() {
+        m_recheckTimer = -1;
+        RecheckHung();
+    });
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <windows.h>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "EventLoop.h"
+#include "ResponsivenessCache.h"
+
+// Keeps a ResponsivenessCache current from its own thread, so a probe that
+// waits on a hung window never delays activation or focus tracking.
+//
+// Probes happen on request only. The one timer runs while some window is
+// known to be hung, to notice it recovering; otherwise the thread sleeps.
+class ResponsivenessProber {
+public:
+    static const int PROBE_TIMEOUT_MS = 100;  // SendMessageTimeout budget per window
+    static const int RECHECK_MS = 1000;       // Re-probe interval for hung windows
+
+    ResponsivenessProber();
+    ~ResponsivenessProber();
+
+    bool Start();
+    void Stop();
+
+    // Any thread; windows already waiting for a probe are merged
+    void ProbeSoon(const std::vector<HWND>& windows);
+
+    ResponsivenessCache& GetCache() { return m_cache; }
+    const ResponsivenessCache& GetCache() const { return m_cache; }
+
+private:
+    ResponsivenessCache m_cache;
+
+    std::unique_ptr<EventLoop> m_loop;
+    std::thread m_worker;
+    EventLoop::SignalId m_probeSignal;
+    EventLoop::TimerId m_recheckTimer;  // Worker-only, -1 if none
+
+    std::vector<HWND> m_requests;
+    std::mutex m_requestMutex;
+
+    void HandleRequests();
+    void RecheckHung();
+    void Probe(HWND hwnd);
+    void UpdateRecheckTimer();
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A named shared memory region: created read-write by one process, mapped
+// read-only by any number of others.
+//
+// The size is fixed at creation. Readers map whatever size the region has.
+//
+// Backends: CreateFileMapping on the paging file on Windows (the name lives
+// until the last handle closes), shm_open + mmap elsewhere (the creator
+// unlinks the name on Close()).
+class SharedMemory {
+public:
+    SharedMemory();
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    bool Create(const std::string& name, size_t size);  // Zero-filled; reuses a region left by a crash
+    bool OpenRead(const std::string& name);
+    void Close();
+
+    bool IsOpen() const { return m_handle != nullptr; }
+    uint8_t* GetData() { return m_data; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    struct Handle;  // Defined by the platform implementation
+
+    Handle* m_handle;
+    uint8_t* m_data;
+    size_t m_size;
+};
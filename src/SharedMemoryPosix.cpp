@@ -0,0 +1,99 @@
+#include "SharedMemory.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// POSIX backend: shm_open + ftruncate + mmap(MAP_SHARED)
+
+struct SharedMemory::Handle {
+    int fd;
+    std::string name;  // Set when we created the region and must unlink it
+};
+
+SharedMemory::SharedMemory()
+    : m_handle(nullptr)
+    , m_data(nullptr)
+    , m_size(0) {
+}
+
+SharedMemory::~SharedMemory() {
+    Close();
+}
+
+bool SharedMemory::Create(const std::string& name, size_t size) {
+    Close();
+
+    // A fresh object rather than truncating a crashed writer's: readers that
+    // still map the old one keep valid (if stale) memory instead of SIGBUS
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->fd = fd;
+    m_handle->name = name;
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        Close();
+        return false;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<uint8_t*>(data);
+    m_size = size;
+    return true;
+}
+
+bool SharedMemory::OpenRead(const std::string& name) {
+    Close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->fd = fd;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        Close();
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<uint8_t*>(data);
+    m_size = size;
+    return true;
+}
+
+void SharedMemory::Close() {
+    if (m_data != nullptr) {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    m_size = 0;
+
+    if (m_handle != nullptr) {
+        close(m_handle->fd);
+        if (!m_handle->name.empty()) {
+            shm_unlink(m_handle->name.c_str());
+        }
+        delete m_handle;
+        m_handle = nullptr;
+    }
+}
@@ -0,0 +1,92 @@
+#include "SharedMemory.h"
+#include <windows.h>
+
+// Win32 backend: CreateFileMapping backed by the paging file + MapViewOfFile
+
+struct SharedMemory::Handle {
+    HANDLE mapping;
+};
+
+SharedMemory::SharedMemory()
+    : m_handle(nullptr)
+    , m_data(nullptr)
+    , m_size(0) {
+}
+
+SharedMemory::~SharedMemory() {
+    Close();
+}
+
+bool SharedMemory::Create(const std::string& name, size_t size) {
+    Close();
+
+    ULARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = static_cast<ULONGLONG>(size);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, mappingSize.HighPart,
+                                        mappingSize.LowPart, name.c_str());
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->mapping = mapping;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (data == nullptr) {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<uint8_t*>(data);
+    m_size = size;
+
+    // A reader can keep the name alive past a crash; start from zero either way
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        ZeroMemory(m_data, m_size);
+    }
+    return true;
+}
+
+bool SharedMemory::OpenRead(const std::string& name) {
+    Close();
+
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    m_handle = new Handle();
+    m_handle->mapping = mapping;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        Close();
+        return false;
+    }
+
+    // The view covers the whole section, rounded up to a page
+    MEMORY_BASIC_INFORMATION info;
+    if (VirtualQuery(data, &info, sizeof(info)) == 0) {
+        UnmapViewOfFile(data);
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<uint8_t*>(data);
+    m_size = static_cast<size_t>(info.RegionSize);
+    return true;
+}
+
+void SharedMemory::Close() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    m_size = 0;
+
+    if (m_handle != nullptr) {
+        CloseHandle(m_handle->mapping);
+        delete m_handle;
+        m_handle = nullptr;
+    }
+}
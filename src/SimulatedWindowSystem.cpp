@@ -0,0 +1,352 @@
+#include "SimulatedWindowSystem.h"
+#include <algorithm>
+
+SimulatedWindowSystem::SimulatedWindowSystem()
+    : m_now()
+    , m_nextTimer(1)
+    , m_nextKey(0x10000)
+    , m_nextThread(100)
+    , m_foreground(0)
+    , m_currentDesktop(0)
+    , m_calls(0)
+{
+}
+
+int SimulatedWindowSystem::AddMonitor(const MonitorRect& bounds, bool primary) {
+    return m_layout.Add(bounds, bounds, primary);
+}
+
+void SimulatedWindowSystem::ClearMonitors() {
+    m_layout.Clear();
+}
+
+const SimWindowSpec* SimulatedWindowSystem::Find(WindowKey window) const {
+    std::unordered_map<WindowKey, SimWindowSpec>::const_iterator it = m_windows.find(window);
+    return it != m_windows.end() ? &it->second : nullptr;
+}
+
+WindowKey SimulatedWindowSystem::AddWindow(const SimWindowSpec& spec) {
+    // Spaced like real HWNDs, so low bits stay free as they would on Windows
+    WindowKey window = m_nextKey;
+    m_nextKey += 16;
+
+    SimWindowSpec& created = m_windows[window];
+    created = spec;
+    if (created.thread == 0) {
+        created.thread = m_nextThread++;
+    }
+    if (created.process == 0) {
+        created.process = created.thread;
+    }
+    if (created.desktop == 0) {
+        created.desktop = m_currentDesktop;
+    }
+
+    m_zOrder.insert(m_zOrder.begin(), window);
+    return window;
+}
+
+bool SimulatedWindowSystem::DestroyWindow(WindowKey window) {
+    if (m_windows.erase(window) == 0) {
+        return false;
+    }
+
+    m_zOrder.erase(std::find(m_zOrder.begin(), m_zOrder.end(), window));
+    if (m_foreground == window) {
+        m_foreground = 0;
+    }
+    return true;
+}
+
+bool SimulatedWindowSystem::SetWindowState(WindowKey window, uint32_t state) {
+    std::unordered_map<WindowKey, SimWindowSpec>::iterator it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return false;
+    }
+    it->second.state = state;
+    if (window == m_foreground && !IsWindowStateActivatable(state)) {
+        m_foreground = 0;  // Hidden or minimized away: nothing is in front until the next activation
+    }
+    return true;
+}
+
+bool SimulatedWindowSystem::MoveWindow(WindowKey window, const MonitorRect& rect) {
+    std::unordered_map<WindowKey, SimWindowSpec>::iterator it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return false;
+    }
+    it->second.rect = rect;
+    return true;
+}
+
+bool SimulatedWindowSystem::MoveWindowToDesktop(WindowKey window, DesktopId desktop) {
+    std::unordered_map<WindowKey, SimWindowSpec>::iterator it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return false;
+    }
+    it->second.desktop = desktop;
+    if (window == m_foreground && desktop != m_currentDesktop) {
+        m_foreground = 0;
+    }
+    return true;
+}
+
+bool SimulatedWindowSystem::SetHung(WindowKey window, bool hung) {
+    std::unordered_map<WindowKey, SimWindowSpec>::iterator it = m_windows.find(window);
+    if (it == m_windows.end()) {
+        return false;
+    }
+    it->second.hung = hung;
+    return true;
+}
+
+bool SimulatedWindowSystem::Focus(WindowKey window) {
+    return Activate(window);
+}
+
+void SimulatedWindowSystem::Raise(WindowKey window) {
+    std::vector<WindowKey>::iterator it = std::find(m_zOrder.begin(), m_zOrder.end(), window);
+    if (it != m_zOrder.end()) {
+        std::rotate(m_zOrder.begin(), it, it + 1);
+    }
+}
+
+bool SimulatedWindowSystem::Activate(WindowKey window) {
+    const SimWindowSpec* spec = Find(window);
+    if (spec == nullptr || spec->hung) {
+        return false;
+    }
+
+    // Foreground at once, on its desktop; the hook hears about it a little later
+    m_currentDesktop = spec->desktop;
+    m_foreground = window;
+    Raise(window);
+    AddTimer(spec->foregroundLatency, [this, window]() {
+        if (m_foregroundListener && Find(window) != nullptr) {
+            m_foregroundListener(window);
+        }
+    });
+    return true;
+}
+
+bool SimulatedWindowSystem::IsAttached(uint32_t a, uint32_t b) const {
+    for (const std::pair<uint32_t, uint32_t>& pair : m_attached) {
+        if ((pair.first == a && pair.second == b) || (pair.first == b && pair.second == a)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SimulatedWindowSystem::TimerId SimulatedWindowSystem::AddTimer(Clock::duration delay, std::function<void()> fn) {
+    TimerId id = m_nextTimer++;
+    Clock::time_point due = m_now + (delay > Clock::duration::zero() ? delay : Clock::duration::zero());
+    m_queue[QueueKey(due, id)] = fn;
+    m_timerDue[id] = due;
+    return id;
+}
+
+bool SimulatedWindowSystem::CancelTimer(TimerId id) {
+    std::unordered_map<TimerId, Clock::time_point>::iterator it = m_timerDue.find(id);
+    if (it == m_timerDue.end()) {
+        return false;
+    }
+    m_queue.erase(QueueKey(it->second, id));
+    m_timerDue.erase(it);
+    return true;
+}
+
+void SimulatedWindowSystem::RunDue(Clock::time_point until) {
+    // One at a time: a callback may schedule or cancel anything, including more work due now
+    while (!m_queue.empty() && m_queue.begin()->first.first <= until) {
+        std::map<QueueKey, std::function<void()>>::iterator next = m_queue.begin();
+        m_now = std::max(m_now, next->first.first);
+        std::function<void()> fn = next->second;
+        m_timerDue.erase(next->first.second);
+        m_queue.erase(next);
+        fn();
+    }
+}
+
+void SimulatedWindowSystem::Advance(Clock::duration duration) {
+    Clock::time_point until = m_now + duration;
+    RunDue(until);
+    m_now = until;
+}
+
+bool SimulatedWindowSystem::RunNext() {
+    if (m_queue.empty()) {
+        return false;
+    }
+    RunDue(m_queue.begin()->first.first);
+    return true;
+}
+
+bool SimulatedWindowSystem::IsWindow(WindowKey window) {
+    ++m_calls;
+    return Find(window) != nullptr;
+}
+
+uint32_t SimulatedWindowSystem::GetWindowState(WindowKey window, uint32_t mask) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    if (spec == nullptr) {
+        return 0;
+    }
+
+    uint32_t state = spec->state;
+    if (spec->desktop != m_currentDesktop) {
+        state |= WINDOW_STATE_CLOAKED;
+    }
+    return state & mask;
+}
+
+bool SimulatedWindowSystem::GetWindowRect(WindowKey window, MonitorRect* rect) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    if (spec == nullptr) {
+        return false;
+    }
+
+    if ((spec->state & WINDOW_STATE_MINIMIZED) != 0) {
+        int32_t width = 160;
+        int32_t height = 28;
+        MonitorRect parked = { MINIMIZED_POSITION, MINIMIZED_POSITION, MINIMIZED_POSITION + width,
+                               MINIMIZED_POSITION + height };
+        *rect = parked;
+    } else {
+        *rect = spec->rect;
+    }
+    return true;
+}
+
+bool SimulatedWindowSystem::IsToolWindow(WindowKey window) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    return spec != nullptr && spec->toolWindow;
+}
+
+bool SimulatedWindowSystem::IsHung(WindowKey window) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    return spec != nullptr && spec->hung;
+}
+
+uint32_t SimulatedWindowSystem::GetWindowThread(WindowKey window, uint32_t* processId) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    if (processId != nullptr) {
+        *processId = spec != nullptr ? spec->process : 0;
+    }
+    return spec != nullptr ? spec->thread : 0;
+}
+
+WindowKey SimulatedWindowSystem::GetForeground() {
+    ++m_calls;
+    return m_foreground;
+}
+
+void SimulatedWindowSystem::EnumerateWindows(std::vector<WindowKey>* windows) {
+    ++m_calls;
+    *windows = m_zOrder;
+}
+
+size_t SimulatedWindowSystem::GetWindowTitle(WindowKey window, int, wchar_t* buffer, size_t capacity) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    if (spec == nullptr || capacity == 0) {
+        return 0;
+    }
+
+    size_t length = std::min(spec->title.size(), capacity - 1);
+    std::copy(spec->title.begin(), spec->title.begin() + length, buffer);
+    buffer[length] = L'\0';
+    return length;
+}
+
+bool SimulatedWindowSystem::SetForeground(WindowKey window) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    if (spec == nullptr) {
+        return false;
+    }
+
+    // The foreground lock: refusal is either a failed call or a silent no-op
+    const SimWindowSpec* foreground = Find(m_foreground);
+    switch (spec->focusPolicy) {
+        case SimFocusPolicy::Accept:
+            Activate(window);
+            return true;
+
+        case SimFocusPolicy::NeedsAttach:
+            if (foreground != nullptr && IsAttached(foreground->thread, spec->thread)) {
+                Activate(window);
+                return true;
+            }
+            return false;
+
+        default:
+            return true;
+    }
+}
+
+bool SimulatedWindowSystem::AttachInput(uint32_t fromThread, uint32_t toThread, bool attach) {
+    ++m_calls;
+    if (fromThread == 0 || toThread == 0 || fromThread == toThread) {
+        return false;
+    }
+
+    std::pair<uint32_t, uint32_t> pair(fromThread, toThread);
+    std::vector<std::pair<uint32_t, uint32_t>>::iterator it = std::find(m_attached.begin(), m_attached.end(), pair);
+    if (attach) {
+        if (it == m_attached.end()) {
+            m_attached.push_back(pair);
+        }
+        return true;
+    }
+
+    if (it == m_attached.end()) {
+        return false;
+    }
+    m_attached.erase(it);
+    return true;
+}
+
+void SimulatedWindowSystem::SetFocus(WindowKey) {
+    ++m_calls;  // Keyboard focus is not modeled
+}
+
+void SimulatedWindowSystem::BringToTop(WindowKey window) {
+    ++m_calls;
+    Activate(window);
+}
+
+void SimulatedWindowSystem::GetMonitors(MonitorLayout* layout) {
+    ++m_calls;
+    *layout = m_layout;
+}
+
+int SimulatedWindowSystem::GetWindowMonitor(WindowKey window) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    return spec != nullptr ? m_layout.FromRect(spec->rect) : -1;
+}
+
+void SimulatedWindowSystem::SwitchDesktop(DesktopId desktop) {
+    m_currentDesktop = desktop;
+    const SimWindowSpec* foreground = Find(m_foreground);
+    if (foreground != nullptr && foreground->desktop != desktop) {
+        m_foreground = 0;
+    }
+}
+
+DesktopId SimulatedWindowSystem::GetCurrentDesktop() {
+    ++m_calls;
+    return m_currentDesktop;
+}
+
+DesktopId SimulatedWindowSystem::GetWindowDesktop(WindowKey window, DesktopId) {
+    ++m_calls;
+    const SimWindowSpec* spec = Find(window);
+    return spec != nullptr ? spec->desktop : 0;
+}
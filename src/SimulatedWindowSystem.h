@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "DesktopProvider.h"
+#include "WindowSystem.h"
+
+// How a simulated window reacts to being brought to the foreground
+enum class SimFocusPolicy {
+    Accept,           // SetForeground works
+    NeedsAttach,      // SetForeground is refused unless input is attached to the foreground thread
+    NeedsBringToTop,  // SetForeground claims success and does nothing; only BringToTop works
+};
+
+struct SimWindowSpec {
+    MonitorRect rect = { 0, 0, 800, 600 };  // Restored position
+    uint32_t state = WINDOW_STATE_VISIBLE;
+    uint32_t thread = 0;  // 0: a thread of its own
+    uint32_t process = 0;  // 0: a process of its own
+    bool toolWindow = false;
+    bool hung = false;  // Never takes the foreground, never answers
+    SimFocusPolicy focusPolicy = SimFocusPolicy::Accept;
+    DesktopId desktop = 0;  // 0: the desktop current when it opens
+    std::chrono::microseconds foregroundLatency = std::chrono::microseconds(2000);  // Activation to foreground event
+    std::wstring title = L"Window";
+};
+
+// In-memory WindowSystem, DisplaySystem and DesktopProvider with a virtual
+// clock: windows, monitors, virtual desktops, z-order, foreground and focus
+// refusal, all deterministic. Time
+// only moves through Advance() or RunNext(), which run timers and deliver
+// foreground events in due order; the same calls give the same run on every
+// machine.
+//
+// The world is built through its own methods (AddWindow, Focus, ...),
+// which are not counted as calls. Window keys are never reused.
+//
+// Not thread-safe; a simulation runs on one thread.
+class SimulatedWindowSystem : public WindowSystem, public DisplaySystem, public DesktopProvider {
+public:
+    typedef uint64_t TimerId;
+    typedef std::function<void(WindowKey)> ForegroundListener;
+
+    // Where Windows parks minimized windows
+    static const int32_t MINIMIZED_POSITION = -32000;
+
+    SimulatedWindowSystem();
+
+    // Monitors; work area = bounds
+    int AddMonitor(const MonitorRect& bounds, bool primary);
+    void ClearMonitors();
+
+    // Windows
+    WindowKey AddWindow(const SimWindowSpec& spec);  // Opens on top of the z-order, not focused
+    bool DestroyWindow(WindowKey window);
+    bool SetWindowState(WindowKey window, uint32_t state);
+    bool MoveWindow(WindowKey window, const MonitorRect& rect);
+    bool SetHung(WindowKey window, bool hung);
+    bool Focus(WindowKey window);  // The user clicks it; false if it cannot take the foreground
+    bool MoveWindowToDesktop(WindowKey window, DesktopId desktop);
+    const SimWindowSpec* GetSpec(WindowKey window) const { return Find(window); }  // Null once destroyed
+    size_t GetWindowCount() const { return m_windows.size(); }
+
+    // Virtual desktops; 0 (the default) means none. Windows on other desktops
+    // read as cloaked, and activating one switches to its desktop.
+    void SwitchDesktop(DesktopId desktop);
+
+    // The EVENT_SYSTEM_FOREGROUND hook: called as each foreground event is delivered
+    void SetForegroundListener(ForegroundListener listener) { m_foregroundListener = listener; }
+
+    // Virtual clock
+    TimerId AddTimer(Clock::duration delay, std::function<void()> fn);
+    bool CancelTimer(TimerId id);
+    void Advance(Clock::duration duration);  // Runs everything due within it, in order
+    bool RunNext();  // Jumps to the next scheduled item and runs it; false if nothing is scheduled
+    size_t GetPendingCount() const { return m_queue.size(); }
+
+    uint64_t GetCallCount() const { return m_calls; }  // WindowSystem and DisplaySystem calls so far
+
+    // WindowSystem
+    Clock::time_point Now() override { return m_now; }
+    bool IsWindow(WindowKey window) override;
+    uint32_t GetWindowState(WindowKey window, uint32_t mask) override;
+    bool GetWindowRect(WindowKey window, MonitorRect* rect) override;
+    bool IsToolWindow(WindowKey window) override;
+    bool IsHung(WindowKey window) override;
+    uint32_t GetWindowThread(WindowKey window, uint32_t* processId) override;
+    WindowKey GetForeground() override;
+    void EnumerateWindows(std::vector<WindowKey>* windows) override;
+    size_t GetWindowTitle(WindowKey window, int timeoutMs, wchar_t* buffer, size_t capacity) override;
+    bool SetForeground(WindowKey window) override;
+    bool AttachInput(uint32_t fromThread, uint32_t toThread, bool attach) override;
+    void SetFocus(WindowKey window) override;
+    void BringToTop(WindowKey window) override;
+
+    // DisplaySystem
+    void GetMonitors(MonitorLayout* layout) override;
+    int GetWindowMonitor(WindowKey window) override;
+
+    // DesktopProvider
+    DesktopId GetCurrentDesktop() override;
+    DesktopId GetWindowDesktop(WindowKey window, DesktopId current) override;
+
+private:
+    typedef std::pair<Clock::time_point, TimerId> QueueKey;  // Due time, then order of scheduling
+
+    Clock::time_point m_now;
+    std::map<QueueKey, std::function<void()>> m_queue;
+    std::unordered_map<TimerId, Clock::time_point> m_timerDue;  // Pending timers only
+    TimerId m_nextTimer;
+
+    std::unordered_map<WindowKey, SimWindowSpec> m_windows;
+    std::vector<WindowKey> m_zOrder;  // Topmost first
+    WindowKey m_nextKey;
+    uint32_t m_nextThread;
+    WindowKey m_foreground;
+    DesktopId m_currentDesktop;
+    std::vector<std::pair<uint32_t, uint32_t>> m_attached;  // Input-attached thread pairs
+
+    MonitorLayout m_layout;
+    ForegroundListener m_foregroundListener;
+    uint64_t m_calls;
+
+    const SimWindowSpec* Find(WindowKey window) const;
+    void Raise(WindowKey window);
+    bool Activate(WindowKey window);  // Foreground now, event after the window's latency
+    bool IsAttached(uint32_t a, uint32_t b) const;
+    void RunDue(Clock::time_point until);
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free single-producer/single-consumer ring.
+//
+// The producer and consumer each keep a private copy of the other side's
+// index and only re-read the shared one when the cached value says the ring
+// is full (or empty), so the common case touches no shared cache line.
+// A push onto a full ring fails and is counted instead of blocking.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue()
+        : m_head(0)
+        , m_cachedTail(0)
+        , m_tail(0)
+        , m_cachedHead(0)
+        , m_dropped(0) {
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool TryPush(const T& item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if (tail - m_cachedHead >= Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead >= Capacity) {
+                m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: pop up to maxCount items, returns the number popped
+    size_t PopBatch(T* out, size_t maxCount) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (m_cachedTail == head) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (m_cachedTail == head) {
+                return 0;
+            }
+        }
+
+        size_t count = m_cachedTail - head;
+        if (count > maxCount) {
+            count = maxCount;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = m_items[(head + i) & (Capacity - 1)];
+        }
+
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Safe from either side; exact only on the consumer
+    bool IsEmpty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    // Number of pushes rejected because the ring was full
+    uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    static constexpr size_t GetCapacity() { return Capacity; }
+
+private:
+    // Consumer-owned line
+    alignas(64) std::atomic<size_t> m_head;
+    size_t m_cachedTail;
+
+    // Producer-owned line
+    alignas(64) std::atomic<size_t> m_tail;
+    size_t m_cachedHead;
+    std::atomic<uint64_t> m_dropped;
+
+    alignas(64) T m_items[Capacity];
+};
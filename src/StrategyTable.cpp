@@ -0,0 +1,247 @@
+#include "StrategyTable.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include "Hash.h"
+
+static_assert(sizeof(StrategyRecord) == 56, "StrategyRecord is stored in true-recall.strategies");
+
+// A strategy needs this much (decayed) success before it may go first
+static const float MIN_SUCCESSES = 1.5f;
+
+// Weight of the newest latency in the moving average
+static const float LATENCY_ALPHA = 0.25f;
+
+static const char STRATEGY_MAGIC[8] = { 'T', 'R', 'S', 'T', 'R', 'A', '1', '\0' };
+
+struct StrategyFileHeader {
+    char magic[8];
+    uint32_t slotSize;
+    uint32_t reserved;
+};
+
+struct StrategySlot {
+    uint64_t sequence;  // 0 = never written
+    uint32_t count;
+    uint32_t checksum;  // Over sequence, count and the used records
+    StrategyRecord records[StrategyTable::MAX_APPS];
+};
+
+static const size_t STRATEGY_FILE_SIZE = sizeof(StrategyFileHeader) + 2 * sizeof(StrategySlot);
+
+static uint32_t ComputeChecksum(const StrategySlot& slot, uint64_t sequence) {
+    uint32_t hash = HashFnv32(&sequence, sizeof(sequence));
+    hash = HashFnv32(&slot.count, sizeof(slot.count), hash);
+    return HashFnv32(slot.records, slot.count * sizeof(StrategyRecord), hash);
+}
+
+static bool IsSlotValid(const StrategySlot& slot) {
+    return slot.sequence != 0 && slot.count <= static_cast<uint32_t>(StrategyTable::MAX_APPS) &&
+           slot.checksum == ComputeChecksum(slot, slot.sequence);
+}
+
+StrategyTable::StrategyTable()
+    : m_dirty(false) {
+}
+
+uint64_t StrategyTable::MakeAppKey(uint64_t processHash, uint32_t classHash) {
+    return HashFnv64(&classHash, sizeof(classHash), processHash);
+}
+
+bool StrategyTable::Open(const std::string& path) {
+    Close();
+
+    if (!m_file.OpenReadWrite(path, STRATEGY_FILE_SIZE)) {
+        return false;
+    }
+
+    // New file, or one from an incompatible build: start over
+    StrategyFileHeader* header = reinterpret_cast<StrategyFileHeader*>(m_file.GetData());
+    if (std::memcmp(header->magic, STRATEGY_MAGIC, sizeof(STRATEGY_MAGIC)) != 0 ||
+        header->slotSize != sizeof(StrategySlot)) {
+        std::memset(m_file.GetData(), 0, STRATEGY_FILE_SIZE);
+        std::memcpy(header->magic, STRATEGY_MAGIC, sizeof(STRATEGY_MAGIC));
+        header->slotSize = sizeof(StrategySlot);
+        return true;
+    }
+
+    const StrategySlot* slots = reinterpret_cast<const StrategySlot*>(m_file.GetData() + sizeof(StrategyFileHeader));
+    const StrategySlot* best = nullptr;
+    for (int i = 0; i < 2; ++i) {
+        if (IsSlotValid(slots[i]) && (best == nullptr || slots[i].sequence > best->sequence)) {
+            best = &slots[i];
+        }
+    }
+
+    m_records.clear();
+    if (best != nullptr) {
+        for (uint32_t i = 0; i < best->count; ++i) {
+            m_records[best->records[i].appKey] = best->records[i];
+        }
+    }
+    m_dirty = false;
+    return true;
+}
+
+void StrategyTable::Close() {
+    m_file.Close();
+}
+
+bool StrategyTable::Save() {
+    if (!m_file.IsOpen()) {
+        return false;
+    }
+    if (!m_dirty) {
+        return true;
+    }
+
+    StrategySlot* slots = reinterpret_cast<StrategySlot*>(m_file.GetData() + sizeof(StrategyFileHeader));
+
+    // Overwrite the older (or broken) slot, never the newest valid one
+    bool valid0 = IsSlotValid(slots[0]);
+    bool valid1 = IsSlotValid(slots[1]);
+    uint64_t newest = 0;
+    int target = 0;
+    if (valid0 && valid1) {
+        target = slots[0].sequence < slots[1].sequence ? 0 : 1;
+        newest = slots[1 - target].sequence;
+    } else if (valid0) {
+        target = 1;
+        newest = slots[0].sequence;
+    } else if (valid1) {
+        newest = slots[1].sequence;
+    }
+
+    StrategySlot& slot = slots[target];
+
+    // Invalidate first, fill, then publish the sequence
+    slot.sequence = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint32_t count = 0;
+    for (const auto& entry : m_records) {
+        slot.records[count++] = entry.second;  // MAX_APPS is enforced on insert
+    }
+    slot.count = count;
+    slot.checksum = ComputeChecksum(slot, newest + 1);
+
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sequence = newest + 1;
+
+    m_dirty = false;
+    return true;
+}
+
+float StrategyTable::GetDecay(const StrategyRecord& record, uint64_t now) {
+    if (now <= record.updatedAt) {
+        return 1.0f;  // Clock went back: keep what we have
+    }
+    double age = static_cast<double>(now - record.updatedAt);
+    return static_cast<float>(std::exp2(-age / DECAY_HALF_LIFE_S));
+}
+
+int StrategyTable::ChooseFirst(const StrategyRecord& record, uint64_t now) {
+    float decay = GetDecay(record, now);
+    int best = -1;
+
+    // Fastest strategy that succeeds at least as often as it fails
+    for (int strategy = 0; strategy < STRATEGY_COUNT; ++strategy) {
+        float successes = record.successes[strategy] * decay;
+        float failures = record.failures[strategy] * decay;
+        if (successes < MIN_SUCCESSES || successes < failures) {
+            continue;
+        }
+        if (best < 0 || record.latencyUs[strategy] < record.latencyUs[best]) {
+            best = strategy;
+        }
+    }
+
+    return best < 0 ? 0 : best;
+}
+
+ActivationStrategy StrategyTable::GetPreferred(uint64_t appKey, uint64_t now) const {
+    std::unordered_map<uint64_t, StrategyRecord>::const_iterator found = m_records.find(appKey);
+    return found != m_records.end() ? static_cast<ActivationStrategy>(ChooseFirst(found->second, now))
+                                    : ActivationStrategy::Direct;
+}
+
+void StrategyTable::GetOrder(uint64_t appKey, uint64_t now, ActivationStrategy order[STRATEGY_COUNT]) {
+    int first = 0;
+
+    std::unordered_map<uint64_t, StrategyRecord>::iterator found = m_records.find(appKey);
+    if (found != m_records.end()) {
+        StrategyRecord& record = found->second;
+        if (++record.choices % EXPLORE_EVERY != 0) {
+            first = ChooseFirst(record, now);
+        }
+    }
+
+    // Learned strategy first, then the rest in their usual escalation order
+    order[0] = static_cast<ActivationStrategy>(first);
+    int next = 1;
+    for (int strategy = 0; strategy < STRATEGY_COUNT; ++strategy) {
+        if (strategy != first) {
+            order[next++] = static_cast<ActivationStrategy>(strategy);
+        }
+    }
+}
+
+void StrategyTable::Record(uint64_t appKey, ActivationStrategy strategy, bool success, double latencyUs,
+                           uint64_t now) {
+    int index = static_cast<int>(strategy);
+    if (index < 0 || index >= STRATEGY_COUNT) {
+        return;
+    }
+
+    std::unordered_map<uint64_t, StrategyRecord>::iterator found = m_records.find(appKey);
+    if (found == m_records.end()) {
+        if (m_records.size() >= static_cast<size_t>(MAX_APPS)) {
+            EvictStalest();
+        }
+        StrategyRecord record = {};
+        record.appKey = appKey;
+        record.updatedAt = now;
+        found = m_records.emplace(appKey, record).first;
+    }
+
+    // Bring every weight up to now, then add the observation
+    StrategyRecord& record = found->second;
+    float decay = GetDecay(record, now);
+    for (int i = 0; i < STRATEGY_COUNT; ++i) {
+        record.successes[i] *= decay;
+        record.failures[i] *= decay;
+    }
+    record.updatedAt = now > record.updatedAt ? now : record.updatedAt;
+
+    if (success) {
+        float latency = static_cast<float>(latencyUs);
+        record.latencyUs[index] = record.successes[index] > 0.0f
+                                      ? record.latencyUs[index] + LATENCY_ALPHA * (latency - record.latencyUs[index])
+                                      : latency;
+        record.successes[index] += 1.0f;
+    } else {
+        record.failures[index] += 1.0f;
+    }
+
+    // Capped, so a long history cannot outvote what the app does today
+    float total = record.successes[index] + record.failures[index];
+    if (total > MAX_WEIGHT) {
+        float scale = MAX_WEIGHT / total;
+        record.successes[index] *= scale;
+        record.failures[index] *= scale;
+    }
+
+    m_dirty = true;
+}
+
+void StrategyTable::EvictStalest() {
+    std::unordered_map<uint64_t, StrategyRecord>::iterator stalest = m_records.begin();
+    for (std::unordered_map<uint64_t, StrategyRecord>::iterator it = m_records.begin(); it != m_records.end(); ++it) {
+        if (it->second.updatedAt < stalest->second.updatedAt) {
+            stalest = it;
+        }
+    }
+    if (stalest != m_records.end()) {
+        m_records.erase(stalest);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "ActivationStats.h"
+#include "MappedFile.h"
+
+static const int STRATEGY_COUNT = static_cast<int>(ActivationStrategy::Count);
+
+// What each activation strategy achieved for one application
+struct StrategyRecord {
+    uint64_t appKey;
+    uint64_t updatedAt;  // Seconds since the Unix epoch; the weights below are as of then
+    float successes[STRATEGY_COUNT];  // Decaying counts
+    float failures[STRATEGY_COUNT];
+    float latencyUs[STRATEGY_COUNT];  // Moving average over successes
+    uint32_t choices;  // Orders handed out, for exploration
+};
+
+// Learned activation strategy per application, so a press starts with the
+// strategy that has worked fastest for that app instead of paying for the
+// ones that always fail there.
+//
+// Keyed by process image and window class. Weights halve every
+// DECAY_HALF_LIFE_S and are capped at MAX_WEIGHT, so an app that changed
+// behaviour is relearned within a few presses. Every EXPLORE_EVERY-th order
+// for an app is the default one, so a strategy that started working again
+// is noticed. Unknown apps get the default order.
+//
+// Persisted in a small memory-mapped file with two checksummed slots, like
+// the focus snapshot. Activation worker only, not thread-safe.
+class StrategyTable {
+public:
+    static const int MAX_APPS = 256;  // Least recently updated app is forgotten first
+    static const int DECAY_HALF_LIFE_S = 3 * 24 * 3600;
+    static const int MAX_WEIGHT = 8;  // Per strategy, successes + failures
+    static const int EXPLORE_EVERY = 16;
+
+    StrategyTable();
+
+    static uint64_t MakeAppKey(uint64_t processHash, uint32_t classHash);
+
+    bool Open(const std::string& path);  // Creates the file if missing, otherwise loads it
+    void Close();
+    bool Save();  // Only writes if something was recorded since the last save
+    bool IsDirty() const { return m_dirty; }
+
+    // All strategies in the order to try them
+    void GetOrder(uint64_t appKey, uint64_t now, ActivationStrategy order[STRATEGY_COUNT]);
+    ActivationStrategy GetPreferred(uint64_t appKey, uint64_t now) const;  // First of a non-exploring order
+
+    // latencyUs: strategy issued -> foreground event, successes only
+    void Record(uint64_t appKey, ActivationStrategy strategy, bool success, double latencyUs, uint64_t now);
+
+    size_t GetSize() const { return m_records.size(); }
+
+private:
+    std::unordered_map<uint64_t, StrategyRecord> m_records;
+    MappedFile m_file;
+    bool m_dirty;
+
+    static int ChooseFirst(const StrategyRecord& record, uint64_t now);
+    static float GetDecay(const StrategyRecord& record, uint64_t now);
+    void EvictStalest();
+};
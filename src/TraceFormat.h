@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include "MonitorLayout.h"
+
+// On-disk format of a focus event trace (native byte order).
+//
+// A fixed header, then fixed-size records back to back. The header's record
+// count is updated after every append, and readers also clamp it to the file
+// size, so a trace cut short by a crash is still readable.
+
+static const char TRACE_MAGIC[8] = { 'T', 'R', 'T', 'R', 'A', 'C', 'E', '\0' };
+static const uint32_t TRACE_VERSION = 1;
+static const int TRACE_MAX_MONITORS = 32;
+
+enum class TraceEventType : uint16_t {
+    Focus = 1,    // EVENT_SYSTEM_FOREGROUND
+    Destroy = 2,  // EVENT_OBJECT_DESTROY, tracked or not
+    Move = 3,     // Tracked window migrated to another monitor's stack
+};
+
+// TraceRecord::flags
+static const uint32_t TRACE_FLAG_VISIBLE = 1u << 0;
+static const uint32_t TRACE_FLAG_MINIMIZED = 1u << 1;
+static const uint32_t TRACE_FLAG_TRACKED = 1u << 2;  // Window was in a focus stack when the event arrived
+static const uint32_t TRACE_FLAG_FOREGROUND = 1u << 3;  // Move: window was foreground, placed on top
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t maxMonitors;         // FocusStackEngine shape of the recording process
+    uint32_t perMonitorCapacity;
+    uint64_t recordCount;
+    int64_t startWallClockMs;     // Unix epoch
+    uint32_t monitorCount;        // Layout when recording started
+    uint32_t primaryMonitor;
+    MonitorRect monitors[TRACE_MAX_MONITORS];
+};
+
+struct TraceRecord {
+    uint64_t timestampNs;  // Since the trace was opened
+    uint64_t window;       // HWND value
+    MonitorRect rect;      // Window rect at event time, zero when not captured
+    uint32_t processId;    // 0 when not captured
+    uint32_t classHash;    // HashFnv32 of the window class name, 0 when not captured
+    uint16_t type;         // TraceEventType
+    int16_t monitor;       // Resolved monitor index, -1 if none
+    uint32_t flags;        // TRACE_FLAG_*
+};
+
+static_assert(sizeof(TraceHeader) % 8 == 0, "records after the header must stay 8-byte aligned");
+static_assert(sizeof(TraceRecord) == 48, "TraceRecord layout is part of the file format");
@@ -0,0 +1,69 @@
+#include "TraceReader.h"
+#include <cstring>
+
+TraceReader::TraceReader()
+    : m_recordCount(0)
+    , m_error("") {
+}
+
+bool TraceReader::Open(const std::string& path) {
+    Close();
+
+    if (!m_file.OpenRead(path)) {
+        m_error = "cannot open file";
+        return false;
+    }
+
+    if (m_file.GetSize() < sizeof(TraceHeader)) {
+        m_error = "file too small for a trace header";
+        Close();
+        return false;
+    }
+
+    const TraceHeader& header = GetHeader();
+    if (std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        m_error = "not a trace file";
+        Close();
+        return false;
+    }
+
+    if (header.version != TRACE_VERSION || header.recordSize != sizeof(TraceRecord)) {
+        m_error = "unsupported trace version";
+        Close();
+        return false;
+    }
+
+    if (header.maxMonitors == 0 || header.maxMonitors > 1024 ||
+        header.perMonitorCapacity == 0 || header.perMonitorCapacity > 65536) {
+        m_error = "corrupt focus stack shape";
+        Close();
+        return false;
+    }
+
+    if (header.monitorCount > static_cast<uint32_t>(TRACE_MAX_MONITORS)) {
+        m_error = "corrupt monitor table";
+        Close();
+        return false;
+    }
+
+    // Trust the file size over the header if the writer never closed
+    uint64_t available = (m_file.GetSize() - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    m_recordCount = header.recordCount < available ? header.recordCount : available;
+    m_error = "";
+    return true;
+}
+
+void TraceReader::Close() {
+    m_file.Close();
+    m_recordCount = 0;
+}
+
+void TraceReader::GetLayout(MonitorLayout* layout) const {
+    layout->Clear();
+
+    const TraceHeader& header = GetHeader();
+    for (uint32_t i = 0; i < header.monitorCount; ++i) {
+        // Work areas are not recorded; geometry lookups only use the bounds
+        layout->Add(header.monitors[i], header.monitors[i], i == header.primaryMonitor);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include "MappedFile.h"
+#include "TraceFormat.h"
+
+// Read-only view of a trace file. Records are read straight from the mapping.
+class TraceReader {
+public:
+    TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    bool Open(const std::string& path);  // On failure GetError() says why
+    void Close();
+
+    const char* GetError() const { return m_error; }
+
+    const TraceHeader& GetHeader() const { return *reinterpret_cast<const TraceHeader*>(m_file.GetData()); }
+    uint64_t GetRecordCount() const { return m_recordCount; }
+    const TraceRecord* GetRecords() const {
+        return reinterpret_cast<const TraceRecord*>(m_file.GetData() + sizeof(TraceHeader));
+    }
+
+    // Rebuild the monitor layout stored in the header
+    void GetLayout(MonitorLayout* layout) const;
+
+private:
+    MappedFile m_file;
+    uint64_t m_recordCount;
+    const char* m_error;
+};
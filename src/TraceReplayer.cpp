@@ -0,0 +1,85 @@
+#include "TraceReplayer.h"
+#include <chrono>
+#include <thread>
+#include "Hash.h"
+
+TraceReplayer::TraceReplayer(const TraceReader& reader)
+    : m_reader(reader)
+    , m_engine(static_cast<int>(reader.GetHeader().maxMonitors), reader.GetHeader().perMonitorCapacity) {
+    reader.GetLayout(&m_layout);
+}
+
+ReplayResult TraceReplayer::Run(bool realTime, double speed) {
+    ReplayResult result = {};
+    m_engine.Clear();
+
+    const TraceRecord* records = m_reader.GetRecords();
+    const uint64_t count = m_reader.GetRecordCount();
+    const bool checkMonitors = m_layout.GetCount() > 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < count; ++i) {
+        const TraceRecord& record = records[i];
+
+        if (realTime && speed > 0.0) {
+            std::chrono::nanoseconds offset(static_cast<int64_t>(static_cast<double>(record.timestampNs) / speed));
+            std::this_thread::sleep_until(start + offset);
+        }
+
+        switch (static_cast<TraceEventType>(record.type)) {
+            case TraceEventType::Focus: {
+                ++result.focusEvents;
+                if (record.monitor < 0 || !m_engine.Promote(record.window, record.monitor)) {
+                    ++result.skippedEvents;
+                    break;
+                }
+
+                // Same rule as the live lookup; off-screen rects were resolved by Windows, skip them
+                if (checkMonitors) {
+                    int resolved = m_layout.FindLargestOverlap(record.rect);
+                    if (resolved >= 0 && resolved != record.monitor) {
+                        ++result.monitorMismatches;
+                    }
+                }
+                break;
+            }
+            case TraceEventType::Destroy:
+                ++result.destroyEvents;
+                if (m_engine.Contains(record.window)) {
+                    m_engine.Remove(record.window);
+                }
+                break;
+            case TraceEventType::Move:
+                ++result.moveEvents;
+                if (record.monitor < 0 ||
+                    !m_engine.MoveToMonitor(record.window, record.monitor, (record.flags & TRACE_FLAG_FOREGROUND) != 0)) {
+                    ++result.skippedEvents;
+                }
+                break;
+            default:
+                ++result.skippedEvents;
+                break;
+        }
+    }
+
+    result.elapsedNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    result.stackDigest = ComputeDigest();
+    return result;
+}
+
+uint64_t TraceReplayer::ComputeDigest() const {
+    // Chained over (monitor, position, window) for every stack entry
+    uint64_t hash = HashFnv64(nullptr, 0);
+
+    for (int monitor = 0; monitor < m_engine.GetMaxMonitors(); ++monitor) {
+        uint64_t position = 0;
+        m_engine.ForEachInStack(monitor, [&](WindowKey window) {
+            uint64_t values[3] = { static_cast<uint64_t>(monitor), position++, static_cast<uint64_t>(window) };
+            hash = HashFnv64(values, sizeof(values), hash);
+        });
+    }
+
+    return hash;
+}
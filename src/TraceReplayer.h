@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include "FocusStackEngine.h"
+#include "MonitorLayout.h"
+#include "TraceReader.h"
+
+struct ReplayResult {
+    uint64_t focusEvents;
+    uint64_t destroyEvents;      // Including ones for untracked windows
+    uint64_t moveEvents;
+    uint64_t skippedEvents;      // No monitor, or a monitor the engine cannot hold
+    uint64_t monitorMismatches;  // Recorded monitor differs from re-resolving the rect now
+    uint64_t elapsedNs;
+    uint64_t stackDigest;        // Hash of every final stack, order included
+};
+
+// Drives a FocusStackEngine from a trace exactly as the focus worker does
+// (focus -> promote on the recorded monitor, destroy -> remove, move ->
+// migrate to the recorded monitor), with no
+// platform calls. Same trace, same final stacks and digest on every run.
+class TraceReplayer {
+public:
+    explicit TraceReplayer(const TraceReader& reader);
+
+    // realTime: sleep to reproduce the recorded gaps, scaled by 1/speed.
+    // Otherwise replay as fast as possible.
+    ReplayResult Run(bool realTime, double speed = 1.0);
+
+    const FocusStackEngine& GetEngine() const { return m_engine; }
+    const MonitorLayout& GetLayout() const { return m_layout; }
+
+private:
+    const TraceReader& m_reader;
+    FocusStackEngine m_engine;
+    MonitorLayout m_layout;
+
+    uint64_t ComputeDigest() const;
+};
@@ -0,0 +1,81 @@
+#include "TraceWriter.h"
+#include <cstring>
+
+TraceWriter::TraceWriter()
+    : m_recordCount(0)
+    , m_capacity(0) {
+}
+
+TraceWriter::~TraceWriter() {
+    Close();
+}
+
+bool TraceWriter::Open(const std::string& path, const MonitorLayout& layout, int maxMonitors, size_t perMonitorCapacity) {
+    Close();
+
+    // Start from an empty file so stale records from a longer trace never survive
+    if (!m_file.OpenReadWrite(path, 0) || !m_file.Resize(GROW_BYTES)) {
+        m_file.Close();
+        return false;
+    }
+
+    TraceHeader* header = GetHeader();
+    std::memset(header, 0, sizeof(TraceHeader));
+    std::memcpy(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header->version = TRACE_VERSION;
+    header->recordSize = sizeof(TraceRecord);
+    header->maxMonitors = static_cast<uint32_t>(maxMonitors);
+    header->perMonitorCapacity = static_cast<uint32_t>(perMonitorCapacity);
+    header->startWallClockMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    int monitorCount = layout.GetCount() < TRACE_MAX_MONITORS ? layout.GetCount() : TRACE_MAX_MONITORS;
+    header->monitorCount = static_cast<uint32_t>(monitorCount);
+    for (int i = 0; i < monitorCount; ++i) {
+        header->monitors[i] = layout.Get(i).bounds;
+        if (layout.Get(i).primary) {
+            header->primaryMonitor = static_cast<uint32_t>(i);
+        }
+    }
+
+    m_recordCount = 0;
+    m_capacity = (m_file.GetSize() - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    m_start = std::chrono::steady_clock::now();
+    return true;
+}
+
+void TraceWriter::Close() {
+    if (!m_file.IsOpen()) {
+        return;
+    }
+
+    // Drop the preallocated tail
+    m_file.Resize(sizeof(TraceHeader) + m_recordCount * sizeof(TraceRecord));
+    m_file.Close();
+    m_capacity = 0;
+}
+
+bool TraceWriter::Append(TraceRecord record) {
+    if (!m_file.IsOpen()) {
+        return false;
+    }
+
+    if (m_recordCount == m_capacity) {
+        if (!m_file.Resize(m_file.GetSize() + GROW_BYTES)) {
+            Close();
+            return false;
+        }
+        m_capacity = (m_file.GetSize() - sizeof(TraceHeader)) / sizeof(TraceRecord);
+    }
+
+    record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start).count());
+
+    TraceRecord* records = reinterpret_cast<TraceRecord*>(m_file.GetData() + sizeof(TraceHeader));
+    records[m_recordCount] = record;
+
+    // Publish after the record so a crash never counts a half-written one
+    ++m_recordCount;
+    GetHeader()->recordCount = m_recordCount;
+    return true;
+}
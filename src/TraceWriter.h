@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include "MappedFile.h"
+#include "TraceFormat.h"
+
+// Appends TraceRecords to a memory-mapped trace file.
+//
+// An append is a copy into the mapping plus a header counter store; the file
+// grows in GROW_BYTES steps so remapping is rare. Close() trims the unused
+// tail. Single writer; not thread-safe.
+class TraceWriter {
+public:
+    static const size_t GROW_BYTES = 4 * 1024 * 1024;
+
+    TraceWriter();
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // Truncates any existing file at `path`
+    bool Open(const std::string& path, const MonitorLayout& layout, int maxMonitors, size_t perMonitorCapacity);
+    void Close();
+
+    bool IsOpen() const { return m_file.IsOpen(); }
+    uint64_t GetRecordCount() const { return m_recordCount; }
+
+    // Stamps timestampNs; returns false (and closes the trace) if the file cannot grow
+    bool Append(TraceRecord record);
+
+private:
+    MappedFile m_file;
+    uint64_t m_recordCount;
+    size_t m_capacity;  // Records that fit in the current mapping
+    std::chrono::steady_clock::time_point m_start;
+
+    TraceHeader* GetHeader() { return reinterpret_cast<TraceHeader*>(m_file.GetData()); }
+};
@@ -1,5 +1,5 @@
 #include "TrayIcon.h"
-#include <iostream>
+#include "Logger.h"
 
 static TrayIcon* g_trayIcon = nullptr;
 
@@ -33,12 +33,12 @@ bool TrayIcon::Create(HWND hwnd) {
     
     // Add icon to system tray
     if (!Shell_NotifyIcon(NIM_ADD, &m_nid)) {
-        std::cerr << "Failed to create tray icon" << std::endl;
+        TR_LOG_ERROR("Failed to create tray icon");
         return false;
     }
     
     m_created = true;
-    std::cout << "System tray icon created" << std::endl;
+    TR_LOG_INFO("System tray icon created");
     return true;
 }
 
@@ -56,6 +56,7 @@ void TrayIcon::HandleContextMenu(HWND hwnd) {
     HMENU hMenu = CreatePopupMenu();
     if (hMenu) {
         InsertMenu(hMenu, -1, MF_BYPOSITION | MF_STRING, ID_TRAY_ABOUT, TEXT("About"));
+        InsertMenu(hMenu, -1, MF_BYPOSITION | MF_STRING, ID_TRAY_STATS, TEXT("Latency Stats"));
         InsertMenu(hMenu, -1, MF_BYPOSITION | MF_SEPARATOR, 0, NULL);
         InsertMenu(hMenu, -1, MF_BYPOSITION | MF_STRING, ID_TRAY_EXIT, TEXT("Exit"));
         
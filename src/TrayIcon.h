@@ -6,6 +6,7 @@
 #define WM_TRAYICON (WM_USER + 1)
 #define ID_TRAY_EXIT 1001
 #define ID_TRAY_ABOUT 1002
+#define ID_TRAY_STATS 1003  // Handled by the owner window
 
 class TrayIcon {
 public:
@@ -0,0 +1,54 @@
+#include "WindowCandidate.h"
+
+bool IsFallbackCandidate(const WindowCandidate& candidate, const MonitorLayout& layout, int monitorIndex) {
+    if (!candidate.visible || candidate.minimized || candidate.cloaked || !candidate.hasTitle) {
+        return false;
+    }
+
+    // Same rule as MonitorFromWindow(MONITOR_DEFAULTTONEAREST), on cached geometry
+    return layout.FromRect(candidate.rect) == monitorIndex;
+}
+
+WindowKey FindFallbackWindow(const WindowCandidate* candidates, size_t count, const MonitorLayout& layout, int monitorIndex) {
+    for (size_t i = 0; i < count; ++i) {
+        if (IsFallbackCandidate(candidates[i], layout, monitorIndex)) {
+            return candidates[i].window;
+        }
+    }
+    return 0;
+}
+
+size_t BucketByZOrder(const WindowCandidate* candidates, size_t count, const MonitorLayout& layout,
+                      size_t maxPerMonitor, std::vector<std::vector<WindowKey>>* stacks) {
+    // Clear rather than reassign so a reused vector keeps its buffers
+    stacks->resize(layout.GetCount());
+    for (std::vector<WindowKey>& stack : *stacks) {
+        stack.clear();
+    }
+
+    size_t kept = 0;
+    size_t full = 0;
+    for (size_t i = 0; i < count && full < stacks->size(); ++i) {
+        const WindowCandidate& candidate = candidates[i];
+        if (!candidate.visible || candidate.minimized || candidate.cloaked || !candidate.hasTitle ||
+            candidate.toolWindow) {
+            continue;
+        }
+
+        int monitorIndex = layout.FromRect(candidate.rect);
+        if (monitorIndex < 0) {
+            continue;
+        }
+
+        std::vector<WindowKey>& stack = (*stacks)[monitorIndex];
+        if (stack.size() < maxPerMonitor) {
+            stack.push_back(candidate.window);
+            ++kept;
+            if (stack.size() == maxPerMonitor) {
+                ++full;  // Every stack full: the rest of the z-order cannot matter
+            }
+        }
+    }
+
+    return kept;
+}
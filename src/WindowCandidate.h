@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "FocusStackEngine.h"
+#include "MonitorLayout.h"
+
+// What the fallback search knows about a top-level window
+struct WindowCandidate {
+    WindowKey window;
+    MonitorRect rect;
+    bool visible;
+    bool minimized;
+    bool hasTitle;  // Untitled windows are mostly tool/system windows
+    bool toolWindow;  // Owned or WS_EX_TOOLWINDOW; not filled in by the fallback search
+    bool cloaked;  // DWM-hidden (other virtual desktop); only queried if everything else qualifies
+};
+
+// Rule used when a monitor's focus stack is exhausted: a visible, restored,
+// uncloaked, titled window whose rect lies mostly on the monitor (nearest if
+// off-screen)
+bool IsFallbackCandidate(const WindowCandidate& candidate, const MonitorLayout& layout, int monitorIndex);
+
+// First matching window in z-order (candidates[0] is topmost); 0 if none
+WindowKey FindFallbackWindow(const WindowCandidate* candidates, size_t count, const MonitorLayout& layout, int monitorIndex);
+
+// Startup inventory: fallback-eligible, non-tool windows bucketed per monitor
+// in z-order (topmost first, a fair stand-in for most recently used), at most
+// maxPerMonitor each. Resizes stacks to the monitor count; returns windows kept.
+size_t BucketByZOrder(const WindowCandidate* candidates, size_t count, const MonitorLayout& layout,
+                      size_t maxPerMonitor, std::vector<std::vector<WindowKey>>* stacks);
@@ -0,0 +1,197 @@
+#include "WindowRegistry.h"
+
+static const uint32_t MAX_GENERATION = 0xFFFFu;
+
+WindowRegistry::WindowRegistry(size_t capacity)
+    : m_capacity(capacity < 1 ? 1 : (capacity > MAX_CAPACITY ? MAX_CAPACITY : capacity))
+    , m_indexMask(0)
+    , m_indexShift(64)
+    , m_count(0)
+    , m_freeHead(NIL)
+{
+    m_slots.reset(new Slot[m_capacity]);
+    for (size_t i = 0; i < m_capacity; ++i) {
+        m_slots[i].generation = 0;  // First handle of every slot has generation 1
+    }
+
+    // Keep the index at most half full so probe chains stay short
+    size_t indexSize = 2;
+    unsigned bits = 1;
+    while (indexSize < m_capacity * 2) {
+        indexSize <<= 1;
+        ++bits;
+    }
+    m_index.resize(indexSize);
+    m_indexMask = indexSize - 1;
+    m_indexShift = 64 - bits;
+
+    Clear();
+}
+
+void WindowRegistry::Clear() {
+    for (IndexEntry& entry : m_index) {
+        entry.window = 0;
+        entry.slot = NIL;
+    }
+
+    // Generations are kept, so handles from before stay dead
+    for (size_t i = 0; i < m_capacity; ++i) {
+        m_slots[i].handle.store(0, std::memory_order_release);
+        m_slots[i].window.store(0, std::memory_order_release);
+        m_slots[i].state.store(0, std::memory_order_relaxed);
+        m_slots[i].nextFree = (i + 1 < m_capacity) ? static_cast<uint32_t>(i + 1) : NIL;
+    }
+    m_freeHead = 0;
+    m_count = 0;
+}
+
+size_t WindowRegistry::HomeBucket(WindowKey window) const {
+    // Fibonacci hashing: HWND values are aligned and clustered, so mix before masking
+    uint64_t h = static_cast<uint64_t>(window) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(h >> m_indexShift) & m_indexMask;
+}
+
+size_t WindowRegistry::FindBucket(WindowKey window) const {
+    size_t bucket = HomeBucket(window);
+    while (m_index[bucket].window != 0 && m_index[bucket].window != window) {
+        bucket = (bucket + 1) & m_indexMask;
+    }
+    return bucket;
+}
+
+void WindowRegistry::IndexErase(size_t bucket) {
+    // Backward-shift deletion keeps linear probing tombstone-free
+    size_t hole = bucket;
+    size_t next = (hole + 1) & m_indexMask;
+
+    while (m_index[next].window != 0) {
+        size_t home = HomeBucket(m_index[next].window);
+
+        // Move the entry into the hole unless its home lies cyclically in (hole, next]
+        bool homeBetween = (hole <= next) ? (home > hole && home <= next)
+                                          : (home > hole || home <= next);
+        if (!homeBetween) {
+            m_index[hole] = m_index[next];
+            hole = next;
+        }
+        next = (next + 1) & m_indexMask;
+    }
+
+    m_index[hole].window = 0;
+    m_index[hole].slot = NIL;
+}
+
+WindowHandle WindowRegistry::Register(WindowKey window) {
+    if (window == 0) {
+        return 0;
+    }
+
+    size_t bucket = FindBucket(window);
+    if (m_index[bucket].window == window) {
+        return m_slots[m_index[bucket].slot].handle.load(std::memory_order_relaxed);
+    }
+    if (m_freeHead == NIL) {
+        return 0;
+    }
+
+    uint32_t slot = m_freeHead;
+    Slot& s = m_slots[slot];
+    m_freeHead = s.nextFree;
+
+    // Wraps after 65535 reuses of one slot; a handle would have to be held that long
+    s.generation = (s.generation >= MAX_GENERATION) ? 1 : s.generation + 1;
+    WindowHandle handle = (s.generation << SLOT_BITS) | slot;
+
+    // Window first: a reader that sees the handle also sees its window
+    s.window.store(window, std::memory_order_release);
+    s.state.store(0, std::memory_order_release);
+    s.handle.store(handle, std::memory_order_release);
+
+    m_index[bucket].window = window;
+    m_index[bucket].slot = slot;
+    ++m_count;
+    return handle;
+}
+
+WindowHandle WindowRegistry::Unregister(WindowKey window) {
+    if (window == 0) {
+        return 0;
+    }
+
+    size_t bucket = FindBucket(window);
+    if (m_index[bucket].window != window) {
+        return 0;
+    }
+
+    uint32_t slot = m_index[bucket].slot;
+    Slot& s = m_slots[slot];
+    WindowHandle handle = s.handle.load(std::memory_order_relaxed);
+
+    // Handle dies before the slot can be handed out again
+    s.handle.store(0, std::memory_order_release);
+    s.window.store(0, std::memory_order_release);
+
+    IndexErase(bucket);
+    s.nextFree = m_freeHead;
+    m_freeHead = slot;
+    --m_count;
+    return handle;
+}
+
+WindowHandle WindowRegistry::Find(WindowKey window) const {
+    if (window == 0) {
+        return 0;
+    }
+
+    const IndexEntry& entry = m_index[FindBucket(window)];
+    return (entry.window == window) ? m_slots[entry.slot].handle.load(std::memory_order_relaxed) : 0;
+}
+
+bool WindowRegistry::SetState(WindowKey window, uint32_t state) {
+    if (window == 0) {
+        return false;
+    }
+
+    const IndexEntry& entry = m_index[FindBucket(window)];
+    if (entry.window != window) {
+        return false;
+    }
+
+    Slot& s = m_slots[entry.slot];
+    if (s.state.load(std::memory_order_relaxed) == state) {
+        return false;
+    }
+    s.state.store(state, std::memory_order_release);
+    return true;
+}
+
+uint32_t WindowRegistry::GetStateOf(WindowKey window) const {
+    if (window == 0) {
+        return 0;
+    }
+
+    const IndexEntry& entry = m_index[FindBucket(window)];
+    return (entry.window == window) ? m_slots[entry.slot].state.load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t WindowRegistry::GetState(WindowHandle handle) const {
+    if (!IsAlive(handle)) {
+        return 0;
+    }
+
+    // Same re-check as Resolve: the state read may belong to the slot's next occupant
+    const Slot& s = m_slots[GetSlot(handle)];
+    uint32_t state = s.state.load(std::memory_order_acquire);
+    return s.handle.load(std::memory_order_acquire) == handle ? state : 0;
+}
+
+WindowKey WindowRegistry::Resolve(WindowHandle handle) const {
+    if (!IsAlive(handle)) {
+        return 0;
+    }
+
+    // Re-checked: if the slot was reused meanwhile, the window read may be the next occupant's
+    const Slot& s = m_slots[GetSlot(handle)];
+    WindowKey window = s.window.load(std::memory_order_acquire);
+    return s.handle.load(std::memory_order_acquire) == handle ? window : 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Opaque window identity used by the portable core (an HWND value on Windows).
+// Zero is reserved as "no window".
+using WindowKey = std::uintptr_t;
+
+// Compact reference to a registered window: slot index in the low 16 bits,
+// the slot's generation above them. Zero is reserved as "no handle".
+using WindowHandle = uint32_t;
+
+// Window state bits kept per registered window, maintained from window events
+static const uint32_t WINDOW_STATE_VISIBLE = 1u << 0;
+static const uint32_t WINDOW_STATE_MINIMIZED = 1u << 1;
+static const uint32_t WINDOW_STATE_CLOAKED = 1u << 2;  // Hidden by DWM: other virtual desktop, suspended app
+static const uint32_t WINDOW_STATE_ALL = WINDOW_STATE_VISIBLE | WINDOW_STATE_MINIMIZED | WINDOW_STATE_CLOAKED;
+
+// Shown, not minimized, not cloaked: worth an activation attempt
+inline bool IsWindowStateActivatable(uint32_t state) {
+    return (state & WINDOW_STATE_ALL) == WINDOW_STATE_VISIBLE;
+}
+
+// Hands out generation-tagged handles for windows.
+//
+// Windows reuses HWND values, so a bare HWND kept across a destroy event can
+// end up naming an unrelated new window. A handle cannot: unregistering a
+// window bumps its slot's generation, which kills every handle to it, and
+// registering the same HWND value again yields a different handle.
+//
+// Each registered window also carries a word of WINDOW_STATE_* bits, zero
+// until its owner sets them.
+//
+// Register/Unregister/SetState are not thread-safe; callers serialize them.
+// IsAlive, Resolve and GetState are lock-free and may run on any thread at
+// the same time: slots are allocated up front and never move.
+class WindowRegistry {
+public:
+    static const unsigned SLOT_BITS = 16;
+    static const size_t MAX_CAPACITY = (1u << SLOT_BITS) - 1;
+
+    explicit WindowRegistry(size_t capacity);
+
+    WindowHandle Register(WindowKey window);  // The live handle if already registered; 0 if full
+    WindowHandle Unregister(WindowKey window);  // Returns the handle it killed, 0 if not registered
+    void Clear();  // Kills every handle
+
+    WindowHandle Find(WindowKey window) const;  // Single hash probe; 0 if not registered
+    bool SetState(WindowKey window, uint32_t state);  // False if unchanged or not registered
+    uint32_t GetStateOf(WindowKey window) const;  // 0 if not registered
+    size_t GetCount() const { return m_count; }
+    size_t GetCapacity() const { return m_capacity; }
+
+    // Any thread. A handle stays alive until its window is unregistered.
+    bool IsAlive(WindowHandle handle) const {
+        return handle != 0 && GetSlot(handle) < m_capacity &&
+               m_slots[GetSlot(handle)].handle.load(std::memory_order_acquire) == handle;
+    }
+    WindowKey Resolve(WindowHandle handle) const;  // 0 once the handle is dead
+    uint32_t GetState(WindowHandle handle) const;  // 0 once the handle is dead
+
+    static uint32_t GetSlot(WindowHandle handle) { return handle & ((1u << SLOT_BITS) - 1); }
+
+private:
+    static const uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Slot {
+        std::atomic<WindowHandle> handle;  // Live handle, 0 while free
+        std::atomic<WindowKey> window;
+        std::atomic<uint32_t> state;  // WINDOW_STATE_*
+        uint32_t generation;  // Of the current or last occupant
+        uint32_t nextFree;
+    };
+
+    // Index entries carry the key so a probe never touches the slot array
+    struct IndexEntry {
+        WindowKey window;  // 0 = empty bucket
+        uint32_t slot;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::vector<IndexEntry> m_index;
+    size_t m_capacity;
+    size_t m_indexMask;
+    unsigned m_indexShift;
+    size_t m_count;
+    uint32_t m_freeHead;
+
+    size_t HomeBucket(WindowKey window) const;
+    size_t FindBucket(WindowKey window) const;  // Bucket holding window, or the empty bucket ending the probe
+    void IndexErase(size_t bucket);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FocusStackEngine.h"
+#include "MonitorLayout.h"
+
+// The window-system calls behind focus tracking and activation, so that logic
+// runs against the real desktop (Win32WindowSystem) or an in-memory one
+// (SimulatedWindowSystem) alike. Windows are WindowKeys: HWND values on Win32.
+//
+// A window that no longer exists reads as false / 0 everywhere. Backends may
+// be called from several threads unless they say otherwise.
+class WindowSystem {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    virtual ~WindowSystem() {}
+
+    virtual Clock::time_point Now() = 0;  // Time every timestamp of a run is taken from
+
+    // Queries
+    virtual bool IsWindow(WindowKey window) = 0;
+    virtual uint32_t GetWindowState(WindowKey window, uint32_t mask) = 0;  // The WINDOW_STATE_* bits asked for, one query each
+    virtual bool GetWindowRect(WindowKey window, MonitorRect* rect) = 0;  // Minimized windows are parked off-screen
+    virtual bool IsToolWindow(WindowKey window) = 0;  // Owned, or styled not to show in the taskbar
+    virtual bool IsHung(WindowKey window) = 0;  // The system's verdict; never waits on the window
+    virtual uint32_t GetWindowThread(WindowKey window, uint32_t* processId) = 0;  // processId may be null
+    virtual WindowKey GetForeground() = 0;
+    virtual void EnumerateWindows(std::vector<WindowKey>* windows) = 0;  // Top-level, topmost first
+
+    // Up to capacity characters, returns the length. timeoutMs 0: the caption
+    // the system keeps, the owner is never asked; otherwise ask the owner,
+    // waiting at most that long before settling for the system's copy.
+    virtual size_t GetWindowTitle(WindowKey window, int timeoutMs, wchar_t* buffer, size_t capacity) = 0;
+
+    // Activation; the foreground event is the only real confirmation
+    virtual bool SetForeground(WindowKey window) = 0;  // False if refused outright
+    virtual bool AttachInput(uint32_t fromThread, uint32_t toThread, bool attach) = 0;
+    virtual void SetFocus(WindowKey window) = 0;
+    virtual void BringToTop(WindowKey window) = 0;
+};
+
+class DisplaySystem {
+public:
+    virtual ~DisplaySystem() {}
+
+    // Monitors in system order, primary flagged; these indices are the ones
+    // GetWindowMonitor() answers with until the next call
+    virtual void GetMonitors(MonitorLayout* layout) = 0;
+
+    // The monitor nearest the window, by its restored position if minimized; -1 if unknown
+    virtual int GetWindowMonitor(WindowKey window) = 0;
+};
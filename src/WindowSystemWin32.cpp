@@ -0,0 +1,145 @@
+#include "WindowSystemWin32.h"
+#include <dwmapi.h>
+
+static HWND ToHwnd(WindowKey window) {
+    return reinterpret_cast<HWND>(window);
+}
+
+// On another virtual desktop, or a suspended store app: there, but not shown
+static bool IsWindowCloaked(HWND hwnd) {
+    DWORD cloaked = 0;
+    return SUCCEEDED(DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked != 0;
+}
+
+bool Win32WindowSystem::IsWindow(WindowKey window) {
+    return ::IsWindow(ToHwnd(window)) != FALSE;
+}
+
+uint32_t Win32WindowSystem::GetWindowState(WindowKey window, uint32_t mask) {
+    HWND hwnd = ToHwnd(window);
+    uint32_t state = 0;
+    if ((mask & WINDOW_STATE_VISIBLE) != 0 && IsWindowVisible(hwnd)) {
+        state |= WINDOW_STATE_VISIBLE;
+    }
+    if ((mask & WINDOW_STATE_MINIMIZED) != 0 && IsIconic(hwnd)) {
+        state |= WINDOW_STATE_MINIMIZED;
+    }
+    if ((mask & WINDOW_STATE_CLOAKED) != 0 && IsWindowCloaked(hwnd)) {
+        state |= WINDOW_STATE_CLOAKED;
+    }
+    return state;
+}
+
+bool Win32WindowSystem::GetWindowRect(WindowKey window, MonitorRect* rect) {
+    RECT r;
+    if (window == 0 || !::GetWindowRect(ToHwnd(window), &r)) {
+        return false;
+    }
+    rect->left = r.left;
+    rect->top = r.top;
+    rect->right = r.right;
+    rect->bottom = r.bottom;
+    return true;
+}
+
+bool Win32WindowSystem::IsToolWindow(WindowKey window) {
+    HWND hwnd = ToHwnd(window);
+    return GetWindow(hwnd, GW_OWNER) != nullptr || (GetWindowLongPtrW(hwnd, GWL_EXSTYLE) & WS_EX_TOOLWINDOW) != 0;
+}
+
+bool Win32WindowSystem::IsHung(WindowKey window) {
+    return IsHungAppWindow(ToHwnd(window)) != FALSE;
+}
+
+uint32_t Win32WindowSystem::GetWindowThread(WindowKey window, uint32_t* processId) {
+    DWORD process = 0;
+    DWORD thread = GetWindowThreadProcessId(ToHwnd(window), &process);
+    if (processId != nullptr) {
+        *processId = process;
+    }
+    return thread;
+}
+
+WindowKey Win32WindowSystem::GetForeground() {
+    return reinterpret_cast<WindowKey>(GetForegroundWindow());
+}
+
+static BOOL CALLBACK CollectWindowsProc(HWND hwnd, LPARAM lParam) {
+    reinterpret_cast<std::vector<WindowKey>*>(lParam)->push_back(reinterpret_cast<WindowKey>(hwnd));
+    return TRUE;
+}
+
+void Win32WindowSystem::EnumerateWindows(std::vector<WindowKey>* windows) {
+    windows->clear();
+    EnumWindows(CollectWindowsProc, reinterpret_cast<LPARAM>(windows));
+}
+
+size_t Win32WindowSystem::GetWindowTitle(WindowKey window, int timeoutMs, wchar_t* buffer, size_t capacity) {
+    HWND hwnd = ToHwnd(window);
+    if (capacity == 0) {
+        return 0;
+    }
+
+    // Bounded: a busy or hung owner cannot hold up the caller
+    DWORD_PTR length = 0;
+    if (timeoutMs <= 0 ||
+        !SendMessageTimeoutW(hwnd, WM_GETTEXT, capacity, reinterpret_cast<LPARAM>(buffer),
+                             SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT, static_cast<UINT>(timeoutMs), &length)) {
+        int copied = InternalGetWindowText(hwnd, buffer, static_cast<int>(capacity));
+        length = copied > 0 ? static_cast<DWORD_PTR>(copied) : 0;
+    }
+    return length < capacity ? static_cast<size_t>(length) : capacity - 1;
+}
+
+bool Win32WindowSystem::SetForeground(WindowKey window) {
+    return SetForegroundWindow(ToHwnd(window)) != FALSE;
+}
+
+bool Win32WindowSystem::AttachInput(uint32_t fromThread, uint32_t toThread, bool attach) {
+    return AttachThreadInput(fromThread, toThread, attach ? TRUE : FALSE) != FALSE;
+}
+
+void Win32WindowSystem::SetFocus(WindowKey window) {
+    ::SetFocus(ToHwnd(window));
+}
+
+void Win32WindowSystem::BringToTop(WindowKey window) {
+    BringWindowToTop(ToHwnd(window));
+}
+
+static BOOL CALLBACK CollectMonitorsProc(HMONITOR hMonitor, HDC, LPRECT, LPARAM dwData) {
+    reinterpret_cast<std::vector<HMONITOR>*>(dwData)->push_back(hMonitor);
+    return TRUE;
+}
+
+void Win32DisplaySystem::GetMonitors(MonitorLayout* layout) {
+    std::vector<HMONITOR> monitors;
+    EnumDisplayMonitors(nullptr, nullptr, CollectMonitorsProc, reinterpret_cast<LPARAM>(&monitors));
+
+    layout->Clear();
+    for (HMONITOR hMonitor : monitors) {
+        MONITORINFO info = {};
+        info.cbSize = sizeof(MONITORINFO);
+        GetMonitorInfo(hMonitor, &info);
+
+        MonitorRect bounds = { info.rcMonitor.left, info.rcMonitor.top, info.rcMonitor.right, info.rcMonitor.bottom };
+        MonitorRect workArea = { info.rcWork.left, info.rcWork.top, info.rcWork.right, info.rcWork.bottom };
+        layout->Add(bounds, workArea, (info.dwFlags & MONITORINFOF_PRIMARY) != 0);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_monitors.swap(monitors);
+}
+
+int Win32DisplaySystem::GetWindowMonitor(WindowKey window) {
+    // Windows resolves minimized windows by their restored position
+    HMONITOR hMonitor = MonitorFromWindow(ToHwnd(window), MONITOR_DEFAULTTONEAREST);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_monitors.size(); ++i) {
+        if (m_monitors[i] == hMonitor) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;  // Display configuration changed underneath us
+}
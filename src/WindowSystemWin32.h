@@ -0,0 +1,38 @@
+#pragma once
+
+#include <windows.h>
+#include <mutex>
+#include <vector>
+#include "WindowSystem.h"
+
+// Win32 backends of WindowSystem and DisplaySystem: thin wrappers over the
+// calls, no caching. Windows only.
+class Win32WindowSystem : public WindowSystem {
+public:
+    Clock::time_point Now() override { return Clock::now(); }
+
+    bool IsWindow(WindowKey window) override;
+    uint32_t GetWindowState(WindowKey window, uint32_t mask) override;
+    bool GetWindowRect(WindowKey window, MonitorRect* rect) override;
+    bool IsToolWindow(WindowKey window) override;
+    bool IsHung(WindowKey window) override;
+    uint32_t GetWindowThread(WindowKey window, uint32_t* processId) override;
+    WindowKey GetForeground() override;
+    void EnumerateWindows(std::vector<WindowKey>* windows) override;
+    size_t GetWindowTitle(WindowKey window, int timeoutMs, wchar_t* buffer, size_t capacity) override;
+
+    bool SetForeground(WindowKey window) override;
+    bool AttachInput(uint32_t fromThread, uint32_t toThread, bool attach) override;
+    void SetFocus(WindowKey window) override;
+    void BringToTop(WindowKey window) override;
+};
+
+class Win32DisplaySystem : public DisplaySystem {
+public:
+    void GetMonitors(MonitorLayout* layout) override;
+    int GetWindowMonitor(WindowKey window) override;
+
+private:
+    std::vector<HMONITOR> m_monitors;  // Same indices as the last layout handed out
+    std::mutex m_mutex;
+};
@@ -0,0 +1,87 @@
+#include "WindowTitleCache.h"
+
+WindowTitleCache::WindowTitleCache()
+    : m_useCounter(0)
+    , m_nextGeneration(1) {
+}
+
+TitleState WindowTitleCache::Lookup(WindowKey window, std::wstring* title, uint32_t* generation) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<WindowKey, Entry>::iterator it = m_entries.find(window);
+    if (it == m_entries.end()) {
+        if (m_entries.size() >= MAX_ENTRIES) {
+            EvictLeastRecentlyUsed();
+        }
+
+        // Placeholder the fetch result lands in; a rename meanwhile bumps its generation
+        Entry entry;
+        entry.valid = false;
+        entry.generation = m_nextGeneration++;
+        it = m_entries.insert(std::make_pair(window, entry)).first;
+    }
+
+    Entry& entry = it->second;
+    entry.lastUsed = ++m_useCounter;
+
+    if (!entry.valid) {
+        *generation = entry.generation;
+        return TitleState::Unknown;
+    }
+
+    if (title != nullptr) {
+        *title = entry.title;
+    }
+    return entry.title.empty() ? TitleState::Untitled : TitleState::Titled;
+}
+
+bool WindowTitleCache::Store(WindowKey window, const wchar_t* title, size_t length, uint32_t generation) {
+    if (length > MAX_TITLE_LENGTH) {
+        length = MAX_TITLE_LENGTH;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<WindowKey, Entry>::iterator it = m_entries.find(window);
+    if (it == m_entries.end() || it->second.generation != generation) {
+        return false;
+    }
+
+    it->second.title.assign(title, length);
+    it->second.valid = true;
+    return true;
+}
+
+void WindowTitleCache::Invalidate(WindowKey window) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<WindowKey, Entry>::iterator it = m_entries.find(window);
+    if (it != m_entries.end()) {
+        it->second.valid = false;
+        it->second.generation = m_nextGeneration++;
+    }
+}
+
+void WindowTitleCache::Remove(WindowKey window) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(window);
+}
+
+size_t WindowTitleCache::GetSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void WindowTitleCache::EvictLeastRecentlyUsed() {
+    // Rare (only past MAX_ENTRIES live windows), so a linear scan is fine
+    std::unordered_map<WindowKey, Entry>::iterator oldest = m_entries.begin();
+    for (std::unordered_map<WindowKey, Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->second.lastUsed < oldest->second.lastUsed) {
+            oldest = it;
+        }
+    }
+
+    if (oldest != m_entries.end()) {
+        m_entries.erase(oldest);
+    }
+}
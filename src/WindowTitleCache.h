@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "FocusStackEngine.h"
+
+enum class TitleState {
+    Unknown,   // Never fetched, or renamed since
+    Untitled,
+    Titled,
+};
+
+// Titles of windows, fetched once and kept until the window is renamed
+// (EVENT_OBJECT_NAMECHANGE) or destroyed. Thread-safe; the lock is only held
+// for the table lookup, never while a title is being fetched.
+//
+// A fetch runs between Lookup() and Store(). Lookup() hands out the entry's
+// generation and Invalidate()/Remove() change it, so a title fetched just
+// before a rename is not stored as current.
+class WindowTitleCache {
+public:
+    // Windows beyond this are forgotten, least recently used first
+    static const size_t MAX_ENTRIES = 1024;
+
+    // Longer titles are truncated
+    static const size_t MAX_TITLE_LENGTH = 255;
+
+    WindowTitleCache();
+
+    // Copies the title when known (title may be null to ask only whether
+    // there is one). When Unknown, *generation is the ticket for Store().
+    TitleState Lookup(WindowKey window, std::wstring* title, uint32_t* generation);
+
+    // False if the window was renamed, destroyed or evicted since Lookup()
+    bool Store(WindowKey window, const wchar_t* title, size_t length, uint32_t generation);
+
+    void Invalidate(WindowKey window);  // Renamed: fetch again on next use
+    void Remove(WindowKey window);      // Destroyed
+
+    size_t GetSize() const;
+
+private:
+    struct Entry {
+        std::wstring title;  // Buffer kept across renames
+        bool valid;
+        uint32_t generation;
+        uint64_t lastUsed;
+    };
+
+    std::unordered_map<WindowKey, Entry> m_entries;
+    uint64_t m_useCounter;
+    uint32_t m_nextGeneration;  // Never reused, so a removed window's ticket stays stale
+    mutable std::mutex m_mutex;
+
+    void EvictLeastRecentlyUsed();
+};
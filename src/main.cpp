@@ -1,28 +1,101 @@
 #include <windows.h>
-#include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
 #include "FocusTracker.h"
 #include "MonitorManager.h"
 #include "HotkeyManager.h"
 #include "TrayIcon.h"
+#include "ActivationPipeline.h"
+#include "ActivationStats.h"
+#include "CommandServer.h"
 #include "Config.h"
+#include "ConfigWatcher.h"
+#include "EventLoop.h"
+#include "Logger.h"
+#include "WindowSystemWin32.h"
 
-// Global flag for clean shutdown
-volatile bool g_running = true;
-
-// Global monitor manager pointer for callback access
-MonitorManager* g_monitorManager = nullptr;
+// Main thread event loop; stopping it shuts the program down
+EventLoop* g_eventLoop = nullptr;
 
 // Global tray icon
 TrayIcon* g_trayIcon = nullptr;
 
+// Global monitor manager pointer for display-change notifications
+MonitorManager* g_monitorManager = nullptr;
+
 // Main window handle
 HWND g_mainWindow = nullptr;
 
+// Hotkey-to-focus timings, dumped from the tray menu
+ActivationStats* g_activationStats = nullptr;
+
+// Directory of the executable, with trailing separator
+std::string GetExeDirectory() {
+    char exePath[MAX_PATH];
+    GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+    
+    std::string path = exePath;
+    size_t lastSlash = path.find_last_of("\\/");
+    return lastSlash != std::string::npos ? path.substr(0, lastSlash + 1) : std::string();
+}
+
+// Write the latency report next to the executable and open it
+void DumpActivationStats() {
+    if (g_activationStats == nullptr) {
+        return;
+    }
+    
+    std::string statsPath = GetExeDirectory() + "true-recall-stats.txt";
+    std::ofstream file(statsPath.c_str(), std::ios::out | std::ios::trunc);
+    if (!file) {
+        TR_LOG_ERROR("Failed to write {}", statsPath);
+        return;
+    }
+    
+    file << "True Recall hotkey-to-focus latency\n\n" << g_activationStats->FormatReport();
+    file.close();
+    
+    TR_LOG_INFO("Latency stats written to {}", statsPath);
+    ShellExecuteA(nullptr, "open", statsPath.c_str(), nullptr, nullptr, SW_SHOWNORMAL);
+}
+
+// Runs one command from the local endpoint, on the message loop thread like a hotkey
+void HandleCommand(HotkeyManager* hotkeyManager, const Command& command, CommandReply* reply) {
+    switch (command.type) {
+        case CommandType::Ping:
+            break;
+        case CommandType::Cycle:
+        case CommandType::SelectMonitor: {
+            int monitorIndex = command.type == CommandType::Cycle ? hotkeyManager->CycleMonitor()
+                                                                  : hotkeyManager->SelectMonitor(command.monitorIndex);
+            if (monitorIndex < 0) {
+                reply->ok = false;
+                reply->summary = "monitor not connected";
+            } else {
+                reply->summary = "monitor " + std::to_string(monitorIndex);
+            }
+            break;
+        }
+        case CommandType::QueryStacks: {
+            FocusState state;
+            g_monitorManager->CopyFocusState(&state);
+            reply->details = FormatFocusState(state);
+            break;
+        }
+        case CommandType::DumpStats:
+            reply->details = g_activationStats->FormatReport();
+            break;
+    }
+}
+
 // Console control handler for Ctrl+C
 BOOL WINAPI ConsoleCtrlHandler(DWORD dwCtrlType) {
     if (dwCtrlType == CTRL_C_EVENT || dwCtrlType == CTRL_CLOSE_EVENT) {
-        std::cout << "\nShutting down..." << std::endl;
-        g_running = false;
+        TR_LOG_INFO("Shutting down...");
+        if (g_eventLoop != nullptr) {
+            g_eventLoop->RequestStop();  // Safe from the handler thread
+        }
         return TRUE;
     }
     return FALSE;
@@ -30,11 +103,23 @@ BOOL WINAPI ConsoleCtrlHandler(DWORD dwCtrlType) {
 
 // Window procedure for main window (handles tray icon messages)
 LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    // Monitors added/removed/rearranged or a taskbar moved: refresh cached geometry
+    if (msg == WM_DISPLAYCHANGE || (msg == WM_SETTINGCHANGE && wParam == SPI_SETWORKAREA)) {
+        if (g_monitorManager != nullptr) {
+            g_monitorManager->EnumerateMonitors();
+            g_monitorManager->PrintMonitorInfo();
+        }
+    }
+    
+    if (msg == WM_COMMAND && LOWORD(wParam) == ID_TRAY_STATS) {
+        DumpActivationStats();
+        return 0;
+    }
+    
     // Let TrayIcon handle its messages
     LRESULT result = TrayIcon::WndProc(hwnd, msg, wParam, lParam);
     
     if (msg == WM_QUIT || msg == WM_DESTROY) {
-        g_running = false;
         PostQuitMessage(0);
         return 0;
     }
@@ -42,6 +127,25 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
     return result;
 }
 
+// Console in Debug builds, rotating log file next to the executable otherwise
+void StartLogging() {
+    #ifdef _DEBUG
+    Logger::AddSink(std::unique_ptr<LogSink>(new ConsoleLogSink()));
+    #else
+    std::string logPath = GetExeDirectory() + "true-recall.log";
+    
+    // 1 MB per file, 3 backups
+    Logger::AddSink(std::unique_ptr<LogSink>(new RotatingFileLogSink(logPath, 1024 * 1024, 3)));
+    #endif
+    
+    Logger::Start();
+}
+
+// Drains and flushes the log on every exit path from main()
+struct LoggingScope {
+    ~LoggingScope() { Logger::Stop(); }
+};
+
 bool CreateMainWindow() {
     // Register window class
     WNDCLASSEX wc = {};
@@ -53,26 +157,27 @@ bool CreateMainWindow() {
     if (!RegisterClassEx(&wc)) {
         DWORD error = GetLastError();
         if (error != ERROR_CLASS_ALREADY_EXISTS) {
-            std::cerr << "Failed to register main window class: " << error << std::endl;
+            TR_LOG_ERROR("Failed to register main window class: {}", error);
             return false;
         }
     }
     
-    // Create message-only window
+    // Create a hidden top-level window. Unlike a message-only window it
+    // receives broadcasts such as WM_DISPLAYCHANGE.
     g_mainWindow = CreateWindowEx(
-        0,
+        WS_EX_TOOLWINDOW,  // Never listed in Alt+Tab
         "TrueRecallMainWindow",
         "True Recall",
         0,
         0, 0, 0, 0,
-        HWND_MESSAGE,  // Message-only window
+        nullptr,  // Top-level, never shown
         nullptr,
         GetModuleHandle(nullptr),
         nullptr
     );
     
     if (!g_mainWindow) {
-        std::cerr << "Failed to create main window: " << GetLastError() << std::endl;
+        TR_LOG_ERROR("Failed to create main window: {}", GetLastError());
         return false;
     }
     
@@ -88,13 +193,24 @@ int main() {
     freopen_s(&fp, "CONOUT$", "w", stderr);
     #endif
 
+    StartLogging();
+    LoggingScope loggingScope;
+    
+    // Created before the console handler so a Ctrl+C always has a loop to stop
+    EventLoop eventLoop;
+    if (!eventLoop.IsValid()) {
+        TR_LOG_ERROR("Failed to create event loop");
+        return 1;
+    }
+    g_eventLoop = &eventLoop;
+
     // Set up console control handler
     if (!SetConsoleCtrlHandler(ConsoleCtrlHandler, TRUE)) {
-        std::cerr << "Failed to set console control handler" << std::endl;
+        TR_LOG_ERROR("Failed to set console control handler");
         return 1;
     }
 
-    std::cout << "True Recall started." << std::endl;
+    TR_LOG_INFO("True Recall started.");
     
     // Create main window for tray icon
     if (!CreateMainWindow()) {
@@ -104,67 +220,108 @@ int main() {
     // Load configuration
     Config config;
     if (!config.Load()) {
-        std::cerr << "Failed to load configuration" << std::endl;
+        TR_LOG_ERROR("Failed to load configuration");
         return 1;
     }
 
+    // The real desktop, behind the interfaces the focus and activation logic use
+    Win32WindowSystem windowSystem;
+    Win32DisplaySystem displaySystem;
+    std::unique_ptr<DesktopProvider> desktopProvider = CreateDesktopProvider();
+    
     // Create and enumerate monitors
-    MonitorManager monitorManager;
+    MonitorManager monitorManager(&windowSystem, &displaySystem, desktopProvider.get());
     g_monitorManager = &monitorManager;
+    monitorManager.EnableStatePublishing(FOCUS_STATE_REGION_NAME);  // For status bars and scripts; optional
     monitorManager.EnumerateMonitors();
     monitorManager.PrintMonitorInfo();
 
+    // Shared by the hotkey handler and the focus worker
+    ActivationStats activationStats;
+    g_activationStats = &activationStats;
+
+    // Activations run on their own worker; confirmed by the focus tracker
+    ActivationPipeline activationPipeline(&monitorManager, &windowSystem, &activationStats);
+    activationPipeline.EnableStrategyPersistence(GetExeDirectory() + "true-recall.strategies");  // Learned per app; optional
+    if (!activationPipeline.Start()) {
+        TR_LOG_ERROR("Failed to start activation pipeline");
+        return 1;
+    }
+
     // Create and start focus tracker
-    FocusTracker tracker(&monitorManager);
+    FocusTracker tracker(&monitorManager, &activationStats, &activationPipeline);
+    tracker.EnableSnapshots(GetExeDirectory() + "true-recall.focus");  // Warm restart; optional
+    if (config.GetRecordFocusTrace()) {
+        // Not fatal: tracking works the same without a trace
+        tracker.StartRecording(GetExeDirectory() + "true-recall.trace");
+    }
     if (!tracker.Start()) {
-        std::cerr << "Failed to start focus tracker" << std::endl;
+        TR_LOG_ERROR("Failed to start focus tracker");
         return 1;
     }
 
     // Create and register hotkeys
-    HotkeyManager hotkeyManager(&monitorManager, &config);
+    HotkeyManager hotkeyManager(&monitorManager, &config, &activationStats, &activationPipeline);
     if (!hotkeyManager.RegisterHotkeys()) {
-        std::cerr << "Failed to register hotkeys" << std::endl;
+        TR_LOG_ERROR("Failed to register hotkeys");
         return 1;
     }
     
+    // Edits to true-recall.ini are parsed on the watcher thread; hotkeys are
+    // re-registered here, since RegisterHotKey belongs to the window's thread
+    EventLoop::SignalId configSignal = eventLoop.AddSignal([&hotkeyManager]() { hotkeyManager.ReloadHotkeys(); });
+    ConfigWatcher configWatcher(&config);
+    if (!configWatcher.Start([&eventLoop, configSignal]() { eventLoop.Notify(configSignal); })) {
+        TR_LOG_WARN("Warning: Config changes will need a restart");
+        // Continue anyway, not critical
+    }
+    
+    // Local endpoint for scripts and launchers; batches run on this thread
+    CommandServer commandServer(&eventLoop);
+    std::string commandEndpoint = GetLocalChannelName(COMMAND_ENDPOINT_BASE_NAME);
+    if (commandServer.Start(commandEndpoint, [&hotkeyManager](const Command& command, CommandReply* reply) {
+            HandleCommand(&hotkeyManager, command, reply);
+        })) {
+        TR_LOG_INFO("Accepting commands on {}", commandEndpoint);
+    } else {
+        TR_LOG_WARN("Warning: Command endpoint {} unavailable (another instance running?)", commandEndpoint);
+        // Continue anyway, not critical
+    }
+    
     // Create system tray icon
     TrayIcon trayIcon;
     g_trayIcon = &trayIcon;
     if (!trayIcon.Create(g_mainWindow)) {
-        std::cerr << "Failed to create tray icon" << std::endl;
+        TR_LOG_ERROR("Failed to create tray icon");
         // Continue anyway, not critical
     }
 
-    // Win32 message loop
-    MSG msg = {};
-    while (g_running) {
-        // Use PeekMessage with timeout to allow checking g_running flag
-        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
-            if (msg.message == WM_QUIT) {
-                break;
-            }
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        } else {
-            // Sleep briefly to avoid busy-waiting
-            Sleep(10);
-        }
-    }
+    // Win32 message loop: blocks until a message or a stop request arrives
+    eventLoop.Run();
 
     // Clean shutdown
-    std::cout << "\nCleaning up..." << std::endl;
+    TR_LOG_INFO("Cleaning up...");
     
     // Destroy tray icon
     trayIcon.Destroy();
     
+    // No more reloads or commands can arrive
+    configWatcher.Stop();
+    commandServer.Stop();
+    
     // Stop focus tracker (unhooks events)
     tracker.Stop();
     
     // Unregister hotkeys
     hotkeyManager.UnregisterHotkeys();
     
-    std::cout << "True Recall terminated cleanly." << std::endl;
+    // No more requests or confirmations can arrive
+    activationPipeline.Stop();
+    
+    TR_LOG_INFO("True Recall terminated cleanly.");
+    
+    // Flush while the console still exists
+    Logger::Stop();
     
     #ifdef _DEBUG
     FreeConsole();
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "CommandProtocol.h"
+#include "LocalChannel.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// true-recall-ctl: send a batch of commands to a running True Recall and
+// print the replies. Also a reference client for launchers and scripts.
+//
+//   true-recall-ctl [--name <endpoint>] [--time] <command>...
+//
+// Every argument starts a command, except a number, which belongs to the
+// one before it: "true-recall-ctl monitor 1 stacks" is one round trip.
+
+static const int CONNECT_TIMEOUT_MS = 1000;
+static const int REPLY_TIMEOUT_MS = 5000;
+
+static void PrintUsage() {
+    std::fprintf(stderr, "usage: true-recall-ctl [--name <endpoint>] [--time] <command>...\n"
+                         "commands: ping, cycle, monitor <n>, stacks, stats\n");
+}
+
+static bool IsNumber(const char* text) {
+    if (*text == '\0') {
+        return false;
+    }
+    for (; *text != '\0'; ++text) {
+        if (*text < '0' || *text > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string name = GetLocalChannelName(COMMAND_ENDPOINT_BASE_NAME);
+    bool printTime = false;
+    std::string request;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (std::strcmp(argv[i], "--time") == 0) {
+            printTime = true;
+        } else if (IsNumber(argv[i]) && !request.empty()) {
+            request.back() = ' ';  // Argument of the previous command
+            request += argv[i];
+            request += '\n';
+        } else {
+            request += argv[i];
+            request += '\n';
+        }
+    }
+
+    if (request.empty()) {
+        PrintUsage();
+        return 1;
+    }
+    request += '\n';  // Ends the batch
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    LocalChannel channel;
+    if (!channel.Connect(name, CONNECT_TIMEOUT_MS)) {
+        std::fprintf(stderr, "%s: cannot connect (is True Recall running?)\n", name.c_str());
+        return 1;
+    }
+
+#ifdef _WIN32
+    // "cycle" and "monitor" activate windows from the server. Windows only lets it
+    // take the foreground if the process the user just used (us) hands that right on;
+    // otherwise its attempts fail and teach the strategy table the wrong lesson.
+    uint32_t serverProcessId = channel.GetPeerProcessId();
+    AllowSetForegroundWindow(serverProcessId != 0 ? static_cast<DWORD>(serverProcessId) : ASFW_ANY);
+#endif
+    if (!channel.Send(request.data(), request.size())) {
+        std::fprintf(stderr, "%s: send failed\n", name.c_str());
+        return 1;
+    }
+
+    // The reply ends at its first empty line; detail lines are indented
+    std::string reply;
+    char buffer[4096];
+    while (reply.size() < 2 || reply.compare(reply.size() - 2, 2, "\n\n") != 0) {
+        size_t received = 0;
+        if (!channel.Receive(buffer, sizeof(buffer), &received, REPLY_TIMEOUT_MS)) {
+            std::fprintf(stderr, "%s: no complete reply\n", name.c_str());
+            return 1;
+        }
+        reply.append(buffer, received);
+    }
+
+    double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    reply.pop_back();
+    std::fputs(reply.c_str(), stdout);
+    if (printTime) {
+        std::fprintf(stderr, "round trip: %.0f us\n", elapsedUs);
+    }
+
+    bool failed = reply.compare(0, 3, "err") == 0 || reply.find("\nerr") != std::string::npos;
+    return failed ? 1 : 0;
+}
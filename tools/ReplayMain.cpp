@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "TraceReader.h"
+#include "TraceReplayer.h"
+
+// true-recall-replay: replay a recorded focus trace against the focus stack
+// engine and print the resulting stacks and throughput.
+//
+//   true-recall-replay <trace> [--realtime [speed]] [--repeat N] [--quiet]
+
+static void PrintUsage() {
+    std::fprintf(stderr, "usage: true-recall-replay <trace> [--realtime [speed]] [--repeat N] [--quiet]\n");
+}
+
+static void PrintStacks(const FocusStackEngine& engine) {
+    for (int monitor = 0; monitor < engine.GetMaxMonitors(); ++monitor) {
+        if (engine.GetStackSize(monitor) == 0) {
+            continue;
+        }
+
+        std::printf("Monitor %d:", monitor);
+        engine.ForEachInStack(monitor, [](WindowKey window) {
+            std::printf(" %#llx", static_cast<unsigned long long>(window));
+        });
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return 1;
+    }
+
+    const char* path = argv[1];
+    bool realTime = false;
+    double speed = 1.0;
+    int repeat = 1;
+    bool quiet = false;
+
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--realtime") == 0) {
+            realTime = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                speed = std::atof(argv[++i]);
+            }
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (speed <= 0.0 || repeat < 1) {
+        PrintUsage();
+        return 1;
+    }
+
+    TraceReader reader;
+    if (!reader.Open(path)) {
+        std::fprintf(stderr, "%s: %s\n", path, reader.GetError());
+        return 1;
+    }
+
+    const TraceHeader& header = reader.GetHeader();
+    std::printf("%s: %llu event(s), %u monitor(s), engine %ux%u\n", path,
+                static_cast<unsigned long long>(reader.GetRecordCount()), header.monitorCount,
+                header.maxMonitors, header.perMonitorCapacity);
+
+    TraceReplayer replayer(reader);
+    ReplayResult result = {};
+    for (int i = 0; i < repeat; ++i) {
+        result = replayer.Run(realTime, speed);
+    }
+
+    double events = static_cast<double>(reader.GetRecordCount());
+    std::printf("focus %llu, destroy %llu, move %llu, skipped %llu, monitor mismatches %llu\n",
+                static_cast<unsigned long long>(result.focusEvents),
+                static_cast<unsigned long long>(result.destroyEvents),
+                static_cast<unsigned long long>(result.moveEvents),
+                static_cast<unsigned long long>(result.skippedEvents),
+                static_cast<unsigned long long>(result.monitorMismatches));
+    std::printf("replayed in %.3f ms (%.1f ns/event)\n", result.elapsedNs / 1e6,
+                events > 0.0 ? result.elapsedNs / events : 0.0);
+    std::printf("stack digest %016llx\n", static_cast<unsigned long long>(result.stackDigest));
+
+    if (!quiet) {
+        PrintStacks(replayer.GetEngine());
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "FocusState.h"
+
+// true-recall-state: print the focus state a running True Recall publishes
+// in shared memory. Also a reference reader for status bars and scripts.
+//
+//   true-recall-state [--watch [interval_ms]] [--name <region>]
+
+static void PrintUsage() {
+    std::fprintf(stderr, "usage: true-recall-state [--watch [interval_ms]] [--name <region>]\n");
+}
+
+static void PrintState(const FocusState& state) {
+    std::fputs(FormatFocusState(state).c_str(), stdout);
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    std::string name = FOCUS_STATE_REGION_NAME;
+    bool watch = false;
+    int intervalMs = 100;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--watch") == 0) {
+            watch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                intervalMs = std::atoi(argv[++i]);
+            }
+        } else if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (intervalMs < 1) {
+        PrintUsage();
+        return 1;
+    }
+
+    FocusStateReader reader;
+    FocusState state;
+    uint64_t lastSequence = 0;
+
+    for (;;) {
+        if (!reader.IsOpen() && !reader.Open(name)) {
+            if (!watch) {
+                std::fprintf(stderr, "%s: not found (is True Recall running?)\n", name.c_str());
+                return 1;
+            }
+        } else {
+            // Checking the sequence first keeps an idle poll to one load
+            uint64_t sequence = reader.GetSequence();
+            if (!watch || sequence != lastSequence) {
+                FocusStateReadResult result = reader.Read(&state, &sequence);
+                if (result == FocusStateReadResult::Ok) {
+                    PrintState(state);
+                    lastSequence = sequence;
+                } else if (result == FocusStateReadResult::WriterGone) {
+                    reader.Close();  // Look for a new writer on the next round
+                    lastSequence = 0;
+                } else if (!watch) {
+                    std::fprintf(stderr, "%s: %s\n", name.c_str(),
+                                 result == FocusStateReadResult::NotPublished ? "nothing published yet" : "busy");
+                    return 1;
+                }
+            }
+        }
+
+        if (!watch) {
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+}